@@ -0,0 +1,196 @@
+#include "bb_assets.h"
+#include "nvs_store.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+#define TAG "BB_ASSETS"
+
+#define ASSETS_KEY_PART     "assets_part"
+#define ASSETS_NBANK        2
+
+// Wpis katalogu jak we flash (BB_ASSETS_ENTRY_SIZE)
+typedef struct {
+    uint32_t offset;
+    uint32_t len;
+    uint32_t flags;
+    uint8_t hash[8];
+    char type[28];
+    char path[48];
+} assets_entry_t;
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint32_t size;
+    uint32_t crc32;
+    uint8_t reserved[12];
+} assets_hdr_t;
+
+_Static_assert(sizeof(assets_entry_t) == BB_ASSETS_ENTRY_SIZE, "assets entry layout");
+_Static_assert(sizeof(assets_hdr_t) == BB_ASSETS_HDR_SIZE, "assets header layout");
+
+static const char* const s_labels[ASSETS_NBANK] = { "storage", "storage1" };
+
+// Mapowania banków zostają do końca (oba banki mieszczą się w jednej
+// stronie MMU); przełączenie to zmiana s_bank pod s_mutex
+static const uint8_t* s_map[ASSETS_NBANK];
+static esp_partition_mmap_handle_t s_map_handle[ASSETS_NBANK];
+static int s_bank = -1;                         // -1 = brak poprawnej paczki
+static SemaphoreHandle_t s_mutex = NULL;
+
+static const esp_partition_t* find_bank(int i) {
+    return esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, s_labels[i]);
+}
+
+static int bank_index(const esp_partition_t* part) {
+    for (int i = 0; i < ASSETS_NBANK; i++) {
+        if (part && part == find_bank(i)) return i;
+    }
+    return -1;
+}
+
+static const uint8_t* map_bank(int i) {
+    if (s_map[i]) return s_map[i];
+    const esp_partition_t* part = find_bank(i);
+    const void* ptr;
+    if (!part || esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &ptr, &s_map_handle[i]) != ESP_OK) {
+        return NULL;
+    }
+    s_map[i] = ptr;
+    return s_map[i];
+}
+
+static inline const assets_hdr_t* bank_hdr(int i) {
+    return (const assets_hdr_t*)s_map[i];
+}
+
+static inline const assets_entry_t* bank_dir(int i) {
+    return (const assets_entry_t*)(s_map[i] + BB_ASSETS_HDR_SIZE);
+}
+
+// Cała paczka: nagłówek, crc32, katalog w granicach i posortowany
+static esp_err_t check_bank(int i) {
+    const esp_partition_t* part = find_bank(i);
+    const uint8_t* map = map_bank(i);
+    if (!map) return ESP_ERR_NOT_FOUND;
+    const assets_hdr_t* hdr = bank_hdr(i);
+    if (memcmp(hdr->magic, BB_ASSETS_MAGIC, 4) != 0) return ESP_ERR_INVALID_VERSION;
+    if (hdr->size < BB_ASSETS_HDR_SIZE || hdr->size > part->size || hdr->count > (hdr->size - BB_ASSETS_HDR_SIZE) / BB_ASSETS_ENTRY_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (esp_rom_crc32_le(0, map + BB_ASSETS_HDR_SIZE, hdr->size - BB_ASSETS_HDR_SIZE) != hdr->crc32) {
+        return ESP_ERR_INVALID_CRC;
+    }
+    uint32_t data_start = BB_ASSETS_HDR_SIZE + hdr->count * BB_ASSETS_ENTRY_SIZE;
+    const assets_entry_t* dir = bank_dir(i);
+    for (uint32_t k = 0; k < hdr->count; k++) {
+        const assets_entry_t* e = &dir[k];
+        if (e->offset < data_start || e->offset > hdr->size || e->len > hdr->size - e->offset) return ESP_ERR_INVALID_SIZE;
+        if (!memchr(e->path, 0, sizeof(e->path)) || !memchr(e->type, 0, sizeof(e->type))) return ESP_ERR_INVALID_SIZE;
+        if (k && strcmp(dir[k - 1].path, e->path) >= 0) return ESP_ERR_INVALID_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t bb_assets_init(void) {
+    if (!s_mutex) {
+        s_mutex = xSemaphoreCreateMutex();
+        if (!s_mutex) return ESP_ERR_NO_MEM;
+    }
+
+    // brak klucza = bank z flashowania
+    char label[17] = "";
+    int want = 0;
+    if (nvs_store_get_str(ASSETS_KEY_PART, label, sizeof(label), NULL) == ESP_OK && strcmp(label, s_labels[1]) == 0) {
+        want = 1;
+    }
+    esp_err_t err = check_bank(want);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "%s: no valid bundle (%s), trying %s", s_labels[want], esp_err_to_name(err), s_labels[!want]);
+        want = !want;
+        err = check_bank(want);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "no asset bundle: %s", esp_err_to_name(err));
+        return err;
+    }
+    s_bank = want;
+    ESP_LOGI(TAG, "%s: bundle v%u, %u assets, %u B", s_labels[want], (unsigned)bank_hdr(want)->version,
+             (unsigned)bank_hdr(want)->count, (unsigned)bank_hdr(want)->size);
+    return ESP_OK;
+}
+
+esp_err_t bb_assets_find(const char* path, bb_asset_t* out) {
+    int bank = s_bank;
+    if (bank < 0 || !path || !out) return ESP_ERR_NOT_FOUND;
+    const assets_entry_t* dir = bank_dir(bank);
+    uint32_t lo = 0, hi = bank_hdr(bank)->count;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        int c = strcmp(path, dir[mid].path);
+        if (c == 0) {
+            const assets_entry_t* e = &dir[mid];
+            out->data = s_map[bank] + e->offset;
+            out->len = e->len;
+            out->type = e->type;
+            out->gzip = (e->flags & BB_ASSETS_F_GZIP) != 0;
+            out->etag[0] = '"';
+            for (int k = 0; k < 8; k++) {
+                static const char hex[] = "0123456789abcdef";
+                out->etag[1 + 2 * k] = hex[e->hash[k] >> 4];
+                out->etag[2 + 2 * k] = hex[e->hash[k] & 0x0F];
+            }
+            out->etag[17] = '"';
+            out->etag[18] = '\0';
+            return ESP_OK;
+        }
+        if (c < 0) hi = mid;
+        else lo = mid + 1;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+const esp_partition_t* bb_assets_active(void) {
+    return find_bank(s_bank < 0 ? 0 : s_bank);
+}
+
+const esp_partition_t* bb_assets_next(void) {
+    return find_bank(s_bank < 0 ? 1 : !s_bank);
+}
+
+uint32_t bb_assets_version(void) {
+    return s_bank < 0 ? 0 : bank_hdr(s_bank)->version;
+}
+
+esp_err_t bb_assets_commit(const esp_partition_t* part, uint32_t version) {
+    int i = bank_index(part);
+    if (i < 0 || i == s_bank) return ESP_ERR_INVALID_ARG;
+    esp_err_t err = check_bank(i);
+    if (err == ESP_OK && bank_hdr(i)->version != version) err = ESP_ERR_INVALID_VERSION;
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "%s: bundle rejected: %s", part->label, esp_err_to_name(err));
+        return err;
+    }
+    err = nvs_store_set_str(ASSETS_KEY_PART, part->label);
+    if (err != ESP_OK) return err;
+
+    // od tego miejsca nowa paczka obowiązuje, także po restarcie; wysyłki
+    // ze starego banku kończą się przed przełączeniem
+    bb_assets_lock();
+    s_bank = i;
+    bb_assets_unlock();
+    ESP_LOGI(TAG, "%s: bundle v%u active", part->label, (unsigned)version);
+    return ESP_OK;
+}
+
+void bb_assets_lock(void) {
+    if (s_mutex) xSemaphoreTake(s_mutex, portMAX_DELAY);
+}
+
+void bb_assets_unlock(void) {
+    if (s_mutex) xSemaphoreGive(s_mutex);
+}
@@ -0,0 +1,235 @@
+#include "sdkconfig.h"
+
+#if CONFIG_BB_BENCH
+
+#include "bb_bench.h"
+#include "bb_json.h"
+#include "bb_jtok.h"
+#include "bb_blog.h"
+#include "esp_log.h"
+#include "esp_cpu.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TAG "BB_BENCH"
+
+#define BENCH_STACK     4096
+#define BENCH_ITER      CONFIG_BB_BENCH_ITERATIONS
+
+typedef struct {
+    const char* name;
+    size_t (*fn)(const void* arg, char* out, size_t outsize, int seq);   // zwraca długość wyniku
+    const void* arg;
+    size_t in_len;              // > 0: raportuj przepustowość wejścia
+} bench_case_t;
+
+typedef struct {
+    const bench_case_t* c;
+    TaskHandle_t parent;
+    uint32_t cycles_min;
+    uint64_t cycles_sum;
+    size_t out_len;
+    UBaseType_t stack_free;
+} bench_run_t;
+
+// ===== JSON: snprintf kontra bb_json =====
+static size_t telemetry_snprintf(const void* arg, char* out, size_t outsize, int seq) {
+    int n = snprintf(out, outsize,
+                     "{\"v\":1,\"type\":\"telemetry\",\"temp\":%.1f,\"hum\":%d,\"seq\":%d}",
+                     23.5 + (seq % 5), 40 + (seq % 10), seq);
+    return n > 0 ? (size_t)n : 0;
+}
+
+static size_t telemetry_bb_json(const void* arg, char* out, size_t outsize, int seq) {
+    bb_json_t j;
+    size_t len;
+    bb_json_begin(&j, out, outsize);
+    bb_json_obj(&j);
+    bb_json_key(&j, "v");     bb_json_int(&j, 1);
+    bb_json_key(&j, "type");  bb_json_str(&j, "telemetry");
+    bb_json_key(&j, "temp");  bb_json_dec(&j, 235 + (seq % 5) * 10, 1);
+    bb_json_key(&j, "hum");   bb_json_int(&j, 40 + (seq % 10));
+    bb_json_key(&j, "seq");   bb_json_int(&j, seq);
+    bb_json_end(&j);
+    return bb_json_finish(&j, &len) == ESP_OK ? len : 0;
+}
+
+static size_t set_led_snprintf(const void* arg, char* out, size_t outsize, int seq) {
+    int n = snprintf(out, outsize,
+                     "{\"v\":1,\"type\":\"cmd\",\"name\":\"set_led\",\"value\":%d,\"id\":\"%u\"}",
+                     seq & 1, (unsigned)(100000 + seq));
+    return n > 0 ? (size_t)n : 0;
+}
+
+static size_t set_led_bb_json(const void* arg, char* out, size_t outsize, int seq) {
+    char id[11];
+    bb_json_t j;
+    size_t len;
+    bb_json_utoa(100000 + seq, id);
+    bb_json_begin(&j, out, outsize);
+    bb_json_obj(&j);
+    bb_json_key(&j, "v");      bb_json_int(&j, 1);
+    bb_json_key(&j, "type");   bb_json_str(&j, "cmd");
+    bb_json_key(&j, "name");   bb_json_str(&j, "set_led");
+    bb_json_key(&j, "value");  bb_json_int(&j, seq & 1);
+    bb_json_key(&j, "id");     bb_json_str(&j, id);
+    bb_json_end(&j);
+    return bb_json_finish(&j, &len) == ESP_OK ? len : 0;
+}
+
+static const bench_case_t s_json_cases[] = {
+    { "telemetry snprintf", telemetry_snprintf },
+    { "telemetry bb_json",  telemetry_bb_json },
+    { "set_led snprintf",   set_led_snprintf },
+    { "set_led bb_json",    set_led_bb_json },
+};
+
+// ===== bb_jtok: tokenizacja wiadomości 100 B .. 4 KB =====
+#define JTOK_MAX_MSG    4096
+#define JTOK_MAX_TOKENS 1024
+
+static char s_jtok_msg[4][JTOK_MAX_MSG + 1];
+static bb_jtok_t s_jtok_tok[JTOK_MAX_TOKENS];     // statycznie, jak w routerze RX
+
+// Typowa wiadomość serwera z tablicą `items` rekordów
+static size_t jtok_build_msg(char* out, int items) {
+    bb_json_t j;
+    size_t len;
+    bb_json_begin(&j, out, JTOK_MAX_MSG + 1);
+    bb_json_obj(&j);
+    bb_json_key(&j, "v");     bb_json_int(&j, 1);
+    bb_json_key(&j, "type");  bb_json_str(&j, "cmd");
+    bb_json_key(&j, "id");    bb_json_str(&j, "42");
+    bb_json_key(&j, "name");  bb_json_str(&j, "set_led");
+    bb_json_key(&j, "data");
+    bb_json_arr(&j);
+    for (int k = 0; k < items; k++) {
+        char key[11];
+        bb_json_utoa(k, key);
+        bb_json_obj(&j);
+        bb_json_key(&j, "k");   bb_json_str(&j, key);
+        bb_json_key(&j, "x");   bb_json_int(&j, -k * 37);
+        bb_json_key(&j, "ok");  bb_json_bool(&j, k & 1);
+        bb_json_end(&j);
+    }
+    bb_json_end(&j);
+    bb_json_end(&j);
+    return bb_json_finish(&j, &len) == ESP_OK ? len : 0;
+}
+
+// Największa wiadomość nie dłuższa niż target
+static size_t jtok_make_msg(char* out, size_t target) {
+    int items = 0;
+    while (jtok_build_msg(out, items + 1) - 1 < target) items++;    // 0 (overflow) - 1 -> SIZE_MAX
+    return jtok_build_msg(out, items);
+}
+
+static size_t jtok_parse_case(const void* arg, char* out, size_t outsize, int seq) {
+    const char* msg = arg;
+    int n = bb_jtok_parse(msg, strlen(msg), s_jtok_tok, JTOK_MAX_TOKENS);
+    // to samo, co robi router RX po parsowaniu
+    int t = bb_jtok_obj_get(msg, s_jtok_tok, n, 0, "type");
+    int id = bb_jtok_obj_get(msg, s_jtok_tok, n, 0, "id");
+    return (n > 0 && t > 0 && id > 0) ? (size_t)n : 0;
+}
+
+static bench_case_t s_jtok_cases[] = {
+    { "jtok 100 B",  jtok_parse_case, s_jtok_msg[0], 100 },
+    { "jtok 512 B",  jtok_parse_case, s_jtok_msg[1], 512 },
+    { "jtok 1 KB",   jtok_parse_case, s_jtok_msg[2], 1024 },
+    { "jtok 4 KB",   jtok_parse_case, s_jtok_msg[3], 4096 },
+};
+
+// ===== LOG: formatowanie printf kontra rekord bb_blog =====
+// Koszt w miejscu wywołania dla linii jak "WS RX" w ws_comm (bez UART).
+// Te same przypadki na hoście: tools/host_test, make bench (x86, glibc -
+// nie C3). Liczby dla ESP32-C3 daje tylko ta grupa na urządzeniu
+// (CONFIG_BB_BENCH); w repo ich jeszcze nie ma
+static const char s_log_msg[] = "{\"v\":1,\"type\":\"cmd\",\"id\":\"42\",\"name\":\"set_led\",\"args\":{\"on\":1}}";
+
+static size_t log_snprintf(const void* arg, char* out, size_t outsize, int seq) {
+    int n = snprintf(out, outsize, "I (%u) %s: WS RX %u B: %s\n",
+                     (unsigned)seq, "WS_COMM", (unsigned)(sizeof(s_log_msg) - 1), s_log_msg);
+    return (n > 0 && (size_t)n < outsize) ? (size_t)n : 0;
+}
+
+static size_t log_bb_blog(const void* arg, char* out, size_t outsize, int seq) {
+    BB_BLOG_DESC(desc, ESP_LOG_INFO, "WS_COMM", "WS RX %u B: %s");
+    return bb_blog_encode((uint8_t*)out, outsize, &desc, 2, BB_BLOG_TYPES((unsigned)0, s_log_msg),
+                          (unsigned)(sizeof(s_log_msg) - 1), s_log_msg);
+}
+
+static const bench_case_t s_log_cases[] = {
+    { "log snprintf",       log_snprintf },
+    { "log bb_blog",        log_bb_blog },
+};
+
+// ===== WSPÓLNY PRZEBIEG =====
+// Każdy wariant w świeżym tasku, żeby high water mark stosu dotyczył tylko jego
+static void bench_task(void* pv) {
+    bench_run_t* r = pv;
+    char out[256];
+
+    r->cycles_min = UINT32_MAX;
+    for (int i = 0; i < BENCH_ITER; i++) {
+        uint32_t t0 = esp_cpu_get_cycle_count();
+        r->out_len = r->c->fn(r->c->arg, out, sizeof(out), i);
+        uint32_t dt = esp_cpu_get_cycle_count() - t0;
+        r->cycles_sum += dt;
+        if (dt < r->cycles_min) r->cycles_min = dt;
+    }
+    r->stack_free = uxTaskGetStackHighWaterMark(NULL);
+    xTaskNotifyGive(r->parent);
+    vTaskDelete(NULL);
+}
+
+static void bench_cases(const char* group, const bench_case_t* cases, size_t n) {
+    ESP_LOGI(TAG, "[%s] %d iterations, stack %d B per task", group, BENCH_ITER, BENCH_STACK);
+    for (size_t i = 0; i < n; i++) {
+        bench_run_t r = { .c = &cases[i], .parent = xTaskGetCurrentTaskHandle() };
+        if (xTaskCreate(bench_task, "bench", BENCH_STACK, &r, uxTaskPriorityGet(NULL), NULL) != pdPASS) {
+            ESP_LOGE(TAG, "%s: task create failed", cases[i].name);
+            continue;
+        }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        uint32_t avg = (uint32_t)(r.cycles_sum / BENCH_ITER);
+        ESP_LOGI(TAG, "  %-20s avg %6u cyc  min %6u cyc  stack %4u B  out %u",
+                 cases[i].name, (unsigned)avg, (unsigned)r.cycles_min,
+                 (unsigned)(BENCH_STACK - r.stack_free), (unsigned)r.out_len);
+        if (cases[i].in_len && avg) {
+            // bajty/cykl * MHz = MB/s
+            ESP_LOGI(TAG, "  %-20s %u B in, %u kB/s", "", (unsigned)cases[i].in_len,
+                     (unsigned)((uint64_t)cases[i].in_len * CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ * 1000000 / avg / 1024));
+        }
+    }
+}
+
+// Obie implementacje muszą dawać identyczny tekst
+static void json_check(void) {
+    char a[256], b[256];
+    for (size_t i = 0; i + 1 < sizeof(s_json_cases) / sizeof(s_json_cases[0]); i += 2) {
+        for (int seq = 0; seq < 20; seq++) {
+            size_t la = s_json_cases[i].fn(NULL, a, sizeof(a), seq);
+            size_t lb = s_json_cases[i + 1].fn(NULL, b, sizeof(b), seq);
+            if (la != lb || memcmp(a, b, la) != 0) {
+                ESP_LOGE(TAG, "output mismatch seq=%d:\n  %s\n  %s", seq, a, b);
+                return;
+            }
+        }
+    }
+}
+
+void bb_bench_run(void) {
+    json_check();
+    bench_cases("json", s_json_cases, sizeof(s_json_cases) / sizeof(s_json_cases[0]));
+
+    for (size_t i = 0; i < sizeof(s_jtok_cases) / sizeof(s_jtok_cases[0]); i++) {
+        s_jtok_cases[i].in_len = jtok_make_msg(s_jtok_msg[i], s_jtok_cases[i].in_len);
+    }
+    bench_cases("jtok (out = tokens)", s_jtok_cases, sizeof(s_jtok_cases) / sizeof(s_jtok_cases[0]));
+    bench_cases("log (out = bytes)", s_log_cases, sizeof(s_log_cases) / sizeof(s_log_cases[0]));
+}
+
+#endif // CONFIG_BB_BENCH
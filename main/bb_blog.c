@@ -0,0 +1,416 @@
+#include "bb_blog.h"
+#include "bbapi.h"
+#include "bb_json.h"
+#include "ws_comm.h"
+#include "esp_app_desc.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define BLOG_RING_SIZE      CONFIG_BB_BLOG_RING_SIZE
+#define BLOG_HDR            12      // [u8 len][u8 argc][u16 types][u32 desc][u32 ts_ms]
+#define BLOG_IDLE_MS        50
+#define BLOG_HEX_MAX        400     // tekst hex w jednej wiadomości trybu host
+#define BLOG_LINE_MAX       160
+
+// Rekordy w ringu mogą przechodzić przez koniec bufora. Wielu producentów -
+// krótka sekcja krytyczna; pełny ring odrzuca nowy rekord.
+static uint8_t s_ring[BLOG_RING_SIZE];
+static uint32_t s_head = 0;
+static uint32_t s_tail = 0;
+static uint32_t s_used = 0;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static bb_blog_stats_t s_st;                    // pod s_lock
+
+volatile uint8_t bb_blog_level = CONFIG_LOG_DEFAULT_LEVEL;
+static volatile uint8_t s_mode = BB_BLOG_MODE_TEXT;
+static TaskHandle_t s_task = NULL;
+static volatile bool s_run = false;
+static char s_elf_id[17];                       // początek SHA256 pliku ELF, dla dekodera
+static char s_hex[BLOG_HEX_MAX + 1];            // tylko task formatujący
+
+// ===== ZAPIS (miejsce wywołania) =====
+static size_t blog_vencode(uint8_t* out, size_t outsize, const bb_blog_desc_t* d, uint8_t argc, uint16_t types, va_list ap) {
+    if (argc > BB_BLOG_MAX_ARGS || outsize < BLOG_HDR) return 0;
+    size_t n = BLOG_HDR;
+    for (uint8_t i = 0; i < argc; i++) {
+        switch ((types >> (2 * i)) & 3) {
+            case BB_BLOG_T_U32: {
+                uint32_t v = va_arg(ap, uint32_t);
+                if (n + 4 > outsize) return 0;
+                memcpy(out + n, &v, 4);
+                n += 4;
+                break;
+            }
+            case BB_BLOG_T_U64: {
+                uint64_t v = va_arg(ap, uint64_t);
+                if (n + 8 > outsize) return 0;
+                memcpy(out + n, &v, 8);
+                n += 8;
+                break;
+            }
+            case BB_BLOG_T_DBL: {
+                double v = va_arg(ap, double);
+                if (n + 8 > outsize) return 0;
+                memcpy(out + n, &v, 8);
+                n += 8;
+                break;
+            }
+            default: {
+                const char* s = va_arg(ap, const char*);
+                if (!s) s = "(null)";
+                size_t len = strnlen(s, BB_BLOG_STR_MAX);
+                if (n + 1 + len > outsize) len = outsize > n + 1 ? outsize - n - 1 : 0;
+                if (n + 1 > outsize) return 0;
+                out[n++] = (uint8_t)len;
+                memcpy(out + n, s, len);
+                n += len;
+                break;
+            }
+        }
+    }
+    // adres deskryptora jako id formatu - rdzeń ilp32, dekoder czyta 4 B
+    uint32_t id = (uint32_t)(uintptr_t)d;
+    uint32_t ts = esp_log_timestamp();
+    out[0] = (uint8_t)n;
+    out[1] = argc;
+    memcpy(out + 2, &types, 2);
+    memcpy(out + 4, &id, 4);
+    memcpy(out + 8, &ts, 4);
+    return n;
+}
+
+size_t bb_blog_encode(uint8_t* out, size_t outsize, const bb_blog_desc_t* d, uint8_t argc, uint16_t types, ...) {
+    va_list ap;
+    va_start(ap, types);
+    size_t n = blog_vencode(out, outsize, d, argc, types, ap);
+    va_end(ap);
+    return n;
+}
+
+static void ring_put(uint32_t off, const void* src, uint32_t n) {
+    uint32_t first = BLOG_RING_SIZE - off;
+    if (first > n) first = n;
+    memcpy(s_ring + off, src, first);
+    memcpy(s_ring, (const uint8_t*)src + first, n - first);
+}
+
+static void ring_get(uint32_t off, void* dst, uint32_t n) {
+    uint32_t first = BLOG_RING_SIZE - off;
+    if (first > n) first = n;
+    memcpy(dst, s_ring + off, first);
+    memcpy((uint8_t*)dst + first, s_ring, n - first);
+}
+
+void bb_blog_write(const bb_blog_desc_t* d, uint8_t argc, uint16_t types, ...) {
+    uint8_t rec[BB_BLOG_REC_MAX];
+    va_list ap;
+    va_start(ap, types);
+    size_t n = blog_vencode(rec, sizeof(rec), d, argc, types, ap);
+    va_end(ap);
+    if (n == 0) return;
+
+    portENTER_CRITICAL_SAFE(&s_lock);
+    if (BLOG_RING_SIZE - s_used < n) {
+        s_st.dropped++;
+    } else {
+        ring_put(s_head, rec, (uint32_t)n);
+        s_head = (s_head + n) % BLOG_RING_SIZE;
+        s_used += n;
+        s_st.written++;
+    }
+    portEXIT_CRITICAL_SAFE(&s_lock);
+}
+
+// Zdejmuje najstarszy rekord; peek = bez zdejmowania
+static size_t ring_take(uint8_t* rec, bool peek) {
+    size_t n = 0;
+    portENTER_CRITICAL(&s_lock);
+    if (s_used) {
+        ring_get(s_tail, rec, 1);
+        n = rec[0];
+        ring_get(s_tail, rec, n);
+        if (!peek) {
+            s_tail = (s_tail + n) % BLOG_RING_SIZE;
+            s_used -= n;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return n;
+}
+
+// ===== FORMATOWANIE NA URZĄDZENIU =====
+typedef struct {
+    uint8_t type;
+    uint8_t len;                    // STR
+    union {
+        uint32_t u32;
+        uint64_t u64;
+        double dbl;
+        const char* s;
+    };
+} blog_arg_t;
+
+static int parse_args(const uint8_t* rec, size_t n, blog_arg_t* args) {
+    uint8_t argc = rec[1];
+    uint16_t types;
+    memcpy(&types, rec + 2, 2);
+    size_t off = BLOG_HDR;
+    for (uint8_t i = 0; i < argc && i < BB_BLOG_MAX_ARGS; i++) {
+        blog_arg_t* a = &args[i];
+        a->type = (types >> (2 * i)) & 3;
+        size_t need = (a->type == BB_BLOG_T_U32) ? 4 : (a->type == BB_BLOG_T_STR) ? 1 : 8;
+        if (off + need > n) return i;
+        if (a->type == BB_BLOG_T_U32) memcpy(&a->u32, rec + off, 4);
+        else if (a->type == BB_BLOG_T_U64) memcpy(&a->u64, rec + off, 8);
+        else if (a->type == BB_BLOG_T_DBL) memcpy(&a->dbl, rec + off, 8);
+        else {
+            a->len = rec[off];
+            need += a->len;
+            if (off + need > n) return i;
+            a->s = (const char*)rec + off + 1;
+        }
+        off += need;
+    }
+    return argc;
+}
+
+// Jedna konwersja printf z argumentem z rekordu. spec bez modyfikatorów długości.
+static int format_one(char* out, size_t outsize, char* spec, size_t sl, char conv, const blog_arg_t* a) {
+    if (conv == 's') {
+        if (a->type != BB_BLOG_T_STR) return snprintf(out, outsize, "<?>");
+        char s[BB_BLOG_STR_MAX + 1];
+        memcpy(s, a->s, a->len);
+        s[a->len] = '\0';
+        spec[sl++] = 's';
+        spec[sl] = '\0';
+        return snprintf(out, outsize, spec, s);
+    }
+    if (strchr("fFeEgGaA", conv)) {
+        if (a->type != BB_BLOG_T_DBL) return snprintf(out, outsize, "<?>");
+        spec[sl++] = conv;
+        spec[sl] = '\0';
+        return snprintf(out, outsize, spec, a->dbl);
+    }
+    if (conv == 'p') {
+        return snprintf(out, outsize, "0x%08" PRIx32, a->u32);
+    }
+    if (a->type == BB_BLOG_T_U64) {
+        spec[sl++] = 'l';
+        spec[sl++] = 'l';
+        spec[sl++] = conv;
+        spec[sl] = '\0';
+        return snprintf(out, outsize, spec, (long long)a->u64);
+    }
+    if (a->type != BB_BLOG_T_U32) return snprintf(out, outsize, "<?>");
+    spec[sl++] = conv;
+    spec[sl] = '\0';
+    return snprintf(out, outsize, spec, (int)a->u32);
+}
+
+static size_t blog_format(const bb_blog_desc_t* d, const uint8_t* rec, size_t n, char* out, size_t outsize) {
+    blog_arg_t args[BB_BLOG_MAX_ARGS];
+    int argc = parse_args(rec, n, args);
+    int ai = 0;
+    size_t o = 0;
+
+    for (const char* f = d->fmt; *f && o + 1 < outsize; f++) {
+        if (*f != '%') {
+            out[o++] = *f;
+            continue;
+        }
+        if (f[1] == '%') {
+            out[o++] = '%';
+            f++;
+            continue;
+        }
+        // %[flagi][szerokość|*][.precyzja|.*][długość]konwersja
+        char spec[24];
+        size_t sl = 0;
+        spec[sl++] = '%';
+        f++;
+        while (*f && strchr("-+ #0", *f) && sl < 8) spec[sl++] = *f++;
+        for (int part = 0; part < 2; part++) {
+            if (part == 1) {
+                if (*f != '.') break;
+                spec[sl++] = *f++;
+            }
+            if (*f == '*') {
+                int v = (ai < argc && args[ai].type == BB_BLOG_T_U32) ? (int)args[ai].u32 : 0;
+                ai++;
+                sl += (size_t)snprintf(spec + sl, sizeof(spec) - sl - 4, "%d", v);
+                f++;
+            }
+            while (*f >= '0' && *f <= '9' && sl < sizeof(spec) - 6) spec[sl++] = *f++;
+        }
+        while (*f && strchr("hlLqjzt", *f)) f++;
+        if (!*f) break;
+        if (ai >= argc) {
+            o += (size_t)snprintf(out + o, outsize - o, "<?>");
+        } else {
+            int w = format_one(out + o, outsize - o, spec, sl, *f, &args[ai++]);
+            if (w > 0) o += (size_t)w;
+        }
+        if (o >= outsize) o = outsize - 1;
+    }
+    out[o] = '\0';
+    return o;
+}
+
+static void emit_text(const uint8_t* rec, size_t n) {
+    uint32_t id, ts;
+    memcpy(&id, rec + 4, 4);
+    memcpy(&ts, rec + 8, 4);
+    const bb_blog_desc_t* d = (const bb_blog_desc_t*)(uintptr_t)id;
+
+    char line[BLOG_LINE_MAX];
+    blog_format(d, rec, n, line, sizeof(line));
+    // ten sam układ co ESP_LOGx, z czasem z miejsca wywołania
+    static const char letters[] = "NEWIDV";
+    esp_log_write((esp_log_level_t)d->level, d->tag, "%c (%" PRIu32 ") %s: %s\n",
+                  letters[d->level <= ESP_LOG_VERBOSE ? d->level : 0], ts, d->tag, line);
+
+    portENTER_CRITICAL(&s_lock);
+    s_st.formatted++;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// ===== TRYB HOST =====
+// {"v":1,"type":"blog","elf":"<sha256[0:8]>","d":"<rekordy hex>"}
+static bool send_host_batch(void) {
+    static const char hex[] = "0123456789abcdef";
+    uint8_t rec[BB_BLOG_REC_MAX];
+    if (ring_take(rec, true) == 0) return false;
+
+    ws_tx_slot_t slot;
+    if (ws_comm_tx_reserve_low(&slot) != ESP_OK) {
+        // brak slotu klasy niskiej - rekord idzie na UART zamiast czekać
+        size_t n = ring_take(rec, false);
+        if (n) emit_text(rec, n);
+        return false;
+    }
+
+    size_t hl = 0;
+    uint32_t count = 0;
+    for (;;) {
+        size_t n = ring_take(rec, true);
+        if (n == 0 || hl + 2 * n > BLOG_HEX_MAX) break;
+        ring_take(rec, false);
+        for (size_t i = 0; i < n; i++) {
+            s_hex[hl++] = hex[rec[i] >> 4];
+            s_hex[hl++] = hex[rec[i] & 15];
+        }
+        count++;
+    }
+
+    bb_json_t j;
+    size_t len;
+    bb_json_begin(&j, slot.buf, slot.cap);
+    bb_json_obj(&j);
+    bb_json_key(&j, "v");       bb_json_int(&j, 1);
+    bb_json_key(&j, "type");    bb_json_str(&j, "blog");
+    bb_json_key(&j, "elf");     bb_json_str(&j, s_elf_id);
+    bb_json_key(&j, "d");       bb_json_strn(&j, s_hex, hl);
+    bb_json_end(&j);
+    if (bb_json_finish(&j, &len) != ESP_OK) {
+        ws_comm_tx_cancel(&slot);
+        return false;
+    }
+    ws_comm_tx_commit(&slot, len);
+    portENTER_CRITICAL(&s_lock);
+    s_st.sent += count;
+    portEXIT_CRITICAL(&s_lock);
+    return true;
+}
+
+static void blog_task(void* pv) {
+    uint8_t rec[BB_BLOG_REC_MAX];
+    while (s_run) {
+        if (s_mode == BB_BLOG_MODE_HOST && ws_comm_is_connected()) {
+            if (!send_host_batch()) vTaskDelay(pdMS_TO_TICKS(BLOG_IDLE_MS));
+            continue;
+        }
+        // tryb tekstowy albo host bez połączenia
+        size_t n = ring_take(rec, false);
+        if (n == 0) {
+            vTaskDelay(pdMS_TO_TICKS(BLOG_IDLE_MS));
+            continue;
+        }
+        emit_text(rec, n);
+    }
+    s_task = NULL;
+    vTaskDelete(NULL);
+}
+
+// ===== STEROWANIE =====
+void bb_blog_set_mode(bb_blog_mode_t mode) {
+    s_mode = mode;
+}
+
+void bb_blog_get_stats(bb_blog_stats_t* out) {
+    if (!out) return;
+    portENTER_CRITICAL(&s_lock);
+    *out = s_st;
+    out->ring_used = s_used;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// {"mode":"text"|"host","level":"E|W|I|D|V"}
+enum { ARG_MODE, ARG_LEVEL };
+
+static const bbapi_arg_t s_blog_cfg_args[] = {
+    [ARG_MODE]  = { .name = "mode",  .type = BBAPI_ARG_STR, .max = 4 },
+    [ARG_LEVEL] = { .name = "level", .type = BBAPI_ARG_STR, .max = 1 },
+    { 0 }
+};
+
+static esp_err_t cmd_blog_cfg(const bbapi_cmd_t* cmd, bb_json_t* result, void* ctx) {
+    static const char letters[] = "NEWIDV";
+    if (cmd->present & (1u << ARG_MODE)) {
+        const char* m = cmd->args[ARG_MODE].s;
+        if (strcmp(m, "text") == 0) bb_blog_set_mode(BB_BLOG_MODE_TEXT);
+        else if (strcmp(m, "host") == 0) bb_blog_set_mode(BB_BLOG_MODE_HOST);
+        else return ESP_ERR_INVALID_ARG;
+    }
+    if (cmd->present & (1u << ARG_LEVEL)) {
+        const char* p = cmd->args[ARG_LEVEL].s[0] ? strchr(letters, cmd->args[ARG_LEVEL].s[0]) : NULL;
+        if (!p) return ESP_ERR_INVALID_ARG;
+        bb_blog_level = (uint8_t)(p - letters);
+    }
+
+    bb_blog_stats_t st;
+    bb_blog_get_stats(&st);
+    bb_json_key(result, "mode");        bb_json_str(result, s_mode == BB_BLOG_MODE_HOST ? "host" : "text");
+    bb_json_key(result, "level");       bb_json_strn(result, &letters[bb_blog_level <= ESP_LOG_VERBOSE ? bb_blog_level : 0], 1);
+    bb_json_key(result, "elf");         bb_json_str(result, s_elf_id);
+    bb_json_key(result, "written");     bb_json_uint(result, st.written);
+    bb_json_key(result, "dropped");     bb_json_uint(result, st.dropped);
+    bb_json_key(result, "formatted");   bb_json_uint(result, st.formatted);
+    bb_json_key(result, "sent");        bb_json_uint(result, st.sent);
+    bb_json_key(result, "ring");        bb_json_uint(result, st.ring_used);
+    return ESP_OK;
+}
+
+esp_err_t bb_blog_start(void) {
+    if (s_task) return ESP_OK;
+    esp_app_get_elf_sha256(s_elf_id, sizeof(s_elf_id));
+    esp_err_t err = BBAPI_register_cmd("blog_cfg", cmd_blog_cfg, s_blog_cfg_args, NULL);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return err;
+
+    s_run = true;
+    if (xTaskCreate(blog_task, "bb_blog", 3072, NULL, 1, &s_task) != pdPASS) {
+        s_run = false;
+        s_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void bb_blog_stop(void) {
+    s_run = false;
+    for (int i = 0; i < 50 && s_task; ++i) vTaskDelay(pdMS_TO_TICKS(20));
+}
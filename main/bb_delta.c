@@ -0,0 +1,206 @@
+#include "bb_delta.h"
+#include "esp_log.h"
+#include "mbedtls/sha256.h"
+#include <string.h>
+
+#define TAG "BB_DELTA"
+
+enum { OP_COPY, OP_ADD, OP_DATA, OP_SEEK, OP_END };
+
+typedef enum {
+    ST_HDR,
+    ST_OP,
+    ST_LEN,         // varint argumentu operacji
+    ST_ADD,         // s_left bajtów różnic
+    ST_DATA,        // s_left bajtów literalnych
+    ST_END,
+    ST_FAIL,
+} delta_state_t;
+
+// Jedna sesja naraz - wywołania z taska zapisu bb_ota
+static const esp_partition_t* s_base;
+static bb_delta_out_t s_out;
+static delta_state_t s_st = ST_FAIL;
+static uint8_t s_hdr[BB_DELTA_HDR_SIZE];
+static uint8_t s_hdr_len;
+static uint8_t s_op;
+static uint32_t s_arg;
+static uint8_t s_shift;
+static uint32_t s_left;
+static uint32_t s_pos;                  // pozycja w starym obrazie
+static uint32_t s_old_size;
+static uint32_t s_new_size;
+static uint32_t s_produced;
+static uint8_t s_buf[BB_DELTA_BUF_SIZE];
+
+static inline uint32_t rd32(const uint8_t* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+// ===== STARY OBRAZ =====
+static esp_err_t check_base(void) {
+    if (memcmp(s_hdr, BB_DELTA_MAGIC, 4) != 0) return ESP_ERR_INVALID_VERSION;
+    s_old_size = rd32(s_hdr + 4);
+    if (rd32(s_hdr + 8) != s_new_size) return ESP_ERR_INVALID_SIZE;
+    if (s_old_size > s_base->size) return ESP_ERR_INVALID_SIZE;
+
+    mbedtls_sha256_context sha;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+    esp_err_t err = ESP_OK;
+    for (uint32_t pos = 0; pos < s_old_size && err == ESP_OK; pos += sizeof(s_buf)) {
+        uint32_t n = s_old_size - pos < sizeof(s_buf) ? s_old_size - pos : sizeof(s_buf);
+        err = esp_partition_read(s_base, pos, s_buf, n);
+        if (err == ESP_OK) mbedtls_sha256_update(&sha, s_buf, n);
+    }
+    uint8_t digest[32];
+    mbedtls_sha256_finish(&sha, digest);
+    mbedtls_sha256_free(&sha);
+    if (err != ESP_OK) return err;
+    if (memcmp(digest, s_hdr + 12, sizeof(digest)) != 0) {
+        ESP_LOGW(TAG, "patch base differs from %s", s_base->label);
+        return ESP_ERR_INVALID_CRC;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t emit(const uint8_t* data, size_t len) {
+    if (len > s_new_size - s_produced) return ESP_ERR_INVALID_SIZE;
+    s_produced += len;
+    return s_out(data, len);
+}
+
+// n bajtów starego obrazu od s_pos do s_buf, n <= BB_DELTA_BUF_SIZE
+static esp_err_t read_old(uint32_t n) {
+    if (s_pos > s_old_size || n > s_old_size - s_pos) return ESP_ERR_INVALID_SIZE;
+    esp_err_t err = esp_partition_read(s_base, s_pos, s_buf, n);
+    s_pos += n;
+    return err;
+}
+
+static esp_err_t copy_old(uint32_t n) {
+    while (n) {
+        uint32_t k = n < sizeof(s_buf) ? n : sizeof(s_buf);
+        esp_err_t err = read_old(k);
+        if (err == ESP_OK) err = emit(s_buf, k);
+        if (err != ESP_OK) return err;
+        n -= k;
+    }
+    return ESP_OK;
+}
+
+// Koniec varinta: wykonanie albo przejście do danych operacji
+static esp_err_t op_ready(void) {
+    switch (s_op) {
+    case OP_COPY:
+        s_st = ST_OP;
+        return copy_old(s_arg);
+    case OP_ADD:
+    case OP_DATA:
+        s_left = s_arg;
+        s_st = s_arg == 0 ? ST_OP : (s_op == OP_ADD ? ST_ADD : ST_DATA);
+        return ESP_OK;
+    case OP_SEEK: {
+        int32_t d = (int32_t)(s_arg >> 1) ^ -(int32_t)(s_arg & 1);
+        s_pos += (uint32_t)d;           // zakres sprawdza read_old
+        s_st = ST_OP;
+        return ESP_OK;
+    }
+    default:
+        return ESP_ERR_INVALID_SIZE;
+    }
+}
+
+// ===== API =====
+esp_err_t bb_delta_begin(const esp_partition_t* base, uint32_t new_size, bb_delta_out_t out) {
+    if (!base || !out) return ESP_ERR_INVALID_ARG;
+    s_base = base;
+    s_out = out;
+    s_new_size = new_size;
+    s_produced = 0;
+    s_pos = 0;
+    s_hdr_len = 0;
+    s_st = ST_HDR;
+    return ESP_OK;
+}
+
+esp_err_t bb_delta_feed(const uint8_t* data, size_t len) {
+    esp_err_t err = ESP_OK;
+    while (len && err == ESP_OK) {
+        switch (s_st) {
+        case ST_HDR: {
+            size_t n = sizeof(s_hdr) - s_hdr_len;
+            if (n > len) n = len;
+            memcpy(s_hdr + s_hdr_len, data, n);
+            s_hdr_len += n;
+            data += n;
+            len -= n;
+            if (s_hdr_len == sizeof(s_hdr)) {
+                err = check_base();
+                s_st = ST_OP;
+            }
+            break;
+        }
+        case ST_OP:
+            s_op = *data++;
+            len--;
+            if (s_op == OP_END) {
+                s_st = ST_END;
+            } else if (s_op > OP_END) {
+                err = ESP_ERR_INVALID_SIZE;
+            } else {
+                s_arg = 0;
+                s_shift = 0;
+                s_st = ST_LEN;
+            }
+            break;
+        case ST_LEN: {
+            uint8_t b = *data++;
+            len--;
+            if (s_shift > 28 || (s_shift == 28 && (b & 0x70))) {     // więcej niż 32 bity
+                err = ESP_ERR_INVALID_SIZE;
+                break;
+            }
+            s_arg |= (uint32_t)(b & 0x7F) << s_shift;
+            s_shift += 7;
+            if (!(b & 0x80)) err = op_ready();
+            break;
+        }
+        case ST_ADD: {
+            uint32_t n = s_left < sizeof(s_buf) ? s_left : sizeof(s_buf);
+            if (n > len) n = len;
+            err = read_old(n);
+            if (err != ESP_OK) break;
+            for (uint32_t i = 0; i < n; i++) s_buf[i] += data[i];
+            err = emit(s_buf, n);
+            data += n;
+            len -= n;
+            s_left -= n;
+            if (s_left == 0) s_st = ST_OP;
+            break;
+        }
+        case ST_DATA: {
+            uint32_t n = s_left < len ? s_left : (uint32_t)len;
+            err = emit(data, n);            // prosto z bufora wejścia
+            data += n;
+            len -= n;
+            s_left -= n;
+            if (s_left == 0) s_st = ST_OP;
+            break;
+        }
+        case ST_END:                        // dane po END
+        case ST_FAIL:
+            err = ESP_ERR_INVALID_SIZE;
+            break;
+        }
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "patch failed at %u B out: %s", (unsigned)s_produced, esp_err_to_name(err));
+        s_st = ST_FAIL;
+    }
+    return err;
+}
+
+bool bb_delta_done(void) {
+    return s_st == ST_END && s_produced == s_new_size;
+}
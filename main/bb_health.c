@@ -0,0 +1,198 @@
+#include "bb_health.h"
+#include "bbapi.h"
+#include "ws_comm.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+
+#define TAG "BB_HEALTH"
+
+#define HEALTH_TICK_MS      1000
+#define HEALTH_SYS_TASKS    32      // pojemność migawki uxTaskGetSystemState
+#define HEALTH_SEND_TO_MS   100
+
+_Static_assert(sizeof(bb_health_hdr_t) == 48, "bb_health_hdr_t layout");
+_Static_assert(sizeof(bb_health_task_t) == 22, "bb_health_task_t layout");
+
+static TaskHandle_t s_task = NULL;
+static volatile bool s_run = false;
+static volatile uint32_t s_interval_s = CONFIG_BB_HEALTH_INTERVAL;
+static bb_health_hdr_t s_last;              // ostatni raport, dla health_cfg
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+// Tylko task raportu
+static TaskStatus_t s_sys[HEALTH_SYS_TASKS];
+static UBaseType_t s_prev_num[HEALTH_SYS_TASKS];
+static uint32_t s_prev_rt[HEALTH_SYS_TASKS];
+static UBaseType_t s_nprev = 0;
+static uint32_t s_prev_total = 0;
+#endif
+
+// ===== PRÓBKOWANIE =====
+static uint16_t permille(uint32_t part, uint32_t total) {
+    if (total == 0) return BB_HEALTH_CPU_UNKNOWN;
+    uint64_t v = (uint64_t)part * 1000 / total;
+    return v > 1000 ? 1000 : (uint16_t)v;
+}
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+static uint32_t prev_runtime(UBaseType_t num) {
+    for (UBaseType_t i = 0; i < s_nprev; i++) {
+        if (s_prev_num[i] == num) return s_prev_rt[i];
+    }
+    return 0;                               // task nowy od poprzedniego raportu
+}
+
+static void sample_tasks(bb_health_hdr_t* h, bb_health_task_t* tasks) {
+    uint32_t total = 0;
+    UBaseType_t n = uxTaskGetSystemState(s_sys, HEALTH_SYS_TASKS, &total);
+    h->ntotal = (uint8_t)(n ? n : uxTaskGetNumberOfTasks());
+    h->cpu_load = BB_HEALTH_CPU_UNKNOWN;
+    if (n == 0) return;                     // więcej tasków niż HEALTH_SYS_TASKS
+
+    uint32_t dt = total - s_prev_total;
+#if !CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    dt = 0;
+#endif
+    uint32_t idle = 0;
+    for (UBaseType_t i = 0; i < n; i++) {
+        const TaskStatus_t* t = &s_sys[i];
+        uint32_t d = t->ulRunTimeCounter - prev_runtime(t->xTaskNumber);
+        if (strncmp(t->pcTaskName, "IDLE", 4) == 0) idle += d;
+        if (i >= BB_HEALTH_MAX_TASKS) continue;
+
+        bb_health_task_t* e = &tasks[i];
+        strncpy(e->name, t->pcTaskName, BB_HEALTH_NAME_LEN);
+        e->stack_free = t->usStackHighWaterMark > UINT16_MAX ? UINT16_MAX : (uint16_t)t->usStackHighWaterMark;
+        e->cpu = permille(d, dt);
+        e->prio = (uint8_t)t->uxCurrentPriority;
+        e->state = (uint8_t)t->eCurrentState;
+    }
+    h->ntasks = (uint8_t)(n < BB_HEALTH_MAX_TASKS ? n : BB_HEALTH_MAX_TASKS);
+    if (dt) h->cpu_load = (uint16_t)(1000 - permille(idle, dt));
+
+    for (UBaseType_t i = 0; i < n; i++) {
+        s_prev_num[i] = s_sys[i].xTaskNumber;
+        s_prev_rt[i] = s_sys[i].ulRunTimeCounter;
+    }
+    s_nprev = n;
+    s_prev_total = total;
+}
+#endif
+
+static esp_err_t report(void) {
+    ws_tx_slot_t slot;
+    esp_err_t err = ws_comm_tx_reserve(&slot, pdMS_TO_TICKS(HEALTH_SEND_TO_MS));
+    if (err != ESP_OK) return err;
+
+    // bufor slotu ma 512 B: nagłówek + BB_HEALTH_MAX_TASKS wpisów się mieści
+    _Static_assert(sizeof(bb_health_hdr_t) + BB_HEALTH_MAX_TASKS * sizeof(bb_health_task_t) <= 512, "report > TX slot");
+    bb_health_hdr_t h = {
+        .magic = BB_HEALTH_MAGIC,
+        .type = BB_HEALTH_TYPE,
+        .version = BB_HEALTH_VERSION,
+        .reset_reason = (uint8_t)esp_reset_reason(),
+        .interval_s = (uint16_t)s_interval_s,
+        .uptime_s = (uint32_t)(esp_timer_get_time() / 1000000),
+        .heap_free = esp_get_free_heap_size(),
+        .heap_min = esp_get_minimum_free_heap_size(),
+        .heap_largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT),
+        .cpu_load = BB_HEALTH_CPU_UNKNOWN,
+    };
+    ws_comm_stats_t ws;
+    ws_comm_get_stats(&ws);
+    h.ws_connects = ws.connects;
+    h.ws_disconnects = ws.disconnects;
+    h.ws_rx_timeouts = ws.rx_timeouts;
+    h.ws_rx_drop = ws.rx_drop;
+    h.ws_tx_fail = ws.tx_fail;
+
+    bb_health_task_t* tasks = (bb_health_task_t*)(slot.buf + sizeof(h));
+    memset(tasks, 0, BB_HEALTH_MAX_TASKS * sizeof(*tasks));
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+    sample_tasks(&h, tasks);
+#endif
+    memcpy(slot.buf, &h, sizeof(h));
+    s_last = h;
+
+    slot.bin = 1;
+    return ws_comm_tx_commit(&slot, sizeof(h) + h.ntasks * sizeof(bb_health_task_t));
+}
+
+static void health_task(void* pv) {
+    int64_t last = esp_timer_get_time() / 1000000;
+    while (s_run) {
+        // powiadomienie = raport od razu (health_cfg "now" albo nowy interwał)
+        bool now = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(HEALTH_TICK_MS)) != 0;
+        if (!s_run) break;
+        int64_t t = esp_timer_get_time() / 1000000;
+        bool due = s_interval_s && t - last >= s_interval_s;
+        if (!(now || due) || !ws_comm_is_connected()) continue;
+
+        esp_err_t err = report();
+        if (err != ESP_OK) ESP_LOGW(TAG, "report not sent: %s", esp_err_to_name(err));
+        last = t;
+    }
+    s_task = NULL;
+    vTaskDelete(NULL);
+}
+
+// ===== STEROWANIE =====
+esp_err_t bb_health_set_interval(uint32_t seconds) {
+    if (seconds > UINT16_MAX) return ESP_ERR_INVALID_ARG;
+    s_interval_s = seconds;
+    return ESP_OK;
+}
+
+esp_err_t bb_health_send_now(void) {
+    if (!s_task) return ESP_ERR_INVALID_STATE;
+    xTaskNotifyGive(s_task);
+    return ESP_OK;
+}
+
+// {"interval":300,"now":true} -> interwał i ostatni raport w skrócie
+enum { ARG_INTERVAL, ARG_NOW };
+
+static const bbapi_arg_t s_health_cfg_args[] = {
+    [ARG_INTERVAL] = { .name = "interval", .type = BBAPI_ARG_INT, .min = 0, .max = UINT16_MAX },
+    [ARG_NOW]      = { .name = "now",      .type = BBAPI_ARG_BOOL },
+    { 0 }
+};
+
+static esp_err_t cmd_health_cfg(const bbapi_cmd_t* cmd, bb_json_t* result, void* ctx) {
+    if (cmd->present & (1u << ARG_INTERVAL)) bb_health_set_interval((uint32_t)cmd->args[ARG_INTERVAL].i);
+    if ((cmd->present & (1u << ARG_NOW)) && cmd->args[ARG_NOW].b) bb_health_send_now();
+
+    bb_json_key(result, "interval");    bb_json_uint(result, s_interval_s);
+    bb_json_key(result, "heap_free");   bb_json_uint(result, esp_get_free_heap_size());
+    bb_json_key(result, "heap_min");    bb_json_uint(result, esp_get_minimum_free_heap_size());
+    bb_json_key(result, "heap_largest"); bb_json_uint(result, heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+    bb_json_key(result, "cpu");
+    if (s_last.magic && s_last.cpu_load != BB_HEALTH_CPU_UNKNOWN) bb_json_dec(result, s_last.cpu_load, 1);
+    else bb_json_null(result);
+    return ESP_OK;
+}
+
+esp_err_t bb_health_start(void) {
+    if (s_task) return ESP_OK;
+    esp_err_t err = BBAPI_register_cmd("health_cfg", cmd_health_cfg, s_health_cfg_args, NULL);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return err;
+
+    s_run = true;
+    if (xTaskCreate(health_task, "bb_health", 3072, NULL, 2, &s_task) != pdPASS) {
+        s_run = false;
+        s_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void bb_health_stop(void) {
+    s_run = false;
+    if (s_task) xTaskNotifyGive(s_task);
+    for (int i = 0; i < 100 && s_task; ++i) vTaskDelay(pdMS_TO_TICKS(20));
+}
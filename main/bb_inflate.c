@@ -0,0 +1,85 @@
+#include "bb_inflate.h"
+#include "esp_log.h"
+#include "rom/miniz.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TAG "BB_INFLATE"
+
+#define INFLATE_FLAGS   (TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_HAS_MORE_INPUT | TINFL_FLAG_COMPUTE_ADLER32)
+
+_Static_assert((BB_INFLATE_DICT_SIZE & (BB_INFLATE_DICT_SIZE - 1)) == 0, "dict size must be a power of 2");
+
+// Jedna sesja naraz - wywołania z taska zapisu bb_ota
+static tinfl_decompressor* s_inf = NULL;
+static uint8_t* s_dict = NULL;          // bufor cykliczny = okno słownika
+static size_t s_dict_ofs;
+static bb_inflate_out_t s_out;
+static uint32_t s_total_out;
+static bool s_done;
+static bool s_failed;
+
+esp_err_t bb_inflate_begin(bb_inflate_out_t out) {
+    if (!out) return ESP_ERR_INVALID_ARG;
+    bb_inflate_end();
+    s_inf = malloc(sizeof(*s_inf));
+    s_dict = malloc(BB_INFLATE_DICT_SIZE);
+    if (!s_inf || !s_dict) {
+        bb_inflate_end();
+        return ESP_ERR_NO_MEM;
+    }
+    tinfl_init(s_inf);
+    s_dict_ofs = 0;
+    s_out = out;
+    s_total_out = 0;
+    s_done = false;
+    s_failed = false;
+    return ESP_OK;
+}
+
+esp_err_t bb_inflate_feed(const uint8_t* data, size_t len) {
+    if (!s_inf || s_failed) return ESP_ERR_INVALID_STATE;
+    if (s_done) return len ? ESP_ERR_INVALID_SIZE : ESP_OK;
+
+    esp_err_t err = ESP_OK;
+    while (err == ESP_OK) {
+        size_t in_n = len;
+        size_t out_n = BB_INFLATE_DICT_SIZE - s_dict_ofs;
+        tinfl_status st = tinfl_decompress(s_inf, data, &in_n, s_dict, s_dict + s_dict_ofs, &out_n, INFLATE_FLAGS);
+        data += in_n;
+        len -= in_n;
+        if (out_n) {
+            err = s_out(s_dict + s_dict_ofs, out_n);
+            s_total_out += out_n;
+            s_dict_ofs = (s_dict_ofs + out_n) & (BB_INFLATE_DICT_SIZE - 1);
+        }
+        if (st < TINFL_STATUS_DONE) {
+            // także okno z nagłówka większe niż BB_INFLATE_DICT_SIZE
+            ESP_LOGW(TAG, "stream error %d after %u B out", (int)st, (unsigned)s_total_out);
+            err = ESP_ERR_INVALID_RESPONSE;
+        } else if (st == TINFL_STATUS_DONE) {
+            s_done = true;
+            if (err == ESP_OK && len) err = ESP_ERR_INVALID_SIZE;
+            break;
+        } else if (st == TINFL_STATUS_NEEDS_MORE_INPUT && len == 0) {
+            break;
+        }
+    }
+    if (err != ESP_OK) s_failed = true;
+    return err;
+}
+
+bool bb_inflate_done(void) {
+    return s_done && !s_failed;
+}
+
+uint32_t bb_inflate_total_out(void) {
+    return s_total_out;
+}
+
+void bb_inflate_end(void) {
+    free(s_inf);
+    free(s_dict);
+    s_inf = NULL;
+    s_dict = NULL;
+}
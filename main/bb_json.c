@@ -0,0 +1,214 @@
+#include "bb_json.h"
+#include <string.h>
+
+static inline void put(bb_json_t* j, const char* s, size_t n) {
+    if (j->overflow) return;
+    if (j->len + n > j->cap) {
+        j->overflow = true;
+        return;
+    }
+    memcpy(j->buf + j->len, s, n);
+    j->len += n;
+}
+
+static inline void put_char(bb_json_t* j, char c) {
+    if (j->overflow) return;
+    if (j->len >= j->cap) {
+        j->overflow = true;
+        return;
+    }
+    j->buf[j->len++] = c;
+}
+
+// Separator przed wartością: ',' w tablicy, nic po kluczu
+static void value_prefix(bb_json_t* j) {
+    if (j->depth == 0) {
+        if (j->len > 0) j->invalid = true;     // tylko jedna wartość najwyższego poziomu
+        return;
+    }
+    uint8_t bit = 1u << (j->depth - 1);
+    if (j->arrays & bit) {
+        if (j->need_comma & bit) put_char(j, ',');
+        j->need_comma |= bit;
+    } else if (!j->after_key) {
+        j->invalid = true;                      // wartość w obiekcie bez klucza
+    }
+    j->after_key = false;
+}
+
+size_t bb_json_utoa(uint32_t v, char* out) {
+    char tmp[10];
+    size_t n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    for (size_t i = 0; i < n; i++) out[i] = tmp[n - 1 - i];
+    out[n] = '\0';
+    return n;
+}
+
+void bb_json_begin(bb_json_t* j, char* buf, size_t bufsize) {
+    memset(j, 0, sizeof(*j));
+    j->buf = buf;
+    j->cap = bufsize ? bufsize - 1 : 0;
+    if (!buf || bufsize == 0) j->overflow = true;
+}
+
+static void json_open(bb_json_t* j, char c, bool array) {
+    value_prefix(j);
+    if (j->depth >= BB_JSON_MAX_DEPTH) {
+        j->invalid = true;
+        return;
+    }
+    uint8_t bit = 1u << j->depth;
+    j->need_comma &= ~bit;
+    if (array) j->arrays |= bit;
+    else j->arrays &= ~bit;
+    j->depth++;
+    put_char(j, c);
+}
+
+void bb_json_obj(bb_json_t* j) {
+    json_open(j, '{', false);
+}
+
+void bb_json_arr(bb_json_t* j) {
+    json_open(j, '[', true);
+}
+
+void bb_json_end(bb_json_t* j) {
+    if (j->depth == 0 || j->after_key) {
+        j->invalid = true;
+        return;
+    }
+    j->depth--;
+    put_char(j, (j->arrays & (1u << j->depth)) ? ']' : '}');
+}
+
+static void put_escaped(bb_json_t* j, const char* s, size_t n) {
+    static const char hex[] = "0123456789abcdef";
+    put_char(j, '"');
+    size_t run = 0;     // ciągi bez znaków specjalnych kopiowane jednym memcpy
+    for (size_t i = 0; i < n; i++) {
+        unsigned char c = (unsigned char)s[i];
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        put(j, s + run, i - run);
+        run = i + 1;
+        char esc[6] = { '\\', 0 };
+        size_t elen = 2;
+        switch (c) {
+            case '"':  esc[1] = '"';  break;
+            case '\\': esc[1] = '\\'; break;
+            case '\b': esc[1] = 'b';  break;
+            case '\f': esc[1] = 'f';  break;
+            case '\n': esc[1] = 'n';  break;
+            case '\r': esc[1] = 'r';  break;
+            case '\t': esc[1] = 't';  break;
+            default:
+                esc[1] = 'u'; esc[2] = '0'; esc[3] = '0';
+                esc[4] = hex[c >> 4]; esc[5] = hex[c & 0xF];
+                elen = 6;
+                break;
+        }
+        put(j, esc, elen);
+    }
+    put(j, s + run, n - run);
+    put_char(j, '"');
+}
+
+void bb_json_key(bb_json_t* j, const char* key) {
+    uint8_t bit = j->depth ? 1u << (j->depth - 1) : 0;
+    if (!bit || (j->arrays & bit) || j->after_key || !key) {
+        j->invalid = true;
+        return;
+    }
+    if (j->need_comma & bit) put_char(j, ',');
+    j->need_comma |= bit;
+    put_escaped(j, key, strlen(key));
+    put_char(j, ':');
+    j->after_key = true;
+}
+
+void bb_json_strn(bb_json_t* j, const char* s, size_t n) {
+    value_prefix(j);
+    put_escaped(j, s, n);
+}
+
+void bb_json_str(bb_json_t* j, const char* s) {
+    if (!s) {
+        bb_json_null(j);
+        return;
+    }
+    bb_json_strn(j, s, strlen(s));
+}
+
+void bb_json_uint(bb_json_t* j, uint32_t v) {
+    char tmp[11];
+    value_prefix(j);
+    put(j, tmp, bb_json_utoa(v, tmp));
+}
+
+void bb_json_int(bb_json_t* j, int32_t v) {
+    char tmp[12];
+    value_prefix(j);
+    size_t n = 0;
+    uint32_t u = (uint32_t)v;
+    if (v < 0) {
+        tmp[n++] = '-';
+        u = 0u - u;
+    }
+    n += bb_json_utoa(u, tmp + n);
+    put(j, tmp, n);
+}
+
+void bb_json_dec(bb_json_t* j, int32_t v, uint8_t decimals) {
+    if (decimals == 0 || decimals > 9) {
+        bb_json_int(j, v);
+        return;
+    }
+    char tmp[24];
+    value_prefix(j);
+    size_t n = 0;
+    uint32_t u = (uint32_t)v;
+    if (v < 0) {
+        tmp[n++] = '-';
+        u = 0u - u;
+    }
+    uint32_t div = 1;
+    for (uint8_t i = 0; i < decimals; i++) div *= 10;
+    n += bb_json_utoa(u / div, tmp + n);
+    tmp[n++] = '.';
+    // część ułamkowa z zerami wiodącymi: 5, 2 -> "05"
+    char frac[11];
+    size_t flen = bb_json_utoa(u % div, frac);
+    for (size_t i = flen; i < decimals; i++) tmp[n++] = '0';
+    memcpy(tmp + n, frac, flen);
+    n += flen;
+    put(j, tmp, n);
+}
+
+void bb_json_bool(bb_json_t* j, bool v) {
+    value_prefix(j);
+    if (v) put(j, "true", 4);
+    else put(j, "false", 5);
+}
+
+void bb_json_null(bb_json_t* j) {
+    value_prefix(j);
+    put(j, "null", 4);
+}
+
+void bb_json_raw(bb_json_t* j, const char* s, size_t n) {
+    value_prefix(j);
+    put(j, s, n);
+}
+
+esp_err_t bb_json_finish(bb_json_t* j, size_t* out_len) {
+    if (j->buf && !j->overflow) j->buf[j->len] = '\0';
+    if (out_len) *out_len = j->overflow ? 0 : j->len;
+    if (j->overflow) return ESP_ERR_INVALID_SIZE;
+    if (j->invalid || j->depth != 0 || j->after_key || j->len == 0) return ESP_ERR_INVALID_STATE;
+    return ESP_OK;
+}
@@ -0,0 +1,306 @@
+#include "bb_jtok.h"
+#include <string.h>
+
+#define OPEN 0xFFFFu        // end jeszcze niezamkniętego kontenera
+
+typedef struct {
+    unsigned pos;
+    unsigned next;          // następny wolny token
+    int super;              // bieżący rodzic, -1 = korzeń
+} parser_t;
+
+static bb_jtok_t* tok_alloc(parser_t* p, bb_jtok_t* tok, unsigned ntok) {
+    if (p->next >= ntok) return NULL;
+    bb_jtok_t* t = &tok[p->next++];
+    t->type = BB_JTOK_UNDEF;
+    t->start = t->end = OPEN;
+    t->size = 0;
+    t->parent = -1;
+    return t;
+}
+
+static inline bool is_hex(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static int parse_string(parser_t* p, const char* js, size_t len, bb_jtok_t* tok, unsigned ntok) {
+    unsigned start = p->pos;
+    for (p->pos++; p->pos < len; p->pos++) {
+        char c = js[p->pos];
+        if (c == '"') {
+            bb_jtok_t* t = tok_alloc(p, tok, ntok);
+            if (!t) {
+                p->pos = start;
+                return BB_JTOK_ERR_NOMEM;
+            }
+            t->type = BB_JTOK_STR;
+            t->start = (uint16_t)(start + 1);
+            t->end = (uint16_t)p->pos;
+            t->parent = (int16_t)p->super;
+            return 0;
+        }
+        if ((unsigned char)c < 0x20) break;    // znak sterujący bez escape'u
+        if (c == '\\') {
+            if (++p->pos >= len) break;
+            switch (js[p->pos]) {
+                case '"': case '/': case '\\': case 'b':
+                case 'f': case 'r': case 'n': case 't':
+                    break;
+                case 'u':
+                    for (int i = 0; i < 4; i++) {
+                        if (++p->pos >= len) {
+                            p->pos = start;
+                            return BB_JTOK_ERR_PART;
+                        }
+                        if (!is_hex(js[p->pos])) {
+                            p->pos = start;
+                            return BB_JTOK_ERR_INVAL;
+                        }
+                    }
+                    break;
+                default:
+                    p->pos = start;
+                    return BB_JTOK_ERR_INVAL;
+            }
+        }
+    }
+    if (p->pos >= len) {
+        p->pos = start;
+        return BB_JTOK_ERR_PART;
+    }
+    p->pos = start;
+    return BB_JTOK_ERR_INVAL;
+}
+
+static int parse_primitive(parser_t* p, const char* js, size_t len, bb_jtok_t* tok, unsigned ntok) {
+    unsigned start = p->pos;
+    for (; p->pos < len; p->pos++) {
+        char c = js[p->pos];
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ',' || c == ']' || c == '}') {
+            bb_jtok_t* t = tok_alloc(p, tok, ntok);
+            if (!t) {
+                p->pos = start;
+                return BB_JTOK_ERR_NOMEM;
+            }
+            t->type = BB_JTOK_PRIM;
+            t->start = (uint16_t)start;
+            t->end = (uint16_t)p->pos;
+            t->parent = (int16_t)p->super;
+            p->pos--;
+            return 0;
+        }
+        if ((unsigned char)c < 0x20 || (unsigned char)c >= 0x7F) {
+            p->pos = start;
+            return BB_JTOK_ERR_INVAL;
+        }
+    }
+    // prymityw musi być zakończony separatorem - korzeń to zawsze obiekt/tablica
+    p->pos = start;
+    return BB_JTOK_ERR_PART;
+}
+
+int bb_jtok_parse(const char* js, size_t len, bb_jtok_t* tok, unsigned ntok) {
+    if (!js || !tok || len > BB_JTOK_MAX_LEN) return BB_JTOK_ERR_INVAL;
+
+    parser_t p = { .pos = 0, .next = 0, .super = -1 };
+    int err;
+
+    for (; p.pos < len && js[p.pos]; p.pos++) {
+        char c = js[p.pos];
+        bb_jtok_t* t;
+        switch (c) {
+            case '{':
+            case '[':
+                t = tok_alloc(&p, tok, ntok);
+                if (!t) return BB_JTOK_ERR_NOMEM;
+                if (p.super != -1) {
+                    bb_jtok_t* sup = &tok[p.super];
+                    if (sup->type == BB_JTOK_OBJ) return BB_JTOK_ERR_INVAL;    // kontener jako klucz
+                    sup->size++;
+                    t->parent = (int16_t)p.super;
+                }
+                t->type = (c == '{') ? BB_JTOK_OBJ : BB_JTOK_ARR;
+                t->start = (uint16_t)p.pos;
+                p.super = (int)p.next - 1;
+                break;
+
+            case '}':
+            case ']': {
+                uint8_t type = (c == '}') ? BB_JTOK_OBJ : BB_JTOK_ARR;
+                if (p.next < 1) return BB_JTOK_ERR_INVAL;
+                t = &tok[p.next - 1];
+                for (;;) {
+                    if (t->start != OPEN && t->end == OPEN) {
+                        if (t->type != type) return BB_JTOK_ERR_INVAL;
+                        t->end = (uint16_t)(p.pos + 1);
+                        p.super = t->parent;
+                        break;
+                    }
+                    if (t->parent == -1) {
+                        if (t->type != type || p.super == -1) return BB_JTOK_ERR_INVAL;
+                        break;
+                    }
+                    t = &tok[t->parent];
+                }
+                break;
+            }
+
+            case '"':
+                err = parse_string(&p, js, len, tok, ntok);
+                if (err < 0) return err;
+                if (p.super != -1) tok[p.super].size++;
+                break;
+
+            case '\t': case '\r': case '\n': case ' ':
+                break;
+
+            case ':':
+                p.super = (int)p.next - 1;
+                break;
+
+            case ',':
+                if (p.super != -1 && tok[p.super].type != BB_JTOK_ARR && tok[p.super].type != BB_JTOK_OBJ) {
+                    p.super = tok[p.super].parent;
+                }
+                break;
+
+            case '-': case '0': case '1': case '2': case '3': case '4':
+            case '5': case '6': case '7': case '8': case '9':
+            case 't': case 'f': case 'n':
+                if (p.super != -1) {
+                    const bb_jtok_t* sup = &tok[p.super];
+                    // prymityw nie może być kluczem ani drugą wartością klucza
+                    if (sup->type == BB_JTOK_OBJ || (sup->type == BB_JTOK_STR && sup->size != 0)) {
+                        return BB_JTOK_ERR_INVAL;
+                    }
+                }
+                err = parse_primitive(&p, js, len, tok, ntok);
+                if (err < 0) return err;
+                if (p.super != -1) tok[p.super].size++;
+                break;
+
+            default:
+                return BB_JTOK_ERR_INVAL;
+        }
+    }
+
+    for (int i = (int)p.next - 1; i >= 0; i--) {
+        if (tok[i].start != OPEN && tok[i].end == OPEN) return BB_JTOK_ERR_PART;
+    }
+    return (int)p.next;
+}
+
+int bb_jtok_skip(const bb_jtok_t* tok, int ntok, int i) {
+    int j = i + 1;
+    while (j < ntok && tok[j].start < tok[i].end) j++;
+    return j;
+}
+
+bool bb_jtok_eq(const char* js, const bb_jtok_t* t, const char* s) {
+    size_t n = strlen(s);
+    return (size_t)(t->end - t->start) == n && memcmp(js + t->start, s, n) == 0;
+}
+
+int bb_jtok_obj_get(const char* js, const bb_jtok_t* tok, int ntok, int obj, const char* key) {
+    if (obj < 0 || obj >= ntok || tok[obj].type != BB_JTOK_OBJ) return -1;
+    int i = obj + 1;
+    for (unsigned k = 0; k < tok[obj].size && i + 1 < ntok; k++) {
+        if (tok[i].type == BB_JTOK_STR && bb_jtok_eq(js, &tok[i], key)) return i + 1;
+        i = bb_jtok_skip(tok, ntok, i + 1);     // za wartością klucza
+    }
+    return -1;
+}
+
+bool bb_jtok_int(const char* js, const bb_jtok_t* t, int32_t* out) {
+    if (t->type != BB_JTOK_PRIM) return false;
+    const char* s = js + t->start;
+    const char* e = js + t->end;
+    bool neg = (s < e && *s == '-');
+    if (neg) s++;
+    if (s == e) return false;
+
+    uint32_t v = 0;
+    for (; s < e; s++) {
+        if (*s < '0' || *s > '9') return false;
+        uint32_t d = (uint32_t)(*s - '0');
+        if (v > (UINT32_MAX - d) / 10) return false;
+        v = v * 10 + d;
+    }
+    if (v > (neg ? 0x80000000u : 0x7FFFFFFFu)) return false;
+    *out = neg ? (int32_t)(0u - v) : (int32_t)v;
+    return true;
+}
+
+bool bb_jtok_bool(const char* js, const bb_jtok_t* t, bool* out) {
+    if (t->type != BB_JTOK_PRIM) return false;
+    if (bb_jtok_eq(js, t, "true")) *out = true;
+    else if (bb_jtok_eq(js, t, "false")) *out = false;
+    else return false;
+    return true;
+}
+
+static uint32_t hex4(const char* s) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = s[i];
+        v = (v << 4) | (uint32_t)((c <= '9') ? c - '0' : (c | 0x20) - 'a' + 10);
+    }
+    return v;
+}
+
+int bb_jtok_str(const char* js, const bb_jtok_t* t, char* out, size_t outsize) {
+    if (t->type != BB_JTOK_STR || !out || outsize == 0) return -1;
+    size_t n = 0;
+    for (unsigned i = t->start; i < t->end; i++) {
+        char utf8[4];
+        size_t ulen = 1;
+        utf8[0] = js[i];
+        if (js[i] == '\\') {
+            char e = js[++i];
+            switch (e) {
+                case 'b': utf8[0] = '\b'; break;
+                case 'f': utf8[0] = '\f'; break;
+                case 'n': utf8[0] = '\n'; break;
+                case 'r': utf8[0] = '\r'; break;
+                case 't': utf8[0] = '\t'; break;
+                case 'u': {
+                    uint32_t cp = hex4(js + i + 1);
+                    i += 4;
+                    // para surogatów -> jeden punkt kodowy
+                    if (cp >= 0xD800 && cp < 0xDC00 && i + 6 < t->end && js[i + 1] == '\\' && js[i + 2] == 'u') {
+                        uint32_t lo = hex4(js + i + 3);
+                        if (lo >= 0xDC00 && lo < 0xE000) {
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                            i += 6;
+                        }
+                    }
+                    if (cp < 0x80) {
+                        utf8[0] = (char)cp;
+                    } else if (cp < 0x800) {
+                        utf8[0] = (char)(0xC0 | (cp >> 6));
+                        utf8[1] = (char)(0x80 | (cp & 0x3F));
+                        ulen = 2;
+                    } else if (cp < 0x10000) {
+                        utf8[0] = (char)(0xE0 | (cp >> 12));
+                        utf8[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+                        utf8[2] = (char)(0x80 | (cp & 0x3F));
+                        ulen = 3;
+                    } else {
+                        utf8[0] = (char)(0xF0 | (cp >> 18));
+                        utf8[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+                        utf8[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+                        utf8[3] = (char)(0x80 | (cp & 0x3F));
+                        ulen = 4;
+                    }
+                    break;
+                }
+                default: utf8[0] = e; break;     // " \ /
+            }
+        }
+        if (n + ulen >= outsize) return -1;
+        memcpy(out + n, utf8, ulen);
+        n += ulen;
+    }
+    out[n] = '\0';
+    return (int)n;
+}
@@ -0,0 +1,363 @@
+#include "sdkconfig.h"
+
+#if CONFIG_BB_LOADGEN
+
+#include "bb_loadgen.h"
+#include "bbapi.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TAG "LOADGEN"
+
+#define LOADGEN_MSG_MAX         500     // slot TX ws_comm to 512 B
+#define LOADGEN_SEND_TO_MS      20      // ile czekać na wolny slot, potem drop
+#define LOADGEN_MAX_PER_TICK    32      // większe zaległości liczone jako drop
+#define LOADGEN_STOP_TO_MS      2000    // task kończy najwyżej tick wysyłek (32 x 20 ms)
+
+typedef enum {
+    LOAD_TELEMETRY,
+    LOAD_EVENT,
+    LOAD_TEXT,
+} load_kind_t;
+
+static bb_loadgen_cfg_t s_cfg;
+static TaskHandle_t s_task = NULL;
+static volatile bool s_run = false;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static char s_pad[LOADGEN_MSG_MAX];
+
+// Statystyki bieżącego przebiegu, pod s_lock (pisze tylko task generatora)
+static struct {
+    int64_t start_us;
+    int64_t end_us;
+    uint32_t sent;
+    uint32_t dropped;
+    uint64_t bytes;
+    uint64_t lat_sum_us;
+    uint32_t lat_max_us;
+    uint32_t txq_max;
+} s_st;
+
+void bb_loadgen_default_cfg(bb_loadgen_cfg_t* cfg) {
+    *cfg = (bb_loadgen_cfg_t){
+        .rate = CONFIG_BB_LOADGEN_RATE,
+        .burst_len = CONFIG_BB_LOADGEN_BURST_LEN,
+        .burst_period_ms = CONFIG_BB_LOADGEN_BURST_PERIOD_MS,
+        .size_min = CONFIG_BB_LOADGEN_SIZE_MIN,
+        .size_max = CONFIG_BB_LOADGEN_SIZE_MAX,
+        .mix_telemetry = CONFIG_BB_LOADGEN_MIX_TELEMETRY,
+        .mix_event = CONFIG_BB_LOADGEN_MIX_EVENT,
+        .mix_text = CONFIG_BB_LOADGEN_MIX_TEXT,
+        .duration_s = CONFIG_BB_LOADGEN_DURATION_S,
+        .report_ms = CONFIG_BB_LOADGEN_REPORT_MS,
+    };
+}
+
+static uint32_t rnd(uint32_t* x) {
+    *x ^= *x << 13;
+    *x ^= *x >> 17;
+    *x ^= *x << 5;
+    return *x;
+}
+
+static load_kind_t pick_kind(uint32_t* x) {
+    uint32_t total = s_cfg.mix_telemetry + s_cfg.mix_event + s_cfg.mix_text;
+    uint32_t r = rnd(x) % total;
+    if (r < s_cfg.mix_telemetry) return LOAD_TELEMETRY;
+    if (r < s_cfg.mix_telemetry + s_cfg.mix_event) return LOAD_EVENT;
+    return LOAD_TEXT;
+}
+
+// ===== WIADOMOŚCI =====
+// µs od startu jako 64 bit: uint32 zawija co ~71 min, a test bywa dłuższy
+static void json_u64(bb_json_t* j, uint64_t v) {
+    char buf[20];
+    size_t n = sizeof(buf);
+    do {
+        buf[--n] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    bb_json_raw(j, buf + n, sizeof(buf) - n);
+}
+
+static esp_err_t send_text(uint32_t seq, size_t size) {
+    char buf[LOADGEN_MSG_MAX + 1];
+    size_t n = strlen(strcpy(buf, "load-text "));
+    n += bb_json_utoa(seq, buf + n);
+    buf[n++] = ' ';
+    if (size > n) {
+        memcpy(buf + n, s_pad, size - n);
+        n = size;
+    }
+    buf[n] = '\0';
+    return BBAPI_send_text_timeout(buf, pdMS_TO_TICKS(LOADGEN_SEND_TO_MS));
+}
+
+static esp_err_t send_json(load_kind_t kind, uint32_t seq, size_t size) {
+    bbapi_json_t m;
+    esp_err_t err = BBAPI_json_begin(&m, pdMS_TO_TICKS(LOADGEN_SEND_TO_MS));
+    if (err != ESP_OK) return err;
+
+    bb_json_t* j = &m.json;
+    bb_json_obj(j);
+    bb_json_key(j, "v");     bb_json_int(j, 1);
+    bb_json_key(j, "type");  bb_json_str(j, "load");
+    bb_json_key(j, "seq");   bb_json_uint(j, seq);
+    bb_json_key(j, "t_us");  json_u64(j, (uint64_t)esp_timer_get_time());     // serwer liczy opóźnienie
+    if (kind == LOAD_TELEMETRY) {
+        bb_json_key(j, "kind");  bb_json_str(j, "telemetry");
+        bb_json_key(j, "temp");  bb_json_dec(j, 235 + (int32_t)(seq % 50), 1);
+        bb_json_key(j, "hum");   bb_json_int(j, 40 + (int32_t)(seq % 10));
+    } else {
+        bb_json_key(j, "kind");  bb_json_str(j, "event");
+        bb_json_key(j, "ev");    bb_json_str(j, (seq & 1) ? "button" : "motion");
+    }
+    // dopełnienie do zadanego rozmiaru: ,"pad":"xxx"}
+    const size_t pad_overhead = 10;
+    if (size > j->len + pad_overhead) {
+        bb_json_key(j, "pad");
+        bb_json_strn(j, s_pad, size - j->len - pad_overhead);
+    }
+    bb_json_end(j);
+    return BBAPI_json_send(&m);
+}
+
+static void send_one(uint32_t* rng, uint32_t seq) {
+    size_t size = s_cfg.size_min;
+    if (s_cfg.size_max > s_cfg.size_min) size += rnd(rng) % (s_cfg.size_max - s_cfg.size_min + 1);
+
+    int64_t t0 = esp_timer_get_time();
+    load_kind_t kind = pick_kind(rng);
+    esp_err_t err = (kind == LOAD_TEXT) ? send_text(seq, size) : send_json(kind, seq, size);
+    uint32_t lat = (uint32_t)(esp_timer_get_time() - t0);
+
+    portENTER_CRITICAL(&s_lock);
+    if (err == ESP_OK) {
+        s_st.sent++;
+        s_st.bytes += size;
+        s_st.lat_sum_us += lat;
+        if (lat > s_st.lat_max_us) s_st.lat_max_us = lat;
+    } else {
+        s_st.dropped++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void bb_loadgen_get_stats(bb_loadgen_stats_t* out) {
+    portENTER_CRITICAL(&s_lock);
+    int64_t end = s_st.end_us ? s_st.end_us : esp_timer_get_time();
+    uint32_t elapsed_ms = s_st.start_us ? (uint32_t)((end - s_st.start_us) / 1000) : 0;
+    *out = (bb_loadgen_stats_t){
+        .running = s_run,
+        .elapsed_ms = elapsed_ms,
+        .sent = s_st.sent,
+        .dropped = s_st.dropped,
+        .bytes = s_st.bytes,
+        .rate_x10 = elapsed_ms ? (uint32_t)((uint64_t)s_st.sent * 10000 / elapsed_ms) : 0,
+        .lat_avg_us = s_st.sent ? (uint32_t)(s_st.lat_sum_us / s_st.sent) : 0,
+        .lat_max_us = s_st.lat_max_us,
+        .txq_max = s_st.txq_max,
+    };
+    portEXIT_CRITICAL(&s_lock);
+}
+
+static void stats_json(bb_json_t* j, const bb_loadgen_stats_t* st) {
+    bb_json_key(j, "running");   bb_json_bool(j, st->running);
+    bb_json_key(j, "ms");        bb_json_uint(j, st->elapsed_ms);
+    bb_json_key(j, "sent");      bb_json_uint(j, st->sent);
+    bb_json_key(j, "dropped");   bb_json_uint(j, st->dropped);
+    bb_json_key(j, "bytes");     bb_json_uint(j, (uint32_t)st->bytes);
+    bb_json_key(j, "rate");      bb_json_dec(j, (int32_t)st->rate_x10, 1);
+    bb_json_key(j, "lat_avg_us"); bb_json_uint(j, st->lat_avg_us);
+    bb_json_key(j, "lat_max_us"); bb_json_uint(j, st->lat_max_us);
+    bb_json_key(j, "txq_max");   bb_json_uint(j, st->txq_max);
+}
+
+static void report(void) {
+    bb_loadgen_stats_t st;
+    bb_loadgen_get_stats(&st);
+    ESP_LOGI(TAG, "%u ms: sent %u (%u.%u/s, %u B), dropped %u, lat avg %u max %u us, txq max %u",
+             (unsigned)st.elapsed_ms, (unsigned)st.sent, (unsigned)(st.rate_x10 / 10), (unsigned)(st.rate_x10 % 10),
+             (unsigned)st.bytes, (unsigned)st.dropped, (unsigned)st.lat_avg_us, (unsigned)st.lat_max_us,
+             (unsigned)st.txq_max);
+
+    bbapi_json_t m;
+    if (BBAPI_json_begin(&m, 0) != ESP_OK) return;
+    bb_json_obj(&m.json);
+    bb_json_key(&m.json, "v");     bb_json_int(&m.json, 1);
+    bb_json_key(&m.json, "type");  bb_json_str(&m.json, "load_report");
+    stats_json(&m.json, &st);
+    bb_json_end(&m.json);
+    BBAPI_json_send(&m);
+}
+
+// ===== TASK =====
+static void loadgen_task(void* pv) {
+    uint32_t rng = (uint32_t)esp_timer_get_time() | 1;
+    uint32_t seq = 0;
+    uint64_t steady_done = 0;
+    int64_t start = esp_timer_get_time();
+    int64_t next_burst = start + (int64_t)s_cfg.burst_period_ms * 1000;
+    int64_t next_report = start + (int64_t)s_cfg.report_ms * 1000;
+
+    while (s_run) {
+        int64_t now = esp_timer_get_time();
+        if (s_cfg.duration_s && now - start >= (int64_t)s_cfg.duration_s * 1000000) break;
+
+        // tryb ciągły: tyle, ile powinno już wyjść od startu (tick RTOS bywa dłuższy niż okres)
+        uint64_t due = (uint64_t)(now - start) * s_cfg.rate / 1000000;
+        uint64_t n = due - steady_done;
+        if (n > LOADGEN_MAX_PER_TICK) {
+            portENTER_CRITICAL(&s_lock);
+            s_st.dropped += (uint32_t)(n - LOADGEN_MAX_PER_TICK);
+            portEXIT_CRITICAL(&s_lock);
+            steady_done += n - LOADGEN_MAX_PER_TICK;
+            n = LOADGEN_MAX_PER_TICK;
+        }
+        for (; n > 0 && s_run; n--, steady_done++) send_one(&rng, seq++);
+
+        if (s_cfg.burst_len && now >= next_burst) {
+            for (int i = 0; i < s_cfg.burst_len && s_run; i++) send_one(&rng, seq++);
+            next_burst += (int64_t)s_cfg.burst_period_ms * 1000;
+        }
+
+        uint32_t q = (uint32_t)BBAPI_tx_queued();
+        if (q > s_st.txq_max) {
+            portENTER_CRITICAL(&s_lock);
+            s_st.txq_max = q;
+            portEXIT_CRITICAL(&s_lock);
+        }
+
+        if (now >= next_report) {
+            report();
+            next_report += (int64_t)s_cfg.report_ms * 1000;
+        }
+        vTaskDelay(1);
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    s_st.end_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&s_lock);
+    s_run = false;
+    report();
+    s_task = NULL;
+    vTaskDelete(NULL);
+}
+
+esp_err_t bb_loadgen_start(const bb_loadgen_cfg_t* cfg) {
+    if (!cfg) return ESP_ERR_INVALID_ARG;
+    if (cfg->size_min > cfg->size_max || cfg->size_max > LOADGEN_MSG_MAX) return ESP_ERR_INVALID_SIZE;
+    if (cfg->mix_telemetry + cfg->mix_event + cfg->mix_text == 0) return ESP_ERR_INVALID_ARG;
+    if (cfg->rate == 0 && cfg->burst_len == 0) return ESP_ERR_INVALID_ARG;
+    if (cfg->burst_len && cfg->burst_period_ms == 0) return ESP_ERR_INVALID_ARG;
+    if (cfg->report_ms == 0) return ESP_ERR_INVALID_ARG;
+
+    // drugi task generatora obok starego nadpisałby s_cfg i statystyki
+    if (bb_loadgen_stop() != ESP_OK) return ESP_ERR_INVALID_STATE;
+    s_cfg = *cfg;
+    memset(s_pad, 'x', sizeof(s_pad));
+
+    portENTER_CRITICAL(&s_lock);
+    memset(&s_st, 0, sizeof(s_st));
+    s_st.start_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&s_lock);
+
+    s_run = true;
+    if (xTaskCreate(loadgen_task, "loadgen", 4096, NULL, 4, &s_task) != pdPASS) {
+        s_run = false;
+        s_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "start: %u msg/s, burst %u every %u ms, size %u..%u B, mix %u/%u/%u, %u s",
+             (unsigned)cfg->rate, (unsigned)cfg->burst_len, (unsigned)cfg->burst_period_ms,
+             (unsigned)cfg->size_min, (unsigned)cfg->size_max, (unsigned)cfg->mix_telemetry,
+             (unsigned)cfg->mix_event, (unsigned)cfg->mix_text, (unsigned)cfg->duration_s);
+    return ESP_OK;
+}
+
+esp_err_t bb_loadgen_stop(void) {
+    s_run = false;
+    for (int i = 0; i < LOADGEN_STOP_TO_MS / 20 && s_task; ++i) vTaskDelay(pdMS_TO_TICKS(20));
+    if (s_task) {
+        ESP_LOGW(TAG, "task still running after %d ms", LOADGEN_STOP_TO_MS);
+        return ESP_ERR_TIMEOUT;
+    }
+    return ESP_OK;
+}
+
+// ===== KOMENDA SERWERA "loadgen" =====
+enum { ARG_ACTION, ARG_RATE, ARG_SIZE_MIN, ARG_SIZE_MAX, ARG_BURST, ARG_BURST_MS, ARG_DURATION, ARG_MIX };
+
+static const bbapi_arg_t s_loadgen_args[] = {
+    [ARG_ACTION]   = { .name = "action",   .type = BBAPI_ARG_STR, .required = true, .max = 8 },     // start|stop|status
+    [ARG_RATE]     = { .name = "rate",     .type = BBAPI_ARG_INT, .min = 0, .max = 1000 },
+    [ARG_SIZE_MIN] = { .name = "size_min", .type = BBAPI_ARG_INT, .min = 32, .max = LOADGEN_MSG_MAX },
+    [ARG_SIZE_MAX] = { .name = "size_max", .type = BBAPI_ARG_INT, .min = 32, .max = LOADGEN_MSG_MAX },
+    [ARG_BURST]    = { .name = "burst",    .type = BBAPI_ARG_INT, .min = 0, .max = 64 },
+    [ARG_BURST_MS] = { .name = "burst_ms", .type = BBAPI_ARG_INT, .min = 100, .max = 3600000 },
+    [ARG_DURATION] = { .name = "duration", .type = BBAPI_ARG_INT, .min = 0, .max = 604800 },
+    [ARG_MIX]      = { .name = "mix",      .type = BBAPI_ARG_STR, .max = 11 },      // "telemetry,event,text"
+    { 0 }
+};
+
+static bool parse_mix(const char* s, bb_loadgen_cfg_t* cfg) {
+    char* end;
+    long w[3];
+    for (int i = 0; i < 3; i++) {
+        w[i] = strtol(s, &end, 10);
+        if (end == s || w[i] < 0 || w[i] > 100 || (i < 2 && *end != ',') || (i == 2 && *end)) return false;
+        s = end + 1;
+    }
+    cfg->mix_telemetry = (uint8_t)w[0];
+    cfg->mix_event = (uint8_t)w[1];
+    cfg->mix_text = (uint8_t)w[2];
+    return true;
+}
+
+static esp_err_t cmd_loadgen(const bbapi_cmd_t* cmd, bb_json_t* result, void* ctx) {
+    const char* action = cmd->args[ARG_ACTION].s;
+    esp_err_t err = ESP_OK;
+
+    if (strcmp(action, "start") == 0) {
+        bb_loadgen_cfg_t cfg;
+        bb_loadgen_default_cfg(&cfg);
+#define LOADGEN_ARG(idx, field) if (cmd->present & (1u << (idx))) cfg.field = cmd->args[idx].i
+        LOADGEN_ARG(ARG_RATE, rate);
+        LOADGEN_ARG(ARG_SIZE_MIN, size_min);
+        LOADGEN_ARG(ARG_SIZE_MAX, size_max);
+        LOADGEN_ARG(ARG_BURST, burst_len);
+        LOADGEN_ARG(ARG_BURST_MS, burst_period_ms);
+        LOADGEN_ARG(ARG_DURATION, duration_s);
+#undef LOADGEN_ARG
+        if ((cmd->present & (1u << ARG_MIX)) && !parse_mix(cmd->args[ARG_MIX].s, &cfg)) return ESP_ERR_INVALID_ARG;
+        err = bb_loadgen_start(&cfg);
+    } else if (strcmp(action, "stop") == 0) {
+        err = bb_loadgen_stop();
+    } else if (strcmp(action, "status") != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (err != ESP_OK) return err;
+
+    bb_loadgen_stats_t st;
+    bb_loadgen_get_stats(&st);
+    stats_json(result, &st);
+    return ESP_OK;
+}
+
+esp_err_t bb_loadgen_init(void) {
+    esp_err_t err = BBAPI_register_cmd("loadgen", cmd_loadgen, s_loadgen_args, NULL);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return err;
+#if CONFIG_BB_LOADGEN_AUTOSTART
+    bb_loadgen_cfg_t cfg;
+    bb_loadgen_default_cfg(&cfg);
+    err = bb_loadgen_start(&cfg);
+    if (err != ESP_OK) ESP_LOGW(TAG, "autostart failed: %s", esp_err_to_name(err));
+#endif
+    return ESP_OK;
+}
+
+#endif // CONFIG_BB_LOADGEN
@@ -0,0 +1,688 @@
+#include "bb_ota.h"
+#include "bb_assets.h"
+#include "bb_delta.h"
+#include "bb_inflate.h"
+#include "bbapi.h"
+#include "nvs_store.h"
+#include "ws_comm.h"
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "mbedtls/sha256.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+#define TAG "BB_OTA"
+
+#define OTA_NBUF            2
+#define OTA_WAKE            0xFF    // element kolejki bez bufora: przerwanie / timeout
+#define OTA_IDLE_MS         30000   // bez danych tak długo -> FAILED
+#define OTA_FEED_TO_MS      2000    // WS: czekanie na wolny bufor w tasku klienta
+#define OTA_REBOOT_MS       1000
+#define OTA_GEN(g)          ((g) & 0x3F)   // indeks | generacja << 1 nigdy nie daje OTA_WAKE
+#define OTA_SAVE_EVERY      (64 * 1024)     // co tyle zapisanych bajtów offset do NVS
+#define OTA_REPLACE_MS      3000            // ota_begin tego samego obrazu przy otwartej sesji
+
+// Postęp w NVS: obraz (sha256 hex), rozmiar, adres slotu i offset danych już
+// zapisanych we flash. ota_id "" = brak przerwanej sesji.
+#define OTA_KEY_ID          "ota_id"
+#define OTA_KEY_SIZE        "ota_size"
+#define OTA_KEY_PART        "ota_part"
+#define OTA_KEY_OFF         "ota_off"
+
+// Bufory i stan sesji. Producent (feed) pisze s_fill*, task zapisu - s_written,
+// s_image_written, s_sha i uchwyt OTA. Bez kodowania wejście = obraz, inaczej
+// s_size/s_received/s_written liczą bajty przesyłane (zlib i/lub łatka),
+// a s_image* bajty obrazu. Łańcuch: wejście -> [inflate] -> [delta] -> slot. Element kolejki = indeks bufora | generacja sesji << 1,
+// bufory starej sesji (po abort) są tylko oddawane.
+static uint8_t s_buf[OTA_NBUF][BB_OTA_BUF_SIZE];
+static uint16_t s_len[OTA_NBUF];
+static QueueHandle_t s_freeq = NULL;
+static QueueHandle_t s_fullq = NULL;
+static SemaphoreHandle_t s_done = NULL;
+static TaskHandle_t s_task = NULL;
+static volatile bool s_run = false;
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static volatile bb_ota_state_t s_state = BB_OTA_IDLE;
+static volatile esp_err_t s_err = ESP_OK;
+static volatile uint8_t s_gen = 0;
+static volatile bool s_abort = false;
+static volatile esp_err_t s_abort_err;
+static bool s_open = false;                     // uchwyt esp_ota otwarty (begin .. end/abort)
+static bool s_claim = false;                    // bb_ota_begin w toku (pod s_lock)
+static bb_ota_src_t s_src;
+static bb_ota_target_t s_target;
+static uint32_t s_version;                      // ASSETS: wersja paczki
+static uint32_t s_erased;                       // ASSETS: skasowane bajty banku od początku
+static bool s_reboot;
+static const esp_partition_t* s_part = NULL;
+static esp_ota_handle_t s_handle;              // tylko APP
+static uint32_t s_size;
+static uint32_t s_image_size;
+static volatile uint32_t s_image_written;
+static uint8_t s_enc;                           // BB_OTA_ENC_*
+static uint32_t s_decode_us;                    // czas dekompresji / łatki w tasku zapisu
+static uint32_t s_resumed;                      // offset wznowienia, 0 = od początku
+static uint32_t s_saved;                        // ostatni offset zapisany w NVS
+static volatile bool s_announce = false;        // po połączeniu: zgłosić przerwaną sesję
+static char s_id[65];                           // sha256 obrazu hex
+static volatile uint32_t s_received;
+static volatile uint32_t s_written;
+static int s_fill = -1;
+static uint32_t s_fill_len;
+static int64_t s_t0_us;
+static volatile int64_t s_last_us;              // ostatnie dane od producenta
+static uint32_t s_ms;
+static uint32_t s_heap_min;
+static uint8_t s_sha_expect[32];
+static bool s_check_sha;                        // false: tylko walidacja esp_ota_end
+static mbedtls_sha256_context s_sha;
+
+static void abort_with(esp_err_t err);
+
+static const char* const s_state_names[] = { "idle", "recv", "done", "failed" };
+
+static inline int64_t now_us(void) { return esp_timer_get_time(); }
+
+// ===== POSTĘP W NVS =====
+typedef struct {
+    char id[65];
+    uint32_t size;
+    uint32_t part;
+    uint32_t off;
+} ota_progress_t;
+
+static esp_err_t progress_load(ota_progress_t* p) {
+    nvs_store_item_t items[] = {
+        { .key = OTA_KEY_ID,   .type = NVS_TYPE_STR, .buf = p->id,    .bufsize = sizeof(p->id) },
+        { .key = OTA_KEY_SIZE, .type = NVS_TYPE_U32, .buf = &p->size, .bufsize = sizeof(p->size) },
+        { .key = OTA_KEY_PART, .type = NVS_TYPE_U32, .buf = &p->part, .bufsize = sizeof(p->part) },
+        { .key = OTA_KEY_OFF,  .type = NVS_TYPE_U32, .buf = &p->off,  .bufsize = sizeof(p->off) },
+    };
+    esp_err_t err = nvs_store_get_many(items, sizeof(items) / sizeof(items[0]));
+    if (err != ESP_OK) return err;
+    if (p->id[0] == '\0' || p->off == 0 || p->off >= p->size) return ESP_ERR_NOT_FOUND;
+    return ESP_OK;
+}
+
+static esp_err_t progress_store(const char* id, uint32_t off) {
+    nvs_txn_handle_t txn;
+    esp_err_t err = nvs_store_txn_begin(&txn);
+    if (err != ESP_OK) return err;
+    nvs_store_txn_set_str(txn, OTA_KEY_ID, id);
+    nvs_store_txn_set_u32(txn, OTA_KEY_SIZE, s_image_size);
+    nvs_store_txn_set_u32(txn, OTA_KEY_PART, s_part->address);
+    nvs_store_txn_set_u32(txn, OTA_KEY_OFF, off);
+    return nvs_store_txn_commit(txn);
+}
+
+// SHA-256 już zapisanej części obrazu, czytanej z flash - stan hasha nie
+// musi przeżyć restartu, a przy okazji sprawdza, co faktycznie jest w slocie
+static esp_err_t rehash(const esp_partition_t* part, uint32_t off) {
+    for (uint32_t pos = 0; pos < off; pos += BB_OTA_BUF_SIZE) {
+        uint32_t n = off - pos < BB_OTA_BUF_SIZE ? off - pos : BB_OTA_BUF_SIZE;
+        esp_err_t err = esp_partition_read(part, pos, s_buf[0], n);
+        if (err != ESP_OK) return err;
+        mbedtls_sha256_update(&s_sha, s_buf[0], n);
+    }
+    return ESP_OK;
+}
+
+static void bin_to_hex(const uint8_t* in, size_t n, char* out) {
+    static const char hex[] = "0123456789abcdef";
+    for (size_t i = 0; i < n; i++) {
+        out[2 * i] = hex[in[i] >> 4];
+        out[2 * i + 1] = hex[in[i] & 15];
+    }
+    out[2 * n] = '\0';
+}
+
+// ===== RAPORTY DO SERWERA =====
+static void send_ack(uint32_t off) {
+    bbapi_json_t msg;
+    if (BBAPI_json_begin(&msg, pdMS_TO_TICKS(100)) != ESP_OK) return;
+    bb_json_t* j = &msg.json;
+    bb_json_obj(j);
+    bb_json_key(j, "v");    bb_json_int(j, 1);
+    bb_json_key(j, "type"); bb_json_str(j, "ota_ack");
+    bb_json_key(j, "off");  bb_json_uint(j, off);
+    bb_json_end(j);
+    BBAPI_json_send(&msg);
+}
+
+static void send_done(void) {
+    bbapi_json_t msg;
+    if (BBAPI_json_begin(&msg, pdMS_TO_TICKS(500)) != ESP_OK) return;
+    bb_json_t* j = &msg.json;
+    bb_json_obj(j);
+    bb_json_key(j, "v");        bb_json_int(j, 1);
+    bb_json_key(j, "type");     bb_json_str(j, "ota_done");
+    bb_json_key(j, "ok");       bb_json_bool(j, s_state == BB_OTA_DONE);
+    if (s_state != BB_OTA_DONE) {
+        bb_json_key(j, "err");  bb_json_str(j, esp_err_to_name(s_err));
+    }
+    bb_json_key(j, "bytes");    bb_json_uint(j, s_written);
+    bb_json_key(j, "image");    bb_json_uint(j, s_image_written);
+    bb_json_key(j, "resumed");  bb_json_uint(j, s_resumed);
+    bb_json_key(j, "decode_ms"); bb_json_uint(j, s_decode_us / 1000);
+    bb_json_key(j, "ms");       bb_json_uint(j, s_ms);
+    bb_json_key(j, "kBps");     bb_json_uint(j, s_ms ? (uint32_t)((uint64_t)s_written * 1000 / 1024 / s_ms) : 0);
+    bb_json_key(j, "heap_min"); bb_json_uint(j, s_heap_min);
+    bb_json_end(j);
+    BBAPI_json_send(&msg);
+}
+
+// {"v":1,"type":"ota_resume","sha256":"..","size":..,"off":..} - serwer powtarza
+// ota_begin z tym samym obrazem i wysyła od "off"
+static void send_resume(void) {
+    ota_progress_t p;
+    if (progress_load(&p) != ESP_OK) return;
+    bbapi_json_t msg;
+    if (BBAPI_json_begin(&msg, pdMS_TO_TICKS(500)) != ESP_OK) return;
+    bb_json_t* j = &msg.json;
+    bb_json_obj(j);
+    bb_json_key(j, "v");        bb_json_int(j, 1);
+    bb_json_key(j, "type");     bb_json_str(j, "ota_resume");
+    bb_json_key(j, "sha256");   bb_json_str(j, p.id);
+    bb_json_key(j, "size");     bb_json_uint(j, p.size);
+    bb_json_key(j, "off");      bb_json_uint(j, p.off);
+    bb_json_end(j);
+    BBAPI_json_send(&msg);
+}
+
+// ===== TASK ZAPISU =====
+// Koniec sesji - tylko w tasku zapisu, jedynym użytkowniku uchwytu OTA
+static void finish(esp_err_t err) {
+    if (s_target == BB_OTA_TARGET_ASSETS) {
+        // reszta banku po paczce czysta, potem przełączenie w NVS
+        if (err == ESP_OK && s_erased < s_part->size) err = esp_partition_erase_range(s_part, s_erased, s_part->size - s_erased);
+        if (err == ESP_OK) err = bb_assets_commit(s_part, s_version);
+        s_open = false;
+    } else {
+        if (s_open) {
+            if (err == ESP_OK) err = esp_ota_end(s_handle);     // sprawdza też nagłówek i sumę obrazu
+            else esp_ota_abort(s_handle);
+            s_open = false;
+        }
+        if (err == ESP_OK) err = esp_ota_set_boot_partition(s_part);
+    }
+    mbedtls_sha256_free(&s_sha);
+    if (s_enc & BB_OTA_ENC_ZLIB) bb_inflate_end();
+
+    // przerwany transfer (cisza, zerwane łącze, dziura w offsetach) da się
+    // wznowić; zły obraz, abort, błąd flash i kodowanie (stan dekodera) - nie.
+    // Paczka zasobów nie rusza postępu (przerwana sesja aplikacji zostaje)
+    bool resumable = (err == ESP_ERR_TIMEOUT || err == ESP_ERR_INVALID_ARG) && s_written && !s_enc;
+    if (s_target == BB_OTA_TARGET_APP && resumable) {
+        if (s_written != s_saved) nvs_store_set_u32(OTA_KEY_OFF, s_written);
+    } else if (s_target == BB_OTA_TARGET_APP) {
+        progress_store("", 0);
+    }
+
+    s_ms = (uint32_t)((now_us() - s_t0_us) / 1000);
+    s_err = err;
+    s_state = (err == ESP_OK) ? BB_OTA_DONE : BB_OTA_FAILED;
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "%s: %u B (%u B sent) in %u ms, heap min %u B", s_part->label,
+                 (unsigned)s_image_written, (unsigned)s_written, (unsigned)s_ms, (unsigned)s_heap_min);
+    } else {
+        ESP_LOGW(TAG, "update failed at %u/%u B: %s", (unsigned)s_written, (unsigned)s_size, esp_err_to_name(err));
+    }
+    if (s_src == BB_OTA_SRC_WS) send_done();
+    xSemaphoreGive(s_done);
+
+    if (err == ESP_OK && s_reboot && s_target == BB_OTA_TARGET_APP) {
+        vTaskDelay(pdMS_TO_TICKS(OTA_REBOOT_MS));   // ota_done zdąży wyjść
+        esp_restart();
+    }
+}
+
+// Bajty obrazu do slotu: prosto z bufora wejścia albo z dekodera łatki
+static esp_err_t write_image(const uint8_t* data, size_t len) {
+    if (len > s_image_size - s_image_written) return ESP_ERR_INVALID_SIZE;
+    esp_err_t err = ESP_OK;
+    if (s_target == BB_OTA_TARGET_ASSETS) {
+        // bank kasowany sektorami przed zapisem, jak esp_ota z SEQUENTIAL_WRITES
+        uint32_t end = s_image_written + len;
+        while (err == ESP_OK && s_erased < end) {
+            err = esp_partition_erase_range(s_part, s_erased, s_part->erase_size);
+            s_erased += s_part->erase_size;
+        }
+        if (err == ESP_OK) err = esp_partition_write(s_part, s_image_written, data, len);
+    } else {
+        err = esp_ota_write(s_handle, data, len);
+    }
+    if (err != ESP_OK) return err;
+    mbedtls_sha256_update(&s_sha, data, len);
+    s_image_written += len;
+    return ESP_OK;
+}
+
+static esp_err_t write_buf(uint8_t idx) {
+    esp_err_t err;
+    if (s_enc) {
+        int64_t t0 = now_us();
+        err = (s_enc & BB_OTA_ENC_ZLIB) ? bb_inflate_feed(s_buf[idx], s_len[idx]) : bb_delta_feed(s_buf[idx], s_len[idx]);
+        s_decode_us += (uint32_t)(now_us() - t0);       // z zapisem flash wyprodukowanych bajtów
+    } else {
+        err = write_image(s_buf[idx], s_len[idx]);
+    }
+    if (err != ESP_OK) return err;
+    s_written += s_len[idx];
+    if (!s_enc && s_written - s_saved >= OTA_SAVE_EVERY && s_written < s_size) {
+        nvs_store_set_u32(OTA_KEY_OFF, s_written);
+        s_saved = s_written;
+    }
+
+    uint32_t heap = esp_get_free_heap_size();
+    if (heap < s_heap_min) s_heap_min = heap;
+    return ESP_OK;
+}
+
+static void ota_task(void* pv) {
+    while (s_run) {
+        uint8_t item;
+        bool got = xQueueReceive(s_fullq, &item, pdMS_TO_TICKS(1000)) == pdTRUE;
+        if (got && item != OTA_WAKE) {
+            uint8_t idx = item & 1;
+            bool current = (item >> 1) == OTA_GEN(s_gen);
+            if (current && s_open && !s_abort) {
+                esp_err_t err = write_buf(idx);
+                if (err != ESP_OK) {
+                    finish(err);
+                } else if (s_written == s_size) {
+                    uint8_t sha[32];
+                    mbedtls_sha256_finish(&s_sha, sha);
+                    if (s_image_written != s_image_size ||
+                        ((s_enc & BB_OTA_ENC_ZLIB) && !bb_inflate_done()) ||
+                        ((s_enc & BB_OTA_ENC_DELTA) && !bb_delta_done())) err = ESP_ERR_INVALID_SIZE;
+                    else if (s_check_sha && memcmp(sha, s_sha_expect, sizeof(sha)) != 0) err = ESP_ERR_INVALID_CRC;
+                    finish(err);
+                } else if (s_src == BB_OTA_SRC_WS) {
+                    send_ack(s_written);
+                }
+            }
+            if (current) xQueueSend(s_freeq, &idx, 0);
+        }
+        if (!s_open) {
+            if (s_announce && ws_comm_is_connected()) {
+                s_announce = false;
+                send_resume();
+            }
+            continue;
+        }
+        if (s_abort) {
+            finish(s_abort_err);
+        } else if (now_us() - s_last_us > (int64_t)OTA_IDLE_MS * 1000) {
+            finish(ESP_ERR_TIMEOUT);
+        }
+    }
+    s_task = NULL;
+    vTaskDelete(NULL);
+}
+
+// ===== SESJA =====
+// in_size: bajty przesyłane (obraz albo łatka), size: obraz w slocie
+// ASSETS: bank zasobów zamiast slotu aplikacji, bez wznawiania i restartu
+static esp_err_t begin(bb_ota_target_t target, uint32_t version, uint32_t size, const uint8_t sha256[32],
+                       uint32_t in_size, uint8_t enc, bb_ota_src_t src, bool reboot, uint32_t* offset) {
+    if (size == 0 || in_size == 0 || (!sha256 && (enc || offset))) return ESP_ERR_INVALID_ARG;
+    if (!s_task) return ESP_ERR_INVALID_STATE;
+
+    // serwer po ponownym połączeniu zaczyna ten sam obraz, zanim stara sesja
+    // wygasła - zamykamy ją jako przerwaną, postęp zostaje w NVS
+    if (offset && s_open && memcmp(s_sha_expect, sha256, sizeof(s_sha_expect)) == 0) {
+        abort_with(ESP_ERR_TIMEOUT);
+        for (int i = 0; i < OTA_REPLACE_MS / 20 && s_open; ++i) vTaskDelay(pdMS_TO_TICKS(20));
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    bool busy = s_open || s_claim;
+    s_claim = true;
+    portEXIT_CRITICAL(&s_lock);
+    if (busy) return ESP_ERR_INVALID_STATE;
+
+    const esp_partition_t* part = target == BB_OTA_TARGET_ASSETS ? bb_assets_next() : esp_ota_get_next_update_partition(NULL);
+    if (!part || size > part->size) {
+        s_claim = false;
+        return part ? ESP_ERR_INVALID_SIZE : ESP_ERR_NOT_FOUND;
+    }
+    char id[sizeof(s_id)] = "";
+    if (sha256) bin_to_hex(sha256, 32, id);
+    mbedtls_sha256_init(&s_sha);
+    mbedtls_sha256_starts(&s_sha, 0);
+
+    // wznowienie: ten sam obraz i slot, offset zapisanych danych z NVS
+    uint32_t off = 0;
+    ota_progress_t p;
+    if (offset && progress_load(&p) == ESP_OK && strcmp(p.id, id) == 0 &&
+        p.size == size && p.part == part->address) {
+        if (esp_ota_resume(part, OTA_WITH_SEQUENTIAL_WRITES, p.off, &s_handle) == ESP_OK) {
+            if (rehash(part, p.off) == ESP_OK) {
+                off = p.off;
+            } else {
+                esp_ota_abort(s_handle);
+                mbedtls_sha256_starts(&s_sha, 0);
+            }
+        }
+    }
+    esp_err_t err = ESP_OK;
+    // kasowanie sektorami przy zapisie zamiast całego slotu z góry
+    if (off == 0 && target == BB_OTA_TARGET_APP) err = esp_ota_begin(part, OTA_WITH_SEQUENTIAL_WRITES, &s_handle);
+    if (err != ESP_OK) {
+        mbedtls_sha256_free(&s_sha);
+        s_claim = false;
+        return err;
+    }
+
+    // łatka względem działającego slotu (aktywnego banku zasobów), weryfikacja
+    // bazy przy nagłówku; zlib przed łatką albo prosto przed zapisem
+    s_target = target;
+    s_version = version;
+    s_part = part;
+    s_erased = 0;
+    if (enc & BB_OTA_ENC_DELTA) {
+        err = bb_delta_begin(target == BB_OTA_TARGET_ASSETS ? bb_assets_active() : esp_ota_get_running_partition(),
+                             size, write_image);
+    }
+    if (err == ESP_OK && (enc & BB_OTA_ENC_ZLIB)) {
+        err = bb_inflate_begin((enc & BB_OTA_ENC_DELTA) ? bb_delta_feed : write_image);
+    }
+    if (err != ESP_OK) {
+        if (target == BB_OTA_TARGET_APP) esp_ota_abort(s_handle);
+        mbedtls_sha256_free(&s_sha);
+        s_claim = false;
+        return err;
+    }
+
+    // task zapisu jest bezczynny (s_open == false): kolejki od nowa
+    s_gen++;
+    xQueueReset(s_fullq);
+    xQueueReset(s_freeq);
+    for (uint8_t i = 0; i < OTA_NBUF; i++) xQueueSend(s_freeq, &i, 0);
+    xSemaphoreTake(s_done, 0);
+
+    s_size = in_size;
+    s_image_size = size;
+    s_enc = enc;
+    s_decode_us = 0;
+    s_src = src;
+    s_reboot = reboot;
+    s_check_sha = sha256 != NULL;
+    if (sha256) memcpy(s_sha_expect, sha256, sizeof(s_sha_expect));
+    memcpy(s_id, id, sizeof(s_id));
+    if (off == 0 && target == BB_OTA_TARGET_APP) progress_store(s_id, 0);
+    s_received = off;
+    s_written = off;
+    s_image_written = off;
+    s_resumed = off;
+    s_saved = off;
+    s_fill = -1;
+    s_err = ESP_OK;
+    s_abort = false;
+    s_heap_min = esp_get_free_heap_size();
+    s_t0_us = now_us();
+    s_last_us = s_t0_us;
+    s_ms = 0;
+    s_open = true;
+    s_state = BB_OTA_RECV;
+    s_claim = false;
+    if (offset) *offset = off;
+    if (off) ESP_LOGI(TAG, "update -> %s, %u B, resumed at %u", part->label, (unsigned)size, (unsigned)off);
+    else if (enc) ESP_LOGI(TAG, "update -> %s, %u B from %u B%s%s", part->label, (unsigned)size, (unsigned)in_size,
+                           (enc & BB_OTA_ENC_ZLIB) ? " zlib" : "", (enc & BB_OTA_ENC_DELTA) ? " patch" : "");
+    else ESP_LOGI(TAG, "update -> %s, %u B", part->label, (unsigned)size);
+    return ESP_OK;
+}
+
+esp_err_t bb_ota_begin(uint32_t size, const uint8_t sha256[32], bb_ota_src_t src, bool reboot, uint32_t* offset) {
+    return begin(BB_OTA_TARGET_APP, 0, size, sha256, size, 0, src, reboot, offset);
+}
+
+esp_err_t bb_ota_begin_enc(uint32_t size, const uint8_t sha256[32], uint32_t in_size, uint8_t enc,
+                           bb_ota_src_t src, bool reboot) {
+    if (enc & ~(BB_OTA_ENC_DELTA | BB_OTA_ENC_ZLIB)) return ESP_ERR_NOT_SUPPORTED;
+    return begin(BB_OTA_TARGET_APP, 0, size, sha256, in_size, enc, src, reboot, NULL);
+}
+
+esp_err_t bb_ota_begin_assets(uint32_t size, const uint8_t sha256[32], uint32_t in_size, uint8_t enc,
+                              uint32_t version, bb_ota_src_t src) {
+    if (!sha256) return ESP_ERR_INVALID_ARG;
+    if (enc & ~(BB_OTA_ENC_DELTA | BB_OTA_ENC_ZLIB)) return ESP_ERR_NOT_SUPPORTED;
+    if (version <= bb_assets_version()) return ESP_ERR_INVALID_VERSION;
+    return begin(BB_OTA_TARGET_ASSETS, version, size, sha256, in_size, enc, src, false, NULL);
+}
+
+esp_err_t bb_ota_feed(uint32_t offset, const void* data, size_t len, TickType_t to) {
+    if (s_state != BB_OTA_RECV || s_abort) return ESP_ERR_INVALID_STATE;
+    if (offset != s_received) return ESP_ERR_INVALID_ARG;
+    if (len > s_size - s_received) return ESP_ERR_INVALID_SIZE;
+
+    uint8_t gen = OTA_GEN(s_gen);
+    const uint8_t* p = data;
+    s_last_us = now_us();
+    while (len) {
+        if (s_fill < 0) {
+            uint8_t idx;
+            if (xQueueReceive(s_freeq, &idx, to) != pdTRUE) return ESP_ERR_TIMEOUT;
+            s_fill = idx;
+            s_fill_len = 0;
+        }
+        size_t n = BB_OTA_BUF_SIZE - s_fill_len;
+        if (n > len) n = len;
+        memcpy(s_buf[s_fill] + s_fill_len, p, n);
+        s_fill_len += n;
+        s_received += n;
+        p += n;
+        len -= n;
+        if (s_fill_len == BB_OTA_BUF_SIZE || s_received == s_size) {
+            s_len[s_fill] = (uint16_t)s_fill_len;
+            uint8_t item = (uint8_t)(s_fill | gen << 1);
+            xQueueSend(s_fullq, &item, 0);      // mieści się: w obiegu OTA_NBUF buforów
+            s_fill = -1;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t bb_ota_wait(TickType_t to) {
+    if (s_state == BB_OTA_IDLE) return ESP_ERR_INVALID_STATE;
+    if (xSemaphoreTake(s_done, to) != pdTRUE) return ESP_ERR_TIMEOUT;
+    xSemaphoreGive(s_done);                     // stan końcowy dla kolejnych wywołań
+    return s_err;
+}
+
+static void abort_with(esp_err_t err) {
+    if (!s_open || s_abort) return;
+    s_abort_err = err;
+    s_abort = true;
+    uint8_t wake = OTA_WAKE;
+    xQueueSend(s_fullq, &wake, 0);
+}
+
+void bb_ota_abort(void) {
+    abort_with(ESP_ERR_INVALID_STATE);
+}
+
+void bb_ota_link(bool up) {
+    if (up) {
+        s_announce = true;                      // task zapisu, nie z taska klienta WS
+    } else if (s_src == BB_OTA_SRC_WS) {
+        abort_with(ESP_ERR_TIMEOUT);
+    }
+}
+
+const char* bb_ota_state_name(bb_ota_state_t state) {
+    return (unsigned)state < sizeof(s_state_names) / sizeof(s_state_names[0]) ? s_state_names[state] : "?";
+}
+
+void bb_ota_get_status(bb_ota_status_t* out) {
+    if (!out) return;
+    out->state = s_state;
+    out->target = s_target;
+    out->err = s_err;
+    out->size = s_size;
+    out->received = s_received;
+    out->written = s_written;
+    out->image_size = s_image_size;
+    out->image_written = s_image_written;
+    out->resumed = s_resumed;
+    out->ms = (s_state == BB_OTA_RECV) ? (uint32_t)((now_us() - s_t0_us) / 1000) : s_ms;
+    out->heap_min = s_heap_min;
+}
+
+// ===== RAMKI BINARNE WS =====
+// [u8 'O'][u8 typ][u16 0][u32 offset][dane]; części jednej ramki przychodzą kolejno
+static void on_ws_bin(const uint8_t* data, size_t len, size_t off, size_t total, void* ctx) {
+    static bool s_frame_ok = false;
+    static uint32_t s_frame_off;
+
+    if (off == 0) {
+        s_frame_ok = false;
+        if (len < BB_OTA_FRAME_HDR || data[0] != BB_OTA_FRAME_MAGIC || data[1] != BB_OTA_FRAME_DATA) {
+            ESP_LOGW(TAG, "unknown binary frame (%u B)", (unsigned)total);
+            return;
+        }
+        if (s_state != BB_OTA_RECV) return;     // resztki po przerwanej sesji
+        memcpy(&s_frame_off, data + 4, 4);
+        s_frame_ok = true;
+        data += BB_OTA_FRAME_HDR;
+        len -= BB_OTA_FRAME_HDR;
+        off = BB_OTA_FRAME_HDR;
+    }
+    if (!s_frame_ok || len == 0) return;
+
+    esp_err_t err = bb_ota_feed(s_frame_off + (uint32_t)(off - BB_OTA_FRAME_HDR), data, len, pdMS_TO_TICKS(OTA_FEED_TO_MS));
+    if (err != ESP_OK) {
+        s_frame_ok = false;
+        ESP_LOGW(TAG, "frame @%u rejected: %s", (unsigned)s_frame_off, esp_err_to_name(err));
+        abort_with(err);
+    }
+}
+
+// ===== KOMENDY SERWERA =====
+bool bb_ota_sha256_from_hex(const char* hex, uint8_t out[32]) {
+    const size_t n = 32;
+    for (size_t i = 0; i < 2 * n; i++) {
+        char c = hex[i];
+        int v = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 :
+                (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+        if (v < 0) return false;
+        out[i / 2] = (uint8_t)((i & 1) ? (out[i / 2] << 4 | v) : v);
+    }
+    return hex[2 * n] == '\0';
+}
+
+enum { ARG_SIZE, ARG_SHA256, ARG_REBOOT, ARG_DELTA, ARG_ZLIB, ARG_TARGET, ARG_VERSION };
+
+static const bbapi_arg_t s_ota_begin_args[] = {
+    [ARG_SIZE]    = { .name = "size",    .type = BBAPI_ARG_INT, .required = true, .min = 1, .max = INT32_MAX },
+    [ARG_SHA256]  = { .name = "sha256",  .type = BBAPI_ARG_STR, .required = true, .max = 64 },
+    [ARG_REBOOT]  = { .name = "reboot",  .type = BBAPI_ARG_BOOL },
+    [ARG_DELTA]   = { .name = "delta",   .type = BBAPI_ARG_INT, .min = 1, .max = INT32_MAX },
+    [ARG_ZLIB]    = { .name = "zlib",    .type = BBAPI_ARG_INT, .min = 1, .max = INT32_MAX },
+    [ARG_TARGET]  = { .name = "target",  .type = BBAPI_ARG_STR, .max = 8 },        // "app" | "assets"
+    [ARG_VERSION] = { .name = "version", .type = BBAPI_ARG_INT, .min = 1, .max = INT32_MAX },
+    { 0 }
+};
+
+static esp_err_t cmd_ota_begin(const bbapi_cmd_t* cmd, bb_json_t* result, void* ctx) {
+    uint8_t sha[32];
+    if (!bb_ota_sha256_from_hex(cmd->args[ARG_SHA256].s, sha)) return ESP_ERR_INVALID_ARG;
+    bool reboot = (cmd->present & (1u << ARG_REBOOT)) && cmd->args[ARG_REBOOT].b;
+
+    // przesyłane bajty: skompresowane, inaczej łatka, inaczej obraz
+    uint32_t size = (uint32_t)cmd->args[ARG_SIZE].i;
+    uint32_t in_size = size;
+    uint8_t enc = 0;
+    if (cmd->present & (1u << ARG_DELTA)) {
+        enc |= BB_OTA_ENC_DELTA;
+        in_size = (uint32_t)cmd->args[ARG_DELTA].i;
+    }
+    if (cmd->present & (1u << ARG_ZLIB)) {
+        enc |= BB_OTA_ENC_ZLIB;
+        in_size = (uint32_t)cmd->args[ARG_ZLIB].i;
+    }
+    uint32_t off = 0;
+    esp_err_t err;
+    bool assets = (cmd->present & (1u << ARG_TARGET)) && strcmp(cmd->args[ARG_TARGET].s, "assets") == 0;
+    if (assets) {
+        if (!(cmd->present & (1u << ARG_VERSION))) return ESP_ERR_INVALID_ARG;
+        err = bb_ota_begin_assets(size, sha, in_size, enc, (uint32_t)cmd->args[ARG_VERSION].i, BB_OTA_SRC_WS);
+    } else if ((cmd->present & (1u << ARG_TARGET)) && strcmp(cmd->args[ARG_TARGET].s, "app") != 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    } else {
+        err = enc ? bb_ota_begin_enc(size, sha, in_size, enc, BB_OTA_SRC_WS, reboot)
+                  : bb_ota_begin(size, sha, BB_OTA_SRC_WS, reboot, &off);
+    }
+    if (err != ESP_OK) return err;
+    bb_json_key(result, "part");    bb_json_str(result, s_part->label);
+    bb_json_key(result, "offset");  bb_json_uint(result, off);
+    bb_json_key(result, "chunk");   bb_json_uint(result, BB_OTA_BUF_SIZE);
+    bb_json_key(result, "window");  bb_json_uint(result, OTA_NBUF * BB_OTA_BUF_SIZE);
+    return ESP_OK;
+}
+
+static esp_err_t cmd_ota_status(const bbapi_cmd_t* cmd, bb_json_t* result, void* ctx) {
+    if (ctx) bb_ota_abort();                    // ota_abort: ta sama odpowiedź co ota_status
+
+    bb_ota_status_t st;
+    bb_ota_get_status(&st);
+    bb_json_key(result, "state");       bb_json_str(result, bb_ota_state_name(st.state));
+    bb_json_key(result, "target");      bb_json_str(result, st.target == BB_OTA_TARGET_ASSETS ? "assets" : "app");
+    if (st.state == BB_OTA_FAILED) {
+        bb_json_key(result, "err");     bb_json_str(result, esp_err_to_name(st.err));
+    }
+    bb_json_key(result, "size");        bb_json_uint(result, st.size);
+    bb_json_key(result, "received");    bb_json_uint(result, st.received);
+    bb_json_key(result, "written");     bb_json_uint(result, st.written);
+    bb_json_key(result, "image");       bb_json_uint(result, st.image_written);
+    bb_json_key(result, "resumed");     bb_json_uint(result, st.resumed);
+    bb_json_key(result, "ms");          bb_json_uint(result, st.ms);
+    bb_json_key(result, "heap_min");    bb_json_uint(result, st.heap_min);
+    return ESP_OK;
+}
+
+esp_err_t bb_ota_start(void) {
+    if (s_task) return ESP_OK;
+    if (!s_fullq) {
+        s_fullq = xQueueCreate(OTA_NBUF + 1, sizeof(uint8_t));     // + OTA_WAKE
+        s_freeq = xQueueCreate(OTA_NBUF, sizeof(uint8_t));
+        s_done = xSemaphoreCreateBinary();
+        if (!s_fullq || !s_freeq || !s_done) return ESP_ERR_NO_MEM;
+    }
+
+    static const struct { const char* name; const bbapi_arg_t* args; bbapi_cmd_handler_t fn; void* ctx; } cmds[] = {
+        { "ota_begin",  s_ota_begin_args, cmd_ota_begin,  NULL },
+        { "ota_status", NULL,             cmd_ota_status, NULL },
+        { "ota_abort",  NULL,             cmd_ota_status, (void*)1 },
+    };
+    for (size_t i = 0; i < sizeof(cmds) / sizeof(cmds[0]); i++) {
+        esp_err_t err = BBAPI_register_cmd(cmds[i].name, cmds[i].fn, cmds[i].args, cmds[i].ctx);
+        if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return err;
+    }
+
+    // zapis flash poniżej routera RX i workerów komend (5), żeby komendy i
+    // telemetria szły dalej w trakcie aktualizacji
+    s_run = true;
+    if (xTaskCreate(ota_task, "bb_ota", 4096, NULL, 2, &s_task) != pdPASS) {
+        s_run = false;
+        s_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    ws_comm_set_bin_cb(on_ws_bin, NULL);
+    return ESP_OK;
+}
+
+void bb_ota_stop(void) {
+    ws_comm_set_bin_cb(NULL, NULL);
+    abort_with(ESP_ERR_TIMEOUT);                // jak zerwane łącze: postęp w NVS zostaje
+    for (int i = 0; i < 100 && s_open; ++i) vTaskDelay(pdMS_TO_TICKS(20));
+    s_run = false;
+    for (int i = 0; i < 100 && s_task; ++i) vTaskDelay(pdMS_TO_TICKS(20));
+}
@@ -0,0 +1,403 @@
+#include "sdkconfig.h"
+
+#if CONFIG_BB_RLOG
+
+#include "bb_rlog.h"
+#include "bbapi.h"
+#include "ws_comm.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TAG "BB_RLOG"
+
+#define RLOG_RING_SIZE      CONFIG_BB_RLOG_RING_SIZE
+#define RLOG_TICK_MS        200
+#define RLOG_REC_HDR        2       // uint16 długość linii
+
+typedef struct {
+    char tag[BB_RLOG_TAG_MAX + 1];
+    uint8_t level;
+} rlog_filter_t;
+
+// Ring: rekordy [u16 len][tekst], mogą przechodzić przez koniec bufora.
+// Wielu producentów (dowolne taski) - krótka sekcja krytyczna, bez czekania.
+static uint8_t s_ring[RLOG_RING_SIZE];
+static uint32_t s_head = 0;
+static uint32_t s_tail = 0;
+static uint32_t s_used = 0;
+static uint32_t s_removed = 0;                  // rekordy zdjęte z ringu (pop + drop)
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static rlog_filter_t s_filters[BB_RLOG_MAX_FILTERS];
+static uint8_t s_default_level = ESP_LOG_WARN;
+static volatile uint8_t s_max_level = ESP_LOG_WARN;     // szybkie odrzucenie przed formatowaniem
+
+static vprintf_like_t s_prev_vprintf = NULL;
+static TaskHandle_t s_task = NULL;
+static volatile bool s_run = false;
+static volatile bool s_enabled = true;
+static volatile uint32_t s_rate = CONFIG_BB_RLOG_RATE;
+static bb_rlog_stats_t s_st;                    // pod s_lock
+static uint32_t s_drop_reported = 0;
+
+// ===== RING (pod s_lock) =====
+static void ring_put(uint32_t off, const void* src, uint32_t n) {
+    uint32_t first = RLOG_RING_SIZE - off;
+    if (first > n) first = n;
+    memcpy(s_ring + off, src, first);
+    memcpy(s_ring, (const uint8_t*)src + first, n - first);
+}
+
+static void ring_get(uint32_t off, void* dst, uint32_t n) {
+    uint32_t first = RLOG_RING_SIZE - off;
+    if (first > n) first = n;
+    memcpy(dst, s_ring + off, first);
+    memcpy((uint8_t*)dst + first, s_ring, n - first);
+}
+
+static void ring_drop_oldest(void) {
+    uint16_t len;
+    ring_get(s_tail, &len, RLOG_REC_HDR);
+    s_tail = (s_tail + RLOG_REC_HDR + len) % RLOG_RING_SIZE;
+    s_used -= RLOG_REC_HDR + len;
+    s_removed++;
+}
+
+// ===== HOOK LOGÓW =====
+static uint8_t level_from_char(char c) {
+    switch (c) {
+        case 'E': return ESP_LOG_ERROR;
+        case 'W': return ESP_LOG_WARN;
+        case 'I': return ESP_LOG_INFO;
+        case 'D': return ESP_LOG_DEBUG;
+        case 'V': return ESP_LOG_VERBOSE;
+        default:  return ESP_LOG_NONE;
+    }
+}
+
+// Pomija kod koloru ANSI z początku (CONFIG_LOG_COLORS)
+static const char* skip_color(const char* s) {
+    if (s[0] != '\033') return s;
+    const char* m = strchr(s, 'm');
+    return m ? m + 1 : s;
+}
+
+// pod s_lock; "W (1234) TAG: ..." - tag między ") " a ": "
+static uint8_t filter_level(const char* line, size_t n) {
+    const char* p = memchr(line, ')', n);
+    if (!p || (size_t)(p - line) + 2 >= n) return s_default_level;
+    const char* tag = p + 2;
+    const char* end = memchr(tag, ':', n - (size_t)(tag - line));
+    if (!end) return s_default_level;
+    size_t tlen = (size_t)(end - tag);
+    for (int i = 0; i < BB_RLOG_MAX_FILTERS; i++) {
+        if (s_filters[i].tag[0] && strlen(s_filters[i].tag) == tlen && memcmp(s_filters[i].tag, tag, tlen) == 0) {
+            return s_filters[i].level;
+        }
+    }
+    return s_default_level;
+}
+
+// Koszt stosu taska, który loguje: line[BB_RLOG_LINE_MAX] plus ramka
+// vsnprintf. Wołane po wypisaniu na UART, więc szczyt to max(UART, capture),
+// nie suma - ponad sam UART dochodzi głównie bufor linii. Formatowanie
+// wprost do ringu wymagałoby sekcji krytycznej na czas vsnprintf.
+static void capture(const char* fmt, va_list ap) {
+    const char* f = skip_color(fmt);
+    uint8_t level = level_from_char(f[0]);
+    if (level == ESP_LOG_NONE) level = ESP_LOG_INFO;    // printf bez prefiksu poziomu
+    if (level > s_max_level) {
+        portENTER_CRITICAL(&s_lock);
+        s_st.filtered++;
+        portEXIT_CRITICAL(&s_lock);
+        return;
+    }
+
+    char line[BB_RLOG_LINE_MAX];
+    int r = vsnprintf(line, sizeof(line), fmt, ap);
+    if (r <= 0) return;
+    size_t n = ((size_t)r < sizeof(line)) ? (size_t)r : sizeof(line) - 1;
+    const char* s = skip_color(line);
+    n -= (size_t)(s - line);
+    while (n && (s[n - 1] == '\n' || s[n - 1] == '\r')) n--;
+    if (n >= 4 && memcmp(s + n - 4, "\033[0m", 4) == 0) n -= 4;
+    if (n == 0) return;
+
+    uint16_t len = (uint16_t)n;
+    portENTER_CRITICAL(&s_lock);
+    if (filter_level(s, n) < level) {
+        s_st.filtered++;
+    } else {
+        while (RLOG_RING_SIZE - s_used < RLOG_REC_HDR + len) {
+            ring_drop_oldest();
+            s_st.dropped++;
+        }
+        ring_put(s_head, &len, RLOG_REC_HDR);
+        ring_put((s_head + RLOG_REC_HDR) % RLOG_RING_SIZE, s, len);
+        s_head = (s_head + RLOG_REC_HDR + len) % RLOG_RING_SIZE;
+        s_used += RLOG_REC_HDR + len;
+        s_st.captured++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+static int rlog_vprintf(const char* fmt, va_list ap) {
+    va_list cp;
+    va_copy(cp, ap);
+    int ret = s_prev_vprintf ? s_prev_vprintf(fmt, ap) : vprintf(fmt, ap);
+    // własne logi taska wysyłającego nie wracają do ringu
+    if (s_enabled && !xPortInIsrContext() && xTaskGetCurrentTaskHandle() != s_task) capture(fmt, cp);
+    va_end(cp);
+    return ret;
+}
+
+// ===== WYSYŁANIE =====
+static size_t json_char_len(unsigned char c) {
+    return (c == '"' || c == '\\' || c == '\n' || c == '\r' || c == '\t') ? 2 : (c < 0x20) ? 6 : 1;
+}
+
+// Długość po escapowaniu JSON - linia trafia do paczki tylko w całości
+static size_t json_str_len(const char* s, size_t n) {
+    size_t out = 2;
+    for (size_t i = 0; i < n; i++) out += json_char_len((unsigned char)s[i]);
+    return out;
+}
+
+// Najdłuższy prefiks, który po escapowaniu ma najwyżej room B; bez cięcia
+// znaku UTF-8 w połowie
+static size_t json_str_fit(const char* s, size_t n, size_t room) {
+    size_t out = 2, k = 0;
+    while (k < n && out + json_char_len((unsigned char)s[k]) <= room) out += json_char_len((unsigned char)s[k++]);
+    while (k > 0 && k < n && ((unsigned char)s[k] & 0xC0) == 0x80) k--;
+    return k;
+}
+
+// Kopia najstarszej linii bez zdejmowania; seq do sprawdzenia przy pop
+static size_t peek_line(char* out, uint32_t* seq) {
+    size_t n = 0;
+    portENTER_CRITICAL(&s_lock);
+    if (s_used) {
+        uint16_t len;
+        ring_get(s_tail, &len, RLOG_REC_HDR);
+        ring_get((s_tail + RLOG_REC_HDR) % RLOG_RING_SIZE, out, len);
+        n = len;
+        *seq = s_removed;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return n;
+}
+
+// false gdy linię w międzyczasie wyrzucił producent (już policzona w dropped)
+static bool pop_line(uint32_t seq, size_t n) {
+    bool ok = false;
+    portENTER_CRITICAL(&s_lock);
+    if (s_removed == seq && s_used) {
+        ring_drop_oldest();
+        s_st.sent++;
+        s_st.bytes += n;
+        ok = true;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return ok;
+}
+
+// Jedna paczka w slocie niskiego priorytetu; false = nic więcej teraz nie wyślemy
+static bool send_batch(int32_t* tokens) {
+    ws_tx_slot_t slot;
+    if (ws_comm_tx_reserve_low(&slot) != ESP_OK) return false;
+
+    portENTER_CRITICAL(&s_lock);
+    uint32_t drop = s_st.dropped - s_drop_reported;
+    portEXIT_CRITICAL(&s_lock);
+
+    bb_json_t j;
+    bb_json_begin(&j, slot.buf, slot.cap);
+    bb_json_obj(&j);
+    bb_json_key(&j, "v");       bb_json_int(&j, 1);
+    bb_json_key(&j, "type");    bb_json_str(&j, "log");
+    bb_json_key(&j, "drop");    bb_json_uint(&j, drop);
+    bb_json_key(&j, "l");
+    bb_json_arr(&j);
+
+    char line[BB_RLOG_LINE_MAX];
+    int lines = 0;
+    bool more = true;
+    for (;;) {
+        uint32_t seq;
+        size_t n = peek_line(line, &seq);
+        if (n == 0) {
+            more = false;
+            break;
+        }
+        if (s_rate && *tokens < (int32_t)n) {
+            more = false;
+            break;
+        }
+        size_t out = n;
+        if (j.len + json_str_len(line, n) + 4 > j.cap) {                // "]}" + przecinek
+            if (lines > 0) break;
+            // nie mieści się nawet w pustej paczce (znaki sterujące rosną do
+            // 6x przy escapowaniu): obcięta, inaczej zablokowałaby strumień
+            out = json_str_fit(line, n, j.cap - j.len - 4);
+        }
+        if (!pop_line(seq, n)) continue;
+        if (out < n) {
+            portENTER_CRITICAL(&s_lock);
+            s_st.truncated++;
+            portEXIT_CRITICAL(&s_lock);
+        }
+        bb_json_strn(&j, line, out);
+        *tokens -= (int32_t)n;
+        lines++;
+    }
+    bb_json_end(&j);
+    bb_json_end(&j);
+
+    size_t len;
+    if (lines == 0 || bb_json_finish(&j, &len) != ESP_OK) {
+        ws_comm_tx_cancel(&slot);
+        return false;
+    }
+    s_drop_reported += drop;
+    ws_comm_tx_commit(&slot, len);
+    return more;
+}
+
+static void rlog_task(void* pv) {
+    int32_t tokens = 0;
+    TickType_t last = xTaskGetTickCount();
+    while (s_run) {
+        vTaskDelayUntil(&last, pdMS_TO_TICKS(RLOG_TICK_MS));
+
+        // wiadro żetonów: zapas do 1 s, zawsze co najmniej jedna pełna linia
+        uint32_t rate = s_rate;
+        int32_t cap = (rate > BB_RLOG_LINE_MAX) ? (int32_t)rate : BB_RLOG_LINE_MAX;
+        tokens += (int32_t)(rate * RLOG_TICK_MS / 1000);
+        if (tokens > cap) tokens = cap;
+
+        if (!s_enabled || !ws_comm_is_connected()) continue;   // linie czekają w ringu
+        while (s_run && send_batch(&tokens)) {}
+    }
+    s_task = NULL;
+    vTaskDelete(NULL);
+}
+
+// ===== STEROWANIE =====
+static void update_max_level(void) {
+    uint8_t max = s_default_level;
+    for (int i = 0; i < BB_RLOG_MAX_FILTERS; i++) {
+        if (s_filters[i].tag[0] && s_filters[i].level > max) max = s_filters[i].level;
+    }
+    s_max_level = max;
+}
+
+esp_err_t bb_rlog_set_level(const char* tag, esp_log_level_t level) {
+    if (!tag || level > ESP_LOG_VERBOSE) return ESP_ERR_INVALID_ARG;
+    size_t n = strlen(tag);
+    if (n == 0 || n > BB_RLOG_TAG_MAX) return ESP_ERR_INVALID_SIZE;
+
+    esp_err_t err = ESP_OK;
+    portENTER_CRITICAL(&s_lock);
+    if (strcmp(tag, "*") == 0) {
+        s_default_level = level;
+    } else {
+        int slot = -1;
+        for (int i = 0; i < BB_RLOG_MAX_FILTERS; i++) {
+            if (strcmp(s_filters[i].tag, tag) == 0) { slot = i; break; }
+            if (slot < 0 && !s_filters[i].tag[0]) slot = i;
+        }
+        if (slot < 0) {
+            err = ESP_ERR_NO_MEM;
+        } else {
+            memcpy(s_filters[slot].tag, tag, n + 1);
+            s_filters[slot].level = level;
+        }
+    }
+    update_max_level();
+    portEXIT_CRITICAL(&s_lock);
+    return err;
+}
+
+void bb_rlog_set_rate(uint32_t bytes_per_s) {
+    s_rate = bytes_per_s;
+}
+
+void bb_rlog_enable(bool on) {
+    s_enabled = on;
+}
+
+void bb_rlog_get_stats(bb_rlog_stats_t* out) {
+    if (!out) return;
+    portENTER_CRITICAL(&s_lock);
+    *out = s_st;
+    out->ring_used = s_used;
+    portEXIT_CRITICAL(&s_lock);
+    out->enabled = s_enabled;
+    out->rate = s_rate;
+}
+
+// ===== KOMENDA SERWERA "log_cfg" =====
+enum { ARG_ENABLE, ARG_LEVEL, ARG_TAG, ARG_RATE };
+
+static const bbapi_arg_t s_log_cfg_args[] = {
+    [ARG_ENABLE] = { .name = "enable", .type = BBAPI_ARG_BOOL },
+    [ARG_LEVEL]  = { .name = "level",  .type = BBAPI_ARG_STR, .max = 1 },   // N|E|W|I|D|V
+    [ARG_TAG]    = { .name = "tag",    .type = BBAPI_ARG_STR, .max = BB_RLOG_TAG_MAX },
+    [ARG_RATE]   = { .name = "rate",   .type = BBAPI_ARG_INT, .min = 0, .max = 65536 },
+    { 0 }
+};
+
+static esp_err_t cmd_log_cfg(const bbapi_cmd_t* cmd, bb_json_t* result, void* ctx) {
+    if (cmd->present & (1u << ARG_LEVEL)) {
+        const char* l = cmd->args[ARG_LEVEL].s;
+        uint8_t level = level_from_char(l[0]);
+        if (level == ESP_LOG_NONE && strcmp(l, "N") != 0) return ESP_ERR_INVALID_ARG;
+        const char* tag = (cmd->present & (1u << ARG_TAG)) ? cmd->args[ARG_TAG].s : "*";
+        esp_err_t err = bb_rlog_set_level(tag, (esp_log_level_t)level);
+        if (err != ESP_OK) return err;
+    }
+    if (cmd->present & (1u << ARG_RATE)) bb_rlog_set_rate((uint32_t)cmd->args[ARG_RATE].i);
+    if (cmd->present & (1u << ARG_ENABLE)) bb_rlog_enable(cmd->args[ARG_ENABLE].b);
+
+    bb_rlog_stats_t st;
+    bb_rlog_get_stats(&st);
+    bb_json_key(result, "enabled");     bb_json_bool(result, st.enabled);
+    bb_json_key(result, "rate");        bb_json_uint(result, st.rate);
+    bb_json_key(result, "captured");    bb_json_uint(result, st.captured);
+    bb_json_key(result, "filtered");    bb_json_uint(result, st.filtered);
+    bb_json_key(result, "dropped");     bb_json_uint(result, st.dropped);
+    bb_json_key(result, "truncated");   bb_json_uint(result, st.truncated);
+    bb_json_key(result, "sent");        bb_json_uint(result, st.sent);
+    bb_json_key(result, "bytes");       bb_json_uint(result, st.bytes);
+    bb_json_key(result, "ring");        bb_json_uint(result, st.ring_used);
+    return ESP_OK;
+}
+
+esp_err_t bb_rlog_start(void) {
+    if (s_task) return ESP_OK;
+    esp_err_t err = BBAPI_register_cmd("log_cfg", cmd_log_cfg, s_log_cfg_args, NULL);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return err;
+
+    s_run = true;
+    if (xTaskCreate(rlog_task, "bb_rlog", 3072, NULL, 1, &s_task) != pdPASS) {
+        s_run = false;
+        s_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    s_prev_vprintf = esp_log_set_vprintf(rlog_vprintf);
+    ESP_LOGI(TAG, "remote log: %u B ring, %u B/s", (unsigned)RLOG_RING_SIZE, (unsigned)s_rate);
+    return ESP_OK;
+}
+
+void bb_rlog_stop(void) {
+    if (!s_task) return;
+    esp_log_set_vprintf(s_prev_vprintf ? s_prev_vprintf : vprintf);
+    s_run = false;
+    for (int i = 0; i < 50 && s_task; ++i) vTaskDelay(pdMS_TO_TICKS(20));
+}
+
+#endif // CONFIG_BB_RLOG
@@ -0,0 +1,101 @@
+#include "bb_spsc.h"
+#include <string.h>
+
+#define REC_HDR     4u
+#define REC_WRAP    0xFFFFFFFFu     // reszta bufora pusta, rekord od początku
+
+static inline uint32_t rec_need(size_t len) {
+    return REC_HDR + (((uint32_t)len + 3u) & ~3u);
+}
+
+bool bb_spsc_init(bb_spsc_t* r, void* buf, size_t size) {
+    if (!r || !buf || size < 16 || (size & (size - 1)) || ((uintptr_t)buf & 3)) return false;
+    memset(r, 0, sizeof(*r));
+    r->buf = buf;
+    r->size = (uint32_t)size;
+    return true;
+}
+
+void* bb_spsc_reserve(bb_spsc_t* r, size_t len) {
+    uint32_t need = rec_need(len);
+    uint32_t head = r->head;
+    uint32_t tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+    uint32_t free = r->size - (head - tail);
+    uint32_t off = head & (r->size - 1);
+    uint32_t skip = 0;
+
+    if (r->size - off < need) {
+        skip = r->size - off;       // rekord zawsze ciągły - przeskok na początek
+    }
+    if (need > r->size - REC_HDR || free < skip + need) {
+        r->dropped++;
+        r->wr_need = 0;
+        return NULL;
+    }
+    if (skip) {
+        *(uint32_t*)(r->buf + off) = REC_WRAP;
+        off = 0;
+    }
+    *(uint32_t*)(r->buf + off) = (uint32_t)len;
+    r->wr_need = skip + need;
+    return r->buf + off + REC_HDR;
+}
+
+void bb_spsc_commit(bb_spsc_t* r) {
+    if (!r->wr_need) return;
+    __atomic_store_n(&r->head, r->head + r->wr_need, __ATOMIC_RELEASE);
+    r->wr_need = 0;
+    r->pushed++;
+
+    TaskHandle_t c = r->consumer;
+    if (c) xTaskNotifyGiveIndexed(c, BB_SPSC_NOTIFY_INDEX);
+}
+
+bool bb_spsc_push(bb_spsc_t* r, const void* data, size_t len) {
+    void* p = bb_spsc_reserve(r, len);
+    if (!p) return false;
+    memcpy(p, data, len);
+    bb_spsc_commit(r);
+    return true;
+}
+
+const void* bb_spsc_peek(bb_spsc_t* r, size_t* len) {
+    uint32_t tail = r->tail;
+    uint32_t head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+    if (head == tail) return NULL;
+
+    uint32_t off = tail & (r->size - 1);
+    uint32_t hdr = *(const uint32_t*)(r->buf + off);
+    if (hdr == REC_WRAP) {
+        // za znacznikiem zawsze jest rekord zatwierdzony tym samym commit
+        tail += r->size - off;
+        __atomic_store_n(&r->tail, tail, __ATOMIC_RELEASE);
+        off = 0;
+        hdr = *(const uint32_t*)r->buf;
+    }
+    r->rd_need = rec_need(hdr);
+    if (len) *len = hdr;
+    return r->buf + off + REC_HDR;
+}
+
+void bb_spsc_pop(bb_spsc_t* r) {
+    if (!r->rd_need) return;
+    __atomic_store_n(&r->tail, r->tail + r->rd_need, __ATOMIC_RELEASE);
+    r->rd_need = 0;
+    r->popped++;
+}
+
+void bb_spsc_set_consumer(bb_spsc_t* r, TaskHandle_t task) {
+    r->consumer = task;
+}
+
+bool bb_spsc_wait(bb_spsc_t* r, TickType_t to) {
+    if (!r->consumer) r->consumer = xTaskGetCurrentTaskHandle();
+    TickType_t start = xTaskGetTickCount();
+    while (bb_spsc_empty(r)) {
+        TickType_t waited = xTaskGetTickCount() - start;
+        if (waited >= to) return false;
+        ulTaskNotifyTakeIndexed(BB_SPSC_NOTIFY_INDEX, pdTRUE, (to == portMAX_DELAY) ? portMAX_DELAY : to - waited);
+    }
+    return true;
+}
@@ -0,0 +1,368 @@
+#include "bb_ts.h"
+#include "bbapi.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+
+#define TAG "BB_TS"
+
+#define BB_TS_TICK_MS       1000
+#define BB_TS_RAW_BATCH     16      // próbek w jednej wiadomości ts_raw (~450 B)
+#define BB_TS_ENTRY_MAX     80      // zapas na jedną metrykę w wiadomości "ts"
+#define BB_TS_SEND_TO_MS    100
+
+_Static_assert((BB_TS_RAW_LEN & (BB_TS_RAW_LEN - 1)) == 0, "BB_TS_RAW_LEN must be a power of 2");
+
+typedef struct {
+    uint32_t idx;                   // numer okna od startu
+    uint32_t count;
+    int32_t min;
+    int32_t max;
+    int64_t sum;
+} ts_bucket_t;
+
+typedef struct {
+    char name[BB_TS_NAME_MAX + 1];
+    uint8_t decimals;
+    uint8_t mode;
+    uint8_t last_valid;             // bit w = last[w] zawiera zamknięte okno
+    uint8_t pending;                // bit w = last[w] jeszcze nie wysłane
+    ts_bucket_t cur[BB_TS_WINDOWS];
+    ts_bucket_t last[BB_TS_WINDOWS];
+    bb_ts_sample_t raw[BB_TS_RAW_LEN];
+    uint32_t raw_head;              // liczba wszystkich dodanych próbek
+    uint32_t raw_sent;
+    uint32_t raw_lost;              // nadpisane przed wysłaniem w trybie RAW
+} ts_metric_t;
+
+static ts_metric_t s_metrics[BB_TS_MAX_METRICS];
+static volatile uint8_t s_nmetrics = 0;
+static portMUX_TYPE s_ts_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_task = NULL;
+static volatile bool s_run = false;
+
+static const uint32_t s_win_ms[BB_TS_WINDOWS] = { 10000, 60000, 900000 };
+static const char* const s_win_names[BB_TS_WINDOWS] = { "10s", "1m", "15m" };
+static const char* const s_mode_names[] = { "off", "raw", "10s", "1m", "15m" };
+
+static inline int64_t now_ms(void) { return esp_timer_get_time() / 1000; }
+
+// ===== AGREGATY (pod s_ts_lock) =====
+static void roll(ts_metric_t* m, int64_t now) {
+    for (int w = 0; w < BB_TS_WINDOWS; w++) {
+        uint32_t idx = (uint32_t)(now / s_win_ms[w]);
+        ts_bucket_t* b = &m->cur[w];
+        if (b->idx == idx) continue;
+        if (b->count) {
+            m->last[w] = *b;
+            m->last_valid |= 1u << w;
+            m->pending |= 1u << w;
+        }
+        memset(b, 0, sizeof(*b));
+        b->idx = idx;
+    }
+}
+
+static void bucket_to_rollup(const ts_bucket_t* b, bb_ts_window_t w, bb_ts_rollup_t* out) {
+    out->t_ms = b->idx * s_win_ms[w];
+    out->count = b->count;
+    out->min = b->min;
+    out->max = b->max;
+    // zaokrąglenie do najbliższej, symetryczne dla ujemnych
+    int64_t half = b->count / 2;
+    out->mean = b->count ? (int32_t)((b->sum + (b->sum < 0 ? -half : half)) / (int64_t)b->count) : 0;
+}
+
+// ===== API =====
+esp_err_t bb_ts_register(const char* name, uint8_t decimals, bb_ts_mode_t mode, bb_ts_id_t* out) {
+    if (!name || !out || mode > BB_TS_MODE_15M || decimals > 9) return ESP_ERR_INVALID_ARG;
+    size_t n = strlen(name);
+    if (n == 0 || n > BB_TS_NAME_MAX) return ESP_ERR_INVALID_SIZE;
+
+    esp_err_t err = ESP_ERR_NO_MEM;
+    int64_t now = now_ms();
+    portENTER_CRITICAL(&s_ts_lock);
+    for (int i = 0; i < s_nmetrics; i++) {
+        if (strcmp(s_metrics[i].name, name) == 0) {
+            *out = (bb_ts_id_t)i;
+            err = ESP_OK;
+            break;
+        }
+    }
+    if (err != ESP_OK && s_nmetrics < BB_TS_MAX_METRICS) {
+        ts_metric_t* m = &s_metrics[s_nmetrics];
+        memset(m, 0, sizeof(*m));
+        memcpy(m->name, name, n + 1);
+        m->decimals = decimals;
+        m->mode = mode;
+        roll(m, now);
+        *out = s_nmetrics++;
+        err = ESP_OK;
+    }
+    portEXIT_CRITICAL(&s_ts_lock);
+    return err;
+}
+
+esp_err_t bb_ts_add(bb_ts_id_t id, int32_t v) {
+    if (id >= s_nmetrics) return ESP_ERR_INVALID_ARG;
+    ts_metric_t* m = &s_metrics[id];
+    int64_t now = now_ms();
+
+    portENTER_CRITICAL(&s_ts_lock);
+    roll(m, now);
+    for (int w = 0; w < BB_TS_WINDOWS; w++) {
+        ts_bucket_t* b = &m->cur[w];
+        if (b->count == 0 || v < b->min) b->min = v;
+        if (b->count == 0 || v > b->max) b->max = v;
+        b->sum += v;
+        b->count++;
+    }
+    bb_ts_sample_t* s = &m->raw[m->raw_head & (BB_TS_RAW_LEN - 1)];
+    s->t_ms = (uint32_t)now;
+    s->v = v;
+    m->raw_head++;
+    portEXIT_CRITICAL(&s_ts_lock);
+    return ESP_OK;
+}
+
+esp_err_t bb_ts_set_mode(bb_ts_id_t id, bb_ts_mode_t mode) {
+    if (id >= s_nmetrics || mode > BB_TS_MODE_15M) return ESP_ERR_INVALID_ARG;
+    ts_metric_t* m = &s_metrics[id];
+    portENTER_CRITICAL(&s_ts_lock);
+    if (m->mode != mode) {
+        // nowy tryb zaczyna od bieżących danych, bez zaległości z poprzedniego
+        m->mode = mode;
+        m->pending = 0;
+        m->raw_sent = m->raw_head;
+    }
+    portEXIT_CRITICAL(&s_ts_lock);
+    return ESP_OK;
+}
+
+esp_err_t bb_ts_get_rollup(bb_ts_id_t id, bb_ts_window_t w, bb_ts_rollup_t* last, bb_ts_rollup_t* cur) {
+    if (id >= s_nmetrics || w >= BB_TS_WINDOWS) return ESP_ERR_INVALID_ARG;
+    ts_metric_t* m = &s_metrics[id];
+    ts_bucket_t b_last, b_cur;
+    int64_t now = now_ms();
+
+    portENTER_CRITICAL(&s_ts_lock);
+    roll(m, now);
+    bool valid = m->last_valid & (1u << w);
+    b_last = m->last[w];
+    b_cur = m->cur[w];
+    portEXIT_CRITICAL(&s_ts_lock);
+
+    if (cur) bucket_to_rollup(&b_cur, w, cur);
+    if (!valid) return ESP_ERR_NOT_FOUND;
+    if (last) bucket_to_rollup(&b_last, w, last);
+    return ESP_OK;
+}
+
+size_t bb_ts_get_raw(bb_ts_id_t id, bb_ts_sample_t* out, size_t n) {
+    if (id >= s_nmetrics || !out) return 0;
+    ts_metric_t* m = &s_metrics[id];
+
+    portENTER_CRITICAL(&s_ts_lock);
+    uint32_t avail = m->raw_head < BB_TS_RAW_LEN ? m->raw_head : BB_TS_RAW_LEN;
+    if (n > avail) n = avail;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = m->raw[(m->raw_head - n + i) & (BB_TS_RAW_LEN - 1)];
+    }
+    portEXIT_CRITICAL(&s_ts_lock);
+    return n;
+}
+
+// ===== RAPORTY =====
+// Wszystkie metryki w danym trybie okna z tym samym t trafiają do jednej wiadomości
+static void report_window(bb_ts_window_t w) {
+    const uint8_t bit = 1u << w;
+    const uint8_t mode = BB_TS_MODE_10S + w;
+
+    for (;;) {
+        uint32_t t = 0;
+        bool found = false;
+        portENTER_CRITICAL(&s_ts_lock);
+        for (int i = 0; i < s_nmetrics && !found; i++) {
+            if (s_metrics[i].mode == mode && (s_metrics[i].pending & bit)) {
+                t = s_metrics[i].last[w].idx;
+                found = true;
+            }
+        }
+        portEXIT_CRITICAL(&s_ts_lock);
+        if (!found) return;
+
+        bbapi_json_t msg;
+        if (BBAPI_json_begin(&msg, pdMS_TO_TICKS(BB_TS_SEND_TO_MS)) != ESP_OK) return;   // następny tick
+        bb_json_t* j = &msg.json;
+        bb_json_obj(j);
+        bb_json_key(j, "v");    bb_json_int(j, 1);
+        bb_json_key(j, "type"); bb_json_str(j, "ts");
+        bb_json_key(j, "w");    bb_json_str(j, s_win_names[w]);
+        bb_json_key(j, "t");    bb_json_uint(j, t * s_win_ms[w]);
+        bb_json_key(j, "m");
+        bb_json_obj(j);
+
+        for (int i = 0; i < s_nmetrics && j->len + BB_TS_ENTRY_MAX < j->cap; i++) {
+            ts_metric_t* m = &s_metrics[i];
+            ts_bucket_t b;
+            bool take = false;
+            portENTER_CRITICAL(&s_ts_lock);
+            if (m->mode == mode && (m->pending & bit) && m->last[w].idx == t) {
+                b = m->last[w];
+                m->pending &= ~bit;
+                take = true;
+            }
+            portEXIT_CRITICAL(&s_ts_lock);
+            if (!take) continue;
+
+            bb_ts_rollup_t r;
+            bucket_to_rollup(&b, w, &r);
+            bb_json_key(j, m->name);
+            bb_json_arr(j);
+            bb_json_dec(j, r.min, m->decimals);
+            bb_json_dec(j, r.max, m->decimals);
+            bb_json_dec(j, r.mean, m->decimals);
+            bb_json_uint(j, r.count);
+            bb_json_end(j);
+        }
+        bb_json_end(j);
+        bb_json_end(j);
+        if (BBAPI_json_send(&msg) != ESP_OK) return;
+    }
+}
+
+static void report_raw(bb_ts_id_t id) {
+    ts_metric_t* m = &s_metrics[id];
+    bb_ts_sample_t batch[BB_TS_RAW_BATCH];
+
+    for (;;) {
+        uint32_t from, n, lost = 0;
+        portENTER_CRITICAL(&s_ts_lock);
+        if (m->mode != BB_TS_MODE_RAW) {
+            portEXIT_CRITICAL(&s_ts_lock);
+            return;
+        }
+        uint32_t avail = m->raw_head - m->raw_sent;
+        if (avail > BB_TS_RAW_LEN) {
+            lost = avail - BB_TS_RAW_LEN;
+            m->raw_lost += lost;
+            m->raw_sent = m->raw_head - BB_TS_RAW_LEN;
+            avail = BB_TS_RAW_LEN;
+        }
+        from = m->raw_sent;
+        n = avail < BB_TS_RAW_BATCH ? avail : BB_TS_RAW_BATCH;
+        for (uint32_t i = 0; i < n; i++) batch[i] = m->raw[(from + i) & (BB_TS_RAW_LEN - 1)];
+        portEXIT_CRITICAL(&s_ts_lock);
+
+        if (lost) ESP_LOGW(TAG, "%s: %u raw samples overwritten", m->name, (unsigned)lost);
+        if (n == 0) return;
+
+        bbapi_json_t msg;
+        if (BBAPI_json_begin(&msg, pdMS_TO_TICKS(BB_TS_SEND_TO_MS)) != ESP_OK) return;
+        bb_json_t* j = &msg.json;
+        bb_json_obj(j);
+        bb_json_key(j, "v");    bb_json_int(j, 1);
+        bb_json_key(j, "type"); bb_json_str(j, "ts_raw");
+        bb_json_key(j, "m");    bb_json_str(j, m->name);
+        bb_json_key(j, "s");
+        bb_json_arr(j);
+        for (uint32_t i = 0; i < n; i++) {
+            bb_json_arr(j);
+            bb_json_uint(j, batch[i].t_ms);
+            bb_json_dec(j, batch[i].v, m->decimals);
+            bb_json_end(j);
+        }
+        bb_json_end(j);
+        bb_json_end(j);
+        if (BBAPI_json_send(&msg) != ESP_OK) return;
+
+        // set_mode w międzyczasie przestawia raw_sent - wtedy nie przesuwamy
+        portENTER_CRITICAL(&s_ts_lock);
+        if (m->raw_sent == from) m->raw_sent = from + n;
+        portEXIT_CRITICAL(&s_ts_lock);
+    }
+}
+
+static void ts_task(void* pv) {
+    TickType_t last = xTaskGetTickCount();
+    while (s_run) {
+        vTaskDelayUntil(&last, pdMS_TO_TICKS(BB_TS_TICK_MS));
+
+        // okna zamykane także bez nowych próbek
+        int64_t now = now_ms();
+        portENTER_CRITICAL(&s_ts_lock);
+        for (int i = 0; i < s_nmetrics; i++) roll(&s_metrics[i], now);
+        portEXIT_CRITICAL(&s_ts_lock);
+
+        if (!BBAPI_is_ready()) continue;    // agregaty czekają, surowe próbki się nadpisują
+        for (int w = 0; w < BB_TS_WINDOWS; w++) report_window((bb_ts_window_t)w);
+        for (int i = 0; i < s_nmetrics; i++) report_raw((bb_ts_id_t)i);
+    }
+    s_task = NULL;
+    vTaskDelete(NULL);
+}
+
+// ===== KOMENDA SERWERA "ts_cfg" =====
+// {"metric":"temp"|"*","mode":"off|raw|10s|1m|15m"} -> tryby wszystkich metryk
+enum { ARG_METRIC, ARG_MODE };
+
+static const bbapi_arg_t s_ts_cfg_args[] = {
+    [ARG_METRIC] = { .name = "metric", .type = BBAPI_ARG_STR, .max = BB_TS_NAME_MAX },
+    [ARG_MODE]   = { .name = "mode",   .type = BBAPI_ARG_STR, .max = 3 },
+    { 0 }
+};
+
+static esp_err_t cmd_ts_cfg(const bbapi_cmd_t* cmd, bb_json_t* result, void* ctx) {
+    bool has_metric = cmd->present & (1u << ARG_METRIC);
+    bool has_mode = cmd->present & (1u << ARG_MODE);
+    if (has_metric != has_mode) return ESP_ERR_INVALID_ARG;     // sam odczyt: bez obu
+
+    if (has_mode) {
+        int mode = -1;
+        for (int i = 0; i < (int)(sizeof(s_mode_names) / sizeof(s_mode_names[0])); i++) {
+            if (strcmp(cmd->args[ARG_MODE].s, s_mode_names[i]) == 0) mode = i;
+        }
+        if (mode < 0) return ESP_ERR_INVALID_ARG;
+
+        const char* name = cmd->args[ARG_METRIC].s;
+        bool all = (strcmp(name, "*") == 0);
+        bool hit = false;
+        for (int i = 0; i < s_nmetrics; i++) {
+            if (all || strcmp(s_metrics[i].name, name) == 0) {
+                bb_ts_set_mode((bb_ts_id_t)i, (bb_ts_mode_t)mode);
+                hit = true;
+            }
+        }
+        if (!hit) return ESP_ERR_NOT_FOUND;
+    }
+
+    bb_json_key(result, "metrics");
+    bb_json_obj(result);
+    for (int i = 0; i < s_nmetrics; i++) {
+        bb_json_key(result, s_metrics[i].name);
+        bb_json_str(result, s_mode_names[s_metrics[i].mode]);
+    }
+    bb_json_end(result);
+    return ESP_OK;
+}
+
+esp_err_t bb_ts_start(void) {
+    if (s_task) return ESP_OK;
+    esp_err_t err = BBAPI_register_cmd("ts_cfg", cmd_ts_cfg, s_ts_cfg_args, NULL);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return err;
+
+    s_run = true;
+    if (xTaskCreate(ts_task, "bb_ts", 3072, NULL, 3, &s_task) != pdPASS) {
+        s_run = false;
+        s_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void bb_ts_stop(void) {
+    s_run = false;
+    for (int i = 0; i < 100 && s_task; ++i) vTaskDelay(pdMS_TO_TICKS(20));
+}
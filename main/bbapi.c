@@ -1,145 +1,626 @@
 #include "bbapi.h"
+#include "bbapi_api.h"
 #include "ws_comm.h"  
 #include "esp_log.h"
 #include "nvs_store.h"
+#include "bb_hash.h"
+#include "bb_spsc.h"
+#include "bb_loadgen.h"
+#include "bb_ts.h"
+#include "bb_rlog.h"
+#include "bb_blog.h"
+#include "bb_health.h"
+#include "bb_ota.h"
+#include "esp_timer.h"
+#include "esp_rom_crc.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 
 #define TAG "BBAPI"
 static bool s_initialized = false;
 static bool s_params_initialized = false;
 
-#define MAKE_VERSION(major, minor, patch, build) \
-    (((uint32_t)(major) << 24) | ((uint32_t)(minor) << 16) | ((uint32_t)(patch) << 8) | (uint32_t)(build))
 
+// ===== REJESTR PARAMETRÓW =====
+#define BBAPI_INIT_FLAG_KEY     "bbapi_init_flag"
+#define BBAPI_INIT_FLAG_DEFAULTS 1      // wartości domyślne zapisane przy pierwszym starcie
+#define BBAPI_INIT_FLAG_FACTORY  2      // obraz NVS z tools/gen_factory_nvs.py
+#define BBAPI_PARAM_HASH_SLOTS  32      // potęga 2, >= 2 * liczba kluczy (API + NVS)
 
-// ===== FAKE_API_TASK (wszystko prywatne) =====
-#define FAKE_TAG "FAKE_API"
+static const bbapi_param_info_t s_params[BBAPI_PARAM_COUNT] = {
+#define BBAPI_PARAM_INFO(name, nvs_key_, type_, def_str_, def_u32_, max_len_, access_) \
+    [BBAPI_PARAM_##name] = { .key = #name, .nvs_key = nvs_key_, .type = BBAPI_PARAM_TYPE_##type_, \
+                             .access = BBAPI_PARAM_ACCESS_##access_, .def_str = def_str_, \
+                             .def_u32 = def_u32_, .max_len = max_len_ },
+    BBAPI_PARAMS(BBAPI_PARAM_INFO)
+#undef BBAPI_PARAM_INFO
+};
+
+#define BBAPI_PARAM_CHECK_LEN(name, nvs_key, type, def_str, def_u32, max_len, access) \
+    _Static_assert((max_len) <= BBAPI_PARAM_STR_MAX, #name " longer than BBAPI_PARAM_STR_MAX");
+BBAPI_PARAMS(BBAPI_PARAM_CHECK_LEN)
+#undef BBAPI_PARAM_CHECK_LEN
 
-static void send_json_hello(void) {
-    BBAPI_send_text("{\"v\":1,\"type\":\"hello\",\"device\":\"esp32c3\"}");
+// Tablica haszująca z adresowaniem otwartym: slot = id + 1, 0 = pusty
+static uint8_t s_param_slots[BBAPI_PARAM_HASH_SLOTS];
+static bool s_param_slots_ready = false;
+static portMUX_TYPE s_param_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void param_slot_insert(const char* key, bbapi_param_id_t id) {
+    uint32_t i = bb_fnv1a(key) & (BBAPI_PARAM_HASH_SLOTS - 1);
+    while (s_param_slots[i]) {
+        if (s_param_slots[i] == id + 1) return;
+        i = (i + 1) & (BBAPI_PARAM_HASH_SLOTS - 1);
+    }
+    s_param_slots[i] = (uint8_t)(id + 1);
 }
 
-static void send_json_telemetry(int seq) {
-    char buf[256];
-    snprintf(buf, sizeof(buf),
-             "{\"v\":1,\"type\":\"telemetry\",\"temp\":%.1f,\"hum\":%d,\"seq\":%d}",
-             23.5 + (seq % 5), 40 + (seq % 10), seq);
-    BBAPI_send_text(buf);
+static void param_slots_build(void) {
+    portENTER_CRITICAL(&s_param_lock);
+    if (!s_param_slots_ready) {
+        for (int id = 0; id < BBAPI_PARAM_COUNT; id++) {
+            param_slot_insert(s_params[id].key, (bbapi_param_id_t)id);
+            param_slot_insert(s_params[id].nvs_key, (bbapi_param_id_t)id);
+        }
+        s_param_slots_ready = true;
+    }
+    portEXIT_CRITICAL(&s_param_lock);
 }
 
-static void send_cmd_set_led_timeout(int value, TickType_t to) {
-    char buf[128];
-    snprintf(buf, sizeof(buf),
-             "{\"v\":1,\"type\":\"cmd\",\"name\":\"set_led\",\"value\":%d,\"id\":\"%u\"}",
-             value, (unsigned)xTaskGetTickCount());
-    esp_err_t err = BBAPI_send_text_timeout(buf, to);
-    if (err != ESP_OK) {
-        ESP_LOGW(FAKE_TAG, "TX timeout (set_led=%d)", value);
+esp_err_t BBAPI_param_lookup(const char* key, bbapi_param_id_t* out) {
+    if (!key || !out) return ESP_ERR_INVALID_ARG;
+    if (!s_param_slots_ready) param_slots_build();
+
+    uint32_t i = bb_fnv1a(key) & (BBAPI_PARAM_HASH_SLOTS - 1);
+    while (s_param_slots[i]) {
+        bbapi_param_id_t id = (bbapi_param_id_t)(s_param_slots[i] - 1);
+        if (strcmp(s_params[id].key, key) == 0 || strcmp(s_params[id].nvs_key, key) == 0) {
+            *out = id;
+            return ESP_OK;
+        }
+        i = (i + 1) & (BBAPI_PARAM_HASH_SLOTS - 1);
     }
+    return ESP_ERR_NOT_FOUND;
 }
 
-static void send_plain_text(const char* txt) {
-    BBAPI_send_text(txt);
+const bbapi_param_info_t* BBAPI_param_info(bbapi_param_id_t id) {
+    return ((unsigned)id < BBAPI_PARAM_COUNT) ? &s_params[id] : NULL;
 }
 
-static void drain_rx(void) {
-    char buf[512];
-    while (BBAPI_recv_text(buf, sizeof(buf), 0)) {
-        ESP_LOGI(FAKE_TAG, "RX <- SERVER: %s", buf);
-    }
+// ===== WSPÓŁDZIELONA MIGAWKA KONFIGURACJI =====
+// Dwa bufory: zapisujący przygotowuje nieaktywny i przełącza wskaźnik.
+// Zmiany z watch trafiają najpierw do s_cfg_stage i są publikowane razem na
+// NVS_STORE_EVENT_COMMIT, więc czytelnik nie widzi połowy transakcji.
+static bbapi_config_t s_cfg_buf[2];
+static const bbapi_config_t* volatile s_cfg = NULL;
+
+// Etap: pełna treść następnej migawki. changed/reset opisują zdarzenia sprzed
+// pierwszej publikacji (cfg_build) - nakładane na wynik odczytu z NVS.
+static bbapi_config_t s_cfg_stage;
+static uint32_t s_cfg_stage_changed = 0;
+static bool s_cfg_stage_reset = false;
+static bool s_cfg_stage_dirty = false;
+// Worker NVS i cfg_build; sekcja obejmuje kopię i CRC ~400 B
+static portMUX_TYPE s_cfg_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static const struct { uint16_t offset; uint16_t size; } s_cfg_fields[BBAPI_PARAM_COUNT] = {
+#define BBAPI_CONFIG_OFFSET(name, nvs_key, type, def_str, def_u32, max_len, access) \
+    [BBAPI_PARAM_##name] = { offsetof(bbapi_config_t, name), sizeof(((bbapi_config_t*)0)->name) },
+    BBAPI_PARAMS(BBAPI_CONFIG_OFFSET)
+#undef BBAPI_CONFIG_OFFSET
+};
+
+_Static_assert(BBAPI_PARAM_COUNT <= 32, "bbapi_config_t.present holds 32 params");
+
+static uint32_t cfg_crc(const bbapi_config_t* cfg) {
+    const size_t start = offsetof(bbapi_config_t, present);
+    return esp_rom_crc32_le(0, (const uint8_t*)cfg + start, sizeof(*cfg) - start);
+}
+
+// Seqlock: seq nieparzysty, zanim zmieni się pierwszy bajt bufora, kolejny
+// parzysty po ostatnim; czytelnik powtarza odczyt przy nieparzystym albo zmienionym
+static bbapi_config_t* cfg_write_begin(const bbapi_config_t* cur) {
+    bbapi_config_t* next = (cur == &s_cfg_buf[0]) ? &s_cfg_buf[1] : &s_cfg_buf[0];
+    next->seq = (cur ? cur->seq : next->seq) | 1;
+    __sync_synchronize();
+    return next;
 }
 
-static void log_queues(void) {
-    ESP_LOGI(FAKE_TAG, "Q TX=%u RX=%u ready=%d", 
-             (unsigned)BBAPI_tx_queued(), 
-             (unsigned)BBAPI_rx_queued(), 
-             BBAPI_is_ready());
+static void cfg_publish(bbapi_config_t* next) {
+    next->magic = BBAPI_CONFIG_MAGIC;
+    next->version = BBAPI_CONFIG_VERSION;
+    next->size = sizeof(*next);
+    next->crc32 = cfg_crc(next);
+    __sync_synchronize();
+    next->seq++;
+    __sync_synchronize();
+    s_cfg = next;
 }
 
-static void fake_api_task(void* pv) {
-    int seq = 0;
-    TickType_t last_action = xTaskGetTickCount();
+// Część bufora za seq (magic/version/size są stałe)
+#define CFG_BODY_OFFSET     offsetof(bbapi_config_t, crc32)
+#define CFG_BODY_SIZE       (sizeof(bbapi_config_t) - CFG_BODY_OFFSET)
 
-    for (;;) {
-        if (!BBAPI_is_ready()) {
-            vTaskDelay(pdMS_TO_TICKS(500));
-            continue;
-        }
+static void cfg_field_copy(bbapi_config_t* dst, const bbapi_config_t* src, bbapi_param_id_t id) {
+    memcpy((uint8_t*)dst + s_cfg_fields[id].offset, (const uint8_t*)src + s_cfg_fields[id].offset, s_cfg_fields[id].size);
+    dst->present = (dst->present & ~(1u << id)) | (src->present & (1u << id));
+}
+
+// Pierwsza migawka. Watch jest już zarejestrowany: zdarzenia sprzed
+// get_many i po nim są w etapie i są nie starsze niż odczyt, więc wygrywają.
+static esp_err_t cfg_build(void) {
+    bbapi_config_t* next = cfg_write_begin(NULL);
+    memset((uint8_t*)next + CFG_BODY_OFFSET, 0, CFG_BODY_SIZE);
+
+    // Jeden przebieg workera, wartości lądują bezpośrednio w polach migawki
+    nvs_store_item_t items[BBAPI_PARAM_COUNT];
+    for (int id = 0; id < BBAPI_PARAM_COUNT; id++) {
+        items[id] = (nvs_store_item_t){
+            .key = s_params[id].nvs_key,
+            .type = (s_params[id].type == BBAPI_PARAM_TYPE_STR) ? NVS_TYPE_STR : NVS_TYPE_U32,
+            .buf = (uint8_t*)next + s_cfg_fields[id].offset,
+            .bufsize = s_cfg_fields[id].size,
+        };
+    }
+    if (nvs_store_get_many(items, BBAPI_PARAM_COUNT) == ESP_FAIL) return ESP_FAIL;
+
+    for (int id = 0; id < BBAPI_PARAM_COUNT; id++) {
+        if (items[id].err == ESP_OK) next->present |= 1u << id;
+        else memset((uint8_t*)next + s_cfg_fields[id].offset, 0, s_cfg_fields[id].size);
+    }
 
-        drain_rx();
+    portENTER_CRITICAL(&s_cfg_lock);
+    if (s_cfg_stage_reset) memset((uint8_t*)next + CFG_BODY_OFFSET, 0, CFG_BODY_SIZE);
+    for (int id = 0; id < BBAPI_PARAM_COUNT; id++) {
+        if (s_cfg_stage_changed & (1u << id)) cfg_field_copy(next, &s_cfg_stage, id);
+    }
+    memcpy((uint8_t*)&s_cfg_stage + CFG_BODY_OFFSET, (const uint8_t*)next + CFG_BODY_OFFSET, CFG_BODY_SIZE);
+    s_cfg_stage_changed = 0;
+    s_cfg_stage_reset = false;
+    s_cfg_stage_dirty = false;
+    cfg_publish(next);
+    portEXIT_CRITICAL(&s_cfg_lock);
+    return ESP_OK;
+}
+
+// Zmiana jednego klucza do etapu - widoczna po cfg_stage_publish
+static void cfg_stage_set(bbapi_param_id_t id, const void* value) {
+    portENTER_CRITICAL(&s_cfg_lock);
+    uint8_t* field = (uint8_t*)&s_cfg_stage + s_cfg_fields[id].offset;
+    if (s_params[id].type == BBAPI_PARAM_TYPE_STR) {
+        memset(field, 0, s_cfg_fields[id].size);
+        strncpy((char*)field, (const char*)value, s_cfg_fields[id].size - 1);
+    } else {
+        memcpy(field, value, sizeof(uint32_t));
+    }
+    s_cfg_stage.present |= 1u << id;
+    s_cfg_stage_changed |= 1u << id;
+    s_cfg_stage_dirty = true;
+    portEXIT_CRITICAL(&s_cfg_lock);
+}
 
-        TickType_t now = xTaskGetTickCount();
-        if (now - last_action >= pdMS_TO_TICKS(2000)) {
-            switch ((seq / 3) % 3) {
-                case 0: send_json_hello(); break;
-                case 1: send_json_telemetry(seq); break;
-                case 2: send_plain_text("plain-echo"); break;
+// nvs_store_reset skasował wszystkie klucze - etap bez parametrów
+static void cfg_stage_clear(void) {
+    portENTER_CRITICAL(&s_cfg_lock);
+    memset((uint8_t*)&s_cfg_stage + CFG_BODY_OFFSET, 0, CFG_BODY_SIZE);
+    s_cfg_stage_changed = 0;
+    s_cfg_stage_reset = true;
+    s_cfg_stage_dirty = true;
+    portEXIT_CRITICAL(&s_cfg_lock);
+}
+
+// Cała grupa naraz; przed cfg_build etap tylko się zbiera
+static void cfg_stage_publish(void) {
+    portENTER_CRITICAL(&s_cfg_lock);
+    const bbapi_config_t* cur = s_cfg;
+    if (cur && s_cfg_stage_dirty) {
+        bbapi_config_t* next = cfg_write_begin(cur);
+        memcpy((uint8_t*)next + CFG_BODY_OFFSET, (const uint8_t*)&s_cfg_stage + CFG_BODY_OFFSET, CFG_BODY_SIZE);
+        s_cfg_stage_changed = 0;
+        s_cfg_stage_reset = false;
+        s_cfg_stage_dirty = false;
+        cfg_publish(next);
+    }
+    portEXIT_CRITICAL(&s_cfg_lock);
+}
+
+// Spójny odczyt pola: powtórz, jeśli bufor jest albo był w międzyczasie zmieniany
+static esp_err_t cfg_read(bbapi_param_id_t id, void* buffer, size_t bufsize, size_t* out_len) {
+    const bbapi_config_t* cfg;
+    uint32_t seq;
+    esp_err_t err;
+    size_t len;
+    do {
+        cfg = s_cfg;
+        seq = cfg->seq;
+        __sync_synchronize();
+        const uint8_t* field = (const uint8_t*)cfg + s_cfg_fields[id].offset;
+        err = (cfg->present & (1u << id)) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+        len = 0;
+        if (err == ESP_OK && s_params[id].type == BBAPI_PARAM_TYPE_STR) {
+            // jak nvs_store_get_str: len z '\0', obcięte do bufsize (zawsze zakończone)
+            len = strnlen((const char*)field, s_cfg_fields[id].size - 1) + 1;
+            if (len > bufsize) len = bufsize;
+            if (len > 0) {
+                memcpy(buffer, field, len - 1);
+                ((char*)buffer)[len - 1] = '\0';
             }
-            last_action = now;
-            seq++;
+        } else if (err == ESP_OK) {
+            memcpy(buffer, field, sizeof(uint32_t));
+            len = sizeof(uint32_t);
         }
+        __sync_synchronize();
+    } while ((seq & 1) || cfg->seq != seq);
 
-        if ((seq % 15) == 0) {
-            send_cmd_set_led_timeout((seq / 15) & 1, pdMS_TO_TICKS(500));
-        }
+    if (out_len) *out_len = len;
+    return err;
+}
+
+// Klucz z nvs_store_watch -> parametr. false dla zdarzeń (key NULL), obcych
+// kluczy i typu innego niż w tabeli - dopiero wtedy wolno rzutować value.
+static bool watch_param(const char* key, nvs_type_t type, const void* value, bbapi_param_id_t* id) {
+    if (!key || !value || BBAPI_param_lookup(key, id) != ESP_OK) return false;
+    return type == ((s_params[*id].type == BBAPI_PARAM_TYPE_STR) ? NVS_TYPE_STR : NVS_TYPE_U32);
+}
 
-        log_queues();
-        vTaskDelay(pdMS_TO_TICKS(200));
+static void on_param_changed(const char* key, nvs_type_t type, const void* value, void* ctx) {
+    if (!key) {
+        if (!value) return;
+        if (*(const nvs_store_event_t*)value == NVS_STORE_EVENT_RESET) cfg_stage_clear();
+        cfg_stage_publish();
+        return;
     }
+    bbapi_param_id_t id;
+    if (!watch_param(key, type, value, &id)) return;
+    cfg_stage_set(id, value);
 }
 
-// ===== WRAPERY BBAPI =====
-static const char* BOOTBONE_DEFAULT_PARAMS[][2] = {
-    {"device_id", "ESP32C3-DEFAULT"},
-    {"hw_model", "ESP32C3-DEV"},
-    {"device_type", "bootbone_controller"},
-    {"serial_number", "SN-00000000"},
-    {"nazwa_klienta", "Perplexity Labs"},
-    {"pub_key_hash", "0000000000000000000000000000000000000000000000000000000000000000"}
-};
+const bbapi_config_t* BBAPI_config(void) {
+    return s_cfg;
+}
+
+esp_err_t BBAPI_config_copy(bbapi_config_t* out) {
+    if (!out) return ESP_ERR_INVALID_ARG;
+    const bbapi_config_t* cfg;
+    uint32_t seq;
+    do {
+        cfg = s_cfg;
+        if (!cfg) return ESP_ERR_INVALID_STATE;
+        seq = cfg->seq;
+        __sync_synchronize();
+        memcpy(out, cfg, sizeof(*out));
+        __sync_synchronize();
+    } while ((seq & 1) || cfg->seq != seq || out->seq != seq);
+
+    return (out->magic == BBAPI_CONFIG_MAGIC && out->crc32 == cfg_crc(out)) ? ESP_OK : ESP_ERR_INVALID_CRC;
+}
 
 static void init_default_params(void) {
     if (s_params_initialized) return;
     
     ESP_LOGI(TAG, "Initializing BootBone default parameters...");
-    
-    for (int i = 0; i < sizeof(BOOTBONE_DEFAULT_PARAMS) / sizeof(BOOTBONE_DEFAULT_PARAMS[0]); i++) {
-        nvs_store_set_str(BOOTBONE_DEFAULT_PARAMS[i][0], BOOTBONE_DEFAULT_PARAMS[i][1]);
+
+    // Wszystkie domyślne wartości + flaga w jednej transakcji: reset w trakcie
+    // nie zostawi połowicznie zapisanej konfiguracji
+    nvs_txn_handle_t txn;
+    if (nvs_store_txn_begin(&txn) != ESP_OK) {
+        ESP_LOGE(TAG, "No memory for default params transaction");
+        return;
+    }
+
+    esp_err_t err = ESP_OK;
+    for (int id = 0; id < BBAPI_PARAM_COUNT && err == ESP_OK; id++) {
+        const bbapi_param_info_t* p = &s_params[id];
+        err = (p->type == BBAPI_PARAM_TYPE_STR) ? nvs_store_txn_set_str(txn, p->nvs_key, p->def_str)
+                                                : nvs_store_txn_set_u32(txn, p->nvs_key, p->def_u32);
+    }
+    if (err == ESP_OK) err = nvs_store_txn_set_u32(txn, BBAPI_INIT_FLAG_KEY, BBAPI_INIT_FLAG_DEFAULTS);
+    if (err != ESP_OK) {
+        nvs_store_txn_abort(txn);
+        ESP_LOGE(TAG, "BootBone defaults rejected: %s", esp_err_to_name(err));
+        return;
+    }
+
+    err = nvs_store_txn_commit(txn);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "BootBone parameters commit failed: %s", esp_err_to_name(err));
+        return;
     }
-    
-    nvs_store_set_u32("hw_version", MAKE_VERSION(1, 0, 0, 0));
-    nvs_store_set_u32("bootbone_fw_version", MAKE_VERSION(1, 0, 0, 0));
-    nvs_store_set_u32("mainapp_fw_version", 0);
-    
-    nvs_store_set_u32("bbapi_init_flag", 1);  // Flaga inicjalizacji
     s_params_initialized = true;
     ESP_LOGI(TAG, "BootBone parameters initialized OK");
 }
 
-static bool is_bootbone_param(const char* key) 
-{
-    return strncmp(key, "device_id", 9) == 0 ||
-           strncmp(key, "hw_model", 8) == 0 ||
-           strncmp(key, "device_type", 10) == 0 ||
-           strncmp(key, "serial_number", 13) == 0 ||
-           strncmp(key, "nazwa_klienta", 13) == 0 ||
-           strncmp(key, "pub_key_hash", 12) == 0 ||
-           strncmp(key, "hw_version", 10) == 0 ||
-           strncmp(key, "bootbone_fw_version", 19) == 0 ||
-           strncmp(key, "mainapp_fw_version", 18) == 0;
+// ===== USTAWIENIA NA ŻYWO (nvs_store_watch) =====
+static portMUX_TYPE s_rate_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t s_tx_rate = 0;
+static uint32_t s_tx_tokens = 0;
+static int64_t s_tx_refill_us = 0;
+
+static void set_tx_rate(uint32_t rate) {
+    portENTER_CRITICAL(&s_rate_lock);
+    s_tx_rate = rate;
+    s_tx_tokens = rate;
+    s_tx_refill_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&s_rate_lock);
+}
+
+// Token bucket, pojemność = limit na 1 s
+static bool tx_rate_allow(void) {
+    bool ok = true;
+    portENTER_CRITICAL(&s_rate_lock);
+    if (s_tx_rate) {
+        int64_t now = esp_timer_get_time();
+        uint64_t add = (uint64_t)(now - s_tx_refill_us) * s_tx_rate / 1000000;
+        if (add > 0) {
+            s_tx_tokens = (s_tx_tokens + add > s_tx_rate) ? s_tx_rate : (uint32_t)(s_tx_tokens + add);
+            s_tx_refill_us = now;
+        }
+        if (s_tx_tokens > 0) s_tx_tokens--;
+        else ok = false;
+    }
+    portEXIT_CRITICAL(&s_rate_lock);
+    return ok;
+}
+
+// Reset i koniec grupy pomijane: ustawienia działają do restartu
+static void on_setting_changed(const char* key, nvs_type_t type, const void* value, void* ctx) {
+    bbapi_param_id_t id;
+    if (!watch_param(key, type, value, &id)) return;
+
+    switch (id) {
+        case BBAPI_PARAM_ws_uri:
+            if (((const char*)value)[0]) ws_comm_set_uri((const char*)value);
+            break;
+        case BBAPI_PARAM_ws_hb_ms:
+            ws_comm_set_heartbeat_ms(*(const uint32_t*)value);
+            break;
+        case BBAPI_PARAM_tx_rate_limit:     // wiadomości/s, 0 = bez limitu
+            set_tx_rate(*(const uint32_t*)value);
+            break;
+        default:
+            return;
+    }
+    ESP_LOGI(TAG, "Setting %s applied", key);
+}
+
+// ===== ROUTER RX =====
+// Jedyny konsument slotów RX ws_comm: każda wiadomość jest tokenizowana raz,
+// w miejscu, i podawana handlerom bez kopiowania.
+// 512 tokenów (5 KB) wystarcza na wiadomość 4 KB przy ~8 B na token; gęstsza
+// (np. długie tablice liczb) idzie do aplikacji jako tekst
+#define BBAPI_RX_MAX_TOKENS     512
+#define BBAPI_RX_MAX_HANDLERS   8
+#define BBAPI_APP_RX_RING       8192    // tekst nieobsłużonych wiadomości, mieści 4 KB
+#define BBAPI_APP_LINK_RING     64
+
+typedef struct {
+    char type[24];
+    bbapi_rx_handler_t fn;
+    void* ctx;
+} bbapi_rx_handler_entry_t;
+
+static bbapi_rx_handler_entry_t s_rx_handlers[BBAPI_RX_MAX_HANDLERS];
+static portMUX_TYPE s_rx_lock = portMUX_INITIALIZER_UNLOCKED;
+static bb_jtok_t s_rx_tok[BBAPI_RX_MAX_TOKENS];
+// Kanały do aplikacji. Slot RX wraca do ws_comm od razu, w kanale ląduje
+// tylko faktyczna długość tekstu.
+static bb_spsc_t s_app_rx;                      // producent: router RX
+static bb_spsc_t s_app_link;                    // producent: task klienta websocket
+static uint32_t s_app_rx_buf[BBAPI_APP_RX_RING / 4];
+static uint32_t s_app_link_buf[BBAPI_APP_LINK_RING / 4];
+static volatile bool s_app_ready = false;
+static TaskHandle_t s_rx_task = NULL;
+static volatile bool s_rx_run = false;
+
+static bool rx_type_match(const char* pattern, const bbapi_msg_t* m) {
+    if (pattern[0] == '*' && pattern[1] == '\0') return true;
+    return m->type && strlen(pattern) == m->type_len && memcmp(pattern, m->type, m->type_len) == 0;
+}
+
+static bool rx_parse(const ws_rx_slot_t* slot, bbapi_msg_t* m) {
+    int n = bb_jtok_parse(slot->buf, slot->len, s_rx_tok, BBAPI_RX_MAX_TOKENS);
+    if (n == BB_JTOK_ERR_NOMEM) ESP_LOGW(TAG, "RX: more than %d JSON tokens", BBAPI_RX_MAX_TOKENS);
+    if (n <= 0 || s_rx_tok[0].type != BB_JTOK_OBJ) return false;
+
+    memset(m, 0, sizeof(*m));
+    m->js = slot->buf;
+    m->len = slot->len;
+    m->tok = s_rx_tok;
+    m->ntok = n;
+
+    int i = bb_jtok_obj_get(m->js, m->tok, n, 0, "v");
+    if (i > 0) bb_jtok_int(m->js, &m->tok[i], &m->v);
+    i = bb_jtok_obj_get(m->js, m->tok, n, 0, "type");
+    if (i > 0 && m->tok[i].type == BB_JTOK_STR) {
+        m->type = m->js + m->tok[i].start;
+        m->type_len = m->tok[i].end - m->tok[i].start;
+    }
+    i = bb_jtok_obj_get(m->js, m->tok, n, 0, "id");
+    if (i > 0 && (m->tok[i].type == BB_JTOK_STR || m->tok[i].type == BB_JTOK_PRIM)) {
+        m->id = m->js + m->tok[i].start;
+        m->id_len = m->tok[i].end - m->tok[i].start;
+    }
+    return true;
+}
+
+static bool rx_dispatch(const bbapi_msg_t* m) {
+    bbapi_rx_handler_entry_t hits[BBAPI_RX_MAX_HANDLERS];
+    int n = 0;
+    portENTER_CRITICAL(&s_rx_lock);
+    for (int i = 0; i < BBAPI_RX_MAX_HANDLERS; i++) {
+        if (s_rx_handlers[i].fn && rx_type_match(s_rx_handlers[i].type, m)) hits[n++] = s_rx_handlers[i];
+    }
+    portEXIT_CRITICAL(&s_rx_lock);
+
+    for (int i = 0; i < n; i++) {
+        if (hits[i].fn(m, hits[i].ctx)) return true;
+    }
+    return false;
 }
 
-static bool is_string_param(const char* key) 
-{
-    return strncmp(key, "device_id", 9) == 0 ||
-           strncmp(key, "hw_model", 8) == 0 ||
-           strncmp(key, "device_type", 10) == 0 ||
-           strncmp(key, "serial_number", 13) == 0 ||
-           strncmp(key, "nazwa_klienta", 13) == 0 ||
-           strncmp(key, "pub_key_hash", 12) == 0;
+static void bbapi_rx_task(void* pv) {
+    while (s_rx_run) {
+        ws_rx_slot_t slot;
+        if (!ws_comm_rx_take(&slot, pdMS_TO_TICKS(100))) continue;
+
+        bbapi_msg_t m;
+        if (rx_parse(&slot, &m) && rx_dispatch(&m)) {
+            ws_comm_rx_release(&slot);
+            continue;
+        }
+        // tokenizer nie zmienia tekstu - kopia razem z '\0'
+        if (!bb_spsc_push(&s_app_rx, slot.buf, slot.len + 1)) {
+            BB_BLOGW(TAG, "App RX channel full, drop %u B", (unsigned)slot.len);
+        }
+        ws_comm_rx_release(&slot);
+    }
+    s_rx_task = NULL;
+    vTaskDelete(NULL);
+}
+
+static void on_link(bool up, void* ctx) {
+    uint8_t v = up;
+    bb_ota_link(up);
+    if (!bb_spsc_push(&s_app_link, &v, sizeof(v))) ESP_LOGW(TAG, "App link channel full, drop");
+}
+
+static esp_err_t rx_router_start(void) {
+    bb_spsc_init(&s_app_rx, s_app_rx_buf, sizeof(s_app_rx_buf));
+    s_app_ready = true;
+    s_rx_run = true;
+    if (xTaskCreate(bbapi_rx_task, "bbapi_rx", 4096, NULL, 5, &s_rx_task) != pdPASS) {
+        s_rx_run = false;
+        s_app_ready = false;
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+static void rx_router_stop(void) {
+    s_rx_run = false;
+    for (int i = 0; i < 50 && s_rx_task; ++i) vTaskDelay(pdMS_TO_TICKS(20));
+    s_app_ready = false;
+}
+
+// ===== ZDARZENIA APLIKACJI =====
+// Kolejność: link, komendy, RX - krótkie i pilne przed zwykłym ruchem
+static bool event_peek(bbapi_event_t* ev) {
+    size_t len;
+    const void* p = bb_spsc_peek(&s_app_link, &len);
+    if (p) {
+        ev->type = BBAPI_EVENT_LINK;
+        ev->link.up = *(const uint8_t*)p;
+        ev->rec = p;
+        return true;
+    }
+    bb_spsc_t* cmd = bbapi_cmd_app_channel();
+    if (cmd && (p = bb_spsc_peek(cmd, &len))) {
+        ev->type = BBAPI_EVENT_CMD;
+        bbapi_cmd_app_view(p, &ev->cmd);
+        ev->rec = p;
+        return true;
+    }
+    p = bb_spsc_peek(&s_app_rx, &len);
+    if (p) {
+        ev->type = BBAPI_EVENT_RX;
+        ev->rx.text = (const char*)p;
+        ev->rx.len = len - 1;
+        ev->rec = p;
+        return true;
+    }
+    return false;
+}
+
+bool BBAPI_event_wait(bbapi_event_t* ev, TickType_t to) {
+    if (!ev) return false;
+    ev->type = BBAPI_EVENT_NONE;
+    ev->rec = NULL;
+    if (!s_app_ready) return false;
+
+    // konsument ustawiony przed sprawdzeniem - commit w międzyczasie zostawi powiadomienie
+    TaskHandle_t me = xTaskGetCurrentTaskHandle();
+    bb_spsc_t* cmd = bbapi_cmd_app_channel();
+    bb_spsc_set_consumer(&s_app_rx, me);
+    bb_spsc_set_consumer(&s_app_link, me);
+    if (cmd) bb_spsc_set_consumer(cmd, me);
+
+    TickType_t start = xTaskGetTickCount();
+    while (!event_peek(ev)) {
+        TickType_t waited = xTaskGetTickCount() - start;
+        if (waited >= to) return false;
+        ulTaskNotifyTakeIndexed(BB_SPSC_NOTIFY_INDEX, pdTRUE, (to == portMAX_DELAY) ? portMAX_DELAY : to - waited);
+    }
+    return true;
+}
+
+void BBAPI_event_done(bbapi_event_t* ev) {
+    if (!ev || !ev->rec) return;
+    switch (ev->type) {
+        case BBAPI_EVENT_RX:    bb_spsc_pop(&s_app_rx); break;
+        case BBAPI_EVENT_LINK:  bb_spsc_pop(&s_app_link); break;
+        case BBAPI_EVENT_CMD: {
+            bb_spsc_t* cmd = bbapi_cmd_app_channel();
+            if (cmd) bb_spsc_pop(cmd);
+            break;
+        }
+        default: break;
+    }
+    ev->type = BBAPI_EVENT_NONE;
+    ev->rec = NULL;
+}
+
+esp_err_t BBAPI_cmd_reply(const bbapi_event_t* ev, esp_err_t result) {
+    if (!ev || ev->type != BBAPI_EVENT_CMD || !ev->rec) return ESP_ERR_INVALID_ARG;
+    return bbapi_cmd_app_reply(ev->rec, result);
+}
+
+esp_err_t BBAPI_register_rx_handler(const char* type, bbapi_rx_handler_t fn, void* ctx) {
+    if (!type || !fn) return ESP_ERR_INVALID_ARG;
+    if (strlen(type) >= sizeof(s_rx_handlers[0].type)) return ESP_ERR_INVALID_SIZE;
+
+    esp_err_t err = ESP_ERR_NO_MEM;
+    portENTER_CRITICAL(&s_rx_lock);
+    for (int i = 0; i < BBAPI_RX_MAX_HANDLERS; i++) {
+        if (!s_rx_handlers[i].fn) {
+            strcpy(s_rx_handlers[i].type, type);
+            s_rx_handlers[i].ctx = ctx;
+            s_rx_handlers[i].fn = fn;
+            err = ESP_OK;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_rx_lock);
+    return err;
+}
+
+esp_err_t BBAPI_unregister_rx_handler(bbapi_rx_handler_t fn, void* ctx) {
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+    portENTER_CRITICAL(&s_rx_lock);
+    for (int i = 0; i < BBAPI_RX_MAX_HANDLERS; i++) {
+        if (s_rx_handlers[i].fn == fn && s_rx_handlers[i].ctx == ctx) {
+            s_rx_handlers[i].fn = NULL;
+            err = ESP_OK;
+        }
+    }
+    portEXIT_CRITICAL(&s_rx_lock);
+    return err;
+}
+
+int BBAPI_msg_field(const bbapi_msg_t* msg, const char* key) {
+    if (!msg || !key) return -1;
+    return bb_jtok_obj_get(msg->js, msg->tok, msg->ntok, 0, key);
+}
+
+bool BBAPI_msg_get_int(const bbapi_msg_t* msg, const char* key, int32_t* out) {
+    int i = BBAPI_msg_field(msg, key);
+    return i > 0 && out && bb_jtok_int(msg->js, &msg->tok[i], out);
+}
+
+bool BBAPI_msg_get_str(const bbapi_msg_t* msg, const char* key, char* out, size_t outsize) {
+    int i = BBAPI_msg_field(msg, key);
+    return i > 0 && bb_jtok_str(msg->js, &msg->tok[i], out, outsize) >= 0;
 }
 
 esp_err_t BBAPI_init(const char* ws_uri) {
@@ -148,25 +629,99 @@ esp_err_t BBAPI_init(const char* ws_uri) {
     ESP_ERROR_CHECK(nvs_store_init());
     
     uint32_t init_flag = 0;
-    if (nvs_store_get_u32("bbapi_init_flag", &init_flag) != ESP_OK || init_flag == 0) 
+    if (nvs_store_get_u32(BBAPI_INIT_FLAG_KEY, &init_flag) != ESP_OK || init_flag == 0) 
     {
         init_default_params();
     }
+    else if (init_flag == BBAPI_INIT_FLAG_FACTORY)
+    {
+        // Fabryczny obraz NVS zawiera komplet parametrów - używamy go bez zmian
+        char sn[32] = {0};
+        BBAPI_get_param_by_id(BBAPI_PARAM_serial_number, sn, sizeof(sn) - 1, NULL);
+        ESP_LOGI(TAG, "Factory NVS image detected (SN %s), defaults skipped", sn);
+        s_params_initialized = true;
+    }
 
     if (s_initialized) return ESP_OK;
+
+    // watch przed odczytem: zmiana w trakcie cfg_build nie przepadnie
+    nvs_store_watch("*", on_param_changed, NULL);
+    if (cfg_build() != ESP_OK) {
+        nvs_store_unwatch(on_param_changed, NULL);
+        ESP_LOGW(TAG, "Config snapshot unavailable, params served from NVS");
+    }
+
+    // URI zapisany w NVS ma pierwszeństwo przed domyślnym
+    char stored_uri[128] = {0};
+    if (BBAPI_get_param_by_id(BBAPI_PARAM_ws_uri, stored_uri, sizeof(stored_uri), NULL) == ESP_OK && stored_uri[0]) {
+        ws_uri = stored_uri;
+    }
+
+#if CONFIG_BB_RLOG
+    // przed ws_comm_start, żeby złapać logi nawiązywania połączenia
+    if (bb_rlog_start() != ESP_OK) ESP_LOGW(TAG, "Remote log unavailable");
+#endif
+    if (bb_blog_start() != ESP_OK) ESP_LOGW(TAG, "Binary log formatter unavailable");
+
+    // kanał link gotowy przed pierwszym CONNECTED
+    bb_spsc_init(&s_app_link, s_app_link_buf, sizeof(s_app_link_buf));
+    ws_comm_set_link_cb(on_link, NULL);
     esp_err_t err = ws_comm_start(ws_uri);
-    if (err != ESP_OK) return err;
+    if (err == ESP_OK) {
+        err = rx_router_start();
+        if (err != ESP_OK) ws_comm_stop();
+    }
+    if (err != ESP_OK) {
+        ws_comm_set_link_cb(NULL, NULL);
+        return err;
+    }
+    if (bbapi_cmd_start() != ESP_OK) {
+        ESP_LOGW(TAG, "Command dispatcher unavailable");
+    }
+    if (bb_ts_start() != ESP_OK) {
+        ESP_LOGW(TAG, "Time-series reporter unavailable");
+    }
+    if (bb_health_start() != ESP_OK) {
+        ESP_LOGW(TAG, "Health reporter unavailable");
+    }
+    if (bb_ota_start() != ESP_OK) {
+        ESP_LOGW(TAG, "OTA receiver unavailable");
+    }
+
+    uint32_t val = 0;
+    if (BBAPI_get_param_by_id(BBAPI_PARAM_ws_hb_ms, &val, sizeof(val), NULL) == ESP_OK) ws_comm_set_heartbeat_ms(val);
+    if (BBAPI_get_param_by_id(BBAPI_PARAM_tx_rate_limit, &val, sizeof(val), NULL) == ESP_OK) set_tx_rate(val);
+    nvs_store_watch("ws_*", on_setting_changed, NULL);
+    nvs_store_watch(s_params[BBAPI_PARAM_tx_rate_limit].nvs_key, on_setting_changed, NULL);
     
-    xTaskCreate(fake_api_task, "fake_api_task", 8192, NULL, 5, NULL);
+#if CONFIG_BB_LOADGEN
+    bb_loadgen_init();
+#endif
     
     s_initialized = true;
-    ESP_LOGI(TAG, "BBAPI + FAKE_API started");
+    ESP_LOGI(TAG, "BBAPI started");
     return ESP_OK;
 }
 
 void BBAPI_deinit(void) {
     if (!s_initialized) return;
+    nvs_store_unwatch(on_setting_changed, NULL);
+    nvs_store_unwatch(on_param_changed, NULL);
+    s_cfg = NULL;
+#if CONFIG_BB_LOADGEN
+    bb_loadgen_stop();
+#endif
+    bb_ota_stop();
+    bb_health_stop();
+    bb_ts_stop();
+    bbapi_cmd_stop();
+    rx_router_stop();
     ws_comm_stop();
+    ws_comm_set_link_cb(NULL, NULL);
+    bb_blog_stop();
+#if CONFIG_BB_RLOG
+    bb_rlog_stop();
+#endif
     s_initialized = false;
     ESP_LOGI(TAG, "BBAPI deinit");
 }
@@ -176,15 +731,50 @@ bool BBAPI_is_ready(void) {
 }
 
 esp_err_t BBAPI_send_text(const char* text) {
-    return ws_comm_send_text(text);
+    return BBAPI_send_text_timeout(text, 0);
 }
 
 esp_err_t BBAPI_send_text_timeout(const char* text, TickType_t to) {
+    if (!tx_rate_allow()) return ESP_ERR_TIMEOUT;
     return ws_comm_send_text_timeout(text, to);
 }
 
+esp_err_t BBAPI_json_begin(bbapi_json_t* m, TickType_t to) {
+    if (!m) return ESP_ERR_INVALID_ARG;
+    if (!tx_rate_allow()) return ESP_ERR_TIMEOUT;
+    esp_err_t err = ws_comm_tx_reserve(&m->slot, to);
+    if (err != ESP_OK) return err;
+    bb_json_begin(&m->json, m->slot.buf, m->slot.cap);
+    return ESP_OK;
+}
+
+esp_err_t BBAPI_json_send(bbapi_json_t* m) {
+    if (!m) return ESP_ERR_INVALID_ARG;
+    size_t len;
+    esp_err_t err = bb_json_finish(&m->json, &len);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "JSON message dropped: %s", esp_err_to_name(err));
+        ws_comm_tx_cancel(&m->slot);
+        return err;
+    }
+    return ws_comm_tx_commit(&m->slot, len);
+}
+
+void BBAPI_json_cancel(bbapi_json_t* m) {
+    if (m) ws_comm_tx_cancel(&m->slot);
+}
+
 bool BBAPI_recv_text(char* out, size_t out_len, TickType_t to) {
-    return ws_comm_recv_text(out, out_len, to);
+    if (!out || out_len == 0 || !s_app_ready) return false;
+    if (!bb_spsc_wait(&s_app_rx, to)) return false;
+    size_t len;
+    const char* text = bb_spsc_peek(&s_app_rx, &len);
+    len--;
+    size_t cpy = (len < out_len - 1) ? len : (out_len - 1);
+    memcpy(out, text, cpy);
+    out[cpy] = 0;
+    bb_spsc_pop(&s_app_rx);
+    return true;
 }
 
 size_t BBAPI_tx_queued(void) {
@@ -192,18 +782,179 @@ size_t BBAPI_tx_queued(void) {
 }
 
 size_t BBAPI_rx_queued(void) {
-    return ws_comm_rx_queued();
+    return s_app_ready ? bb_spsc_count(&s_app_rx) : 0;
+}
+
+esp_err_t BBAPI_get_param_by_id(bbapi_param_id_t id, void* buffer, size_t bufsize, size_t* out_len) {
+    const bbapi_param_info_t* p = BBAPI_param_info(id);
+    if (!p) return ESP_ERR_NOT_SUPPORTED;
+    if (!buffer) return ESP_ERR_INVALID_ARG;
+    if (p->type == BBAPI_PARAM_TYPE_U32 && bufsize < sizeof(uint32_t)) return ESP_ERR_INVALID_SIZE;
+
+    if (s_cfg) return cfg_read(id, buffer, bufsize, out_len);
+
+    if (p->type == BBAPI_PARAM_TYPE_STR) {
+        return nvs_store_get_str(p->nvs_key, (char*)buffer, bufsize, out_len);
+    }
+    if (bufsize < sizeof(uint32_t)) return ESP_ERR_INVALID_SIZE;
+    esp_err_t err = nvs_store_get_u32(p->nvs_key, (uint32_t*)buffer);
+    if (out_len) *out_len = (err == ESP_OK) ? sizeof(uint32_t) : 0;
+    return err;
 }
 
 esp_err_t BBAPI_get_param(const char* key, void* buffer, size_t bufsize, size_t* out_len) {
-    if (!is_bootbone_param(key)) {
+    bbapi_param_id_t id;
+    if (BBAPI_param_lookup(key, &id) != ESP_OK) {
         return ESP_ERR_NOT_SUPPORTED; 
     }
-    
-    if (is_string_param(key)) {
-        return nvs_store_get_str(key, (char*)buffer, bufsize, out_len);
-    } else {
-        uint32_t* val = (uint32_t*)buffer;
-        return nvs_store_get_u32(key, val);
+    return BBAPI_get_param_by_id(id, buffer, bufsize, out_len);
+}
+
+esp_err_t BBAPI_get_params_by_id(const bbapi_param_id_t ids[], size_t n, bbapi_param_value_t out[]) {
+    if (!ids || !out || n == 0 || n > BBAPI_PARAM_COUNT) return ESP_ERR_INVALID_ARG;
+
+    if (s_cfg) {
+        // z migawki - zwykłe odczyty, bez workera NVS
+        esp_err_t ret = ESP_OK;
+        for (size_t i = 0; i < n; i++) {
+            const bbapi_param_info_t* p = BBAPI_param_info(ids[i]);
+            memset(&out[i], 0, sizeof(out[i]));
+            if (!p) {
+                out[i].err = ESP_ERR_NOT_SUPPORTED;
+            } else {
+                out[i].type = p->type;
+                out[i].err = cfg_read(ids[i], out[i].str, sizeof(out[i].str), &out[i].len);
+                if (out[i].err == ESP_OK && p->type == BBAPI_PARAM_TYPE_STR) out[i].len--;
+            }
+            if (ret == ESP_OK) ret = out[i].err;
+        }
+        return ret;
+    }
+
+    nvs_store_item_t items[BBAPI_PARAM_COUNT];
+    size_t m = 0;
+    for (size_t i = 0; i < n; i++) {
+        const bbapi_param_info_t* p = BBAPI_param_info(ids[i]);
+        memset(&out[i], 0, sizeof(out[i]));
+        if (!p) {
+            out[i].err = ESP_ERR_NOT_SUPPORTED;
+            continue;
+        }
+        out[i].type = p->type;
+        items[m++] = (nvs_store_item_t){
+            .key = p->nvs_key,
+            .type = (p->type == BBAPI_PARAM_TYPE_STR) ? NVS_TYPE_STR : NVS_TYPE_U32,
+            .buf = (p->type == BBAPI_PARAM_TYPE_STR) ? (void*)out[i].str : (void*)&out[i].u32,
+            .bufsize = (p->type == BBAPI_PARAM_TYPE_STR) ? sizeof(out[i].str) : sizeof(out[i].u32),
+        };
     }
+
+    if (m > 0 && nvs_store_get_many(items, m) == ESP_FAIL) return ESP_FAIL;
+
+    esp_err_t ret = ESP_OK;
+    for (size_t i = 0, j = 0; i < n; i++) {
+        if (out[i].err == ESP_OK) {
+            nvs_store_item_t* it = &items[j++];
+            out[i].err = it->err;
+            out[i].len = (it->err != ESP_OK) ? 0
+                       : (out[i].type == BBAPI_PARAM_TYPE_STR) ? it->out_len - 1 : sizeof(uint32_t);
+        }
+        if (ret == ESP_OK) ret = out[i].err;
+    }
+    return ret;
+}
+
+esp_err_t BBAPI_get_params(const char* const keys[], size_t n, bbapi_param_value_t out[]) {
+    if (!keys || !out || n == 0 || n > BBAPI_PARAM_COUNT) return ESP_ERR_INVALID_ARG;
+
+    bbapi_param_id_t ids[BBAPI_PARAM_COUNT];
+    for (size_t i = 0; i < n; i++) {
+        // nieznany klucz -> id poza zakresem -> ESP_ERR_NOT_SUPPORTED w out[i]
+        if (BBAPI_param_lookup(keys[i], &ids[i]) != ESP_OK) ids[i] = BBAPI_PARAM_COUNT;
+    }
+    return BBAPI_get_params_by_id(ids, n, out);
+}
+
+esp_err_t BBAPI_set_params(const char* const keys[], const bbapi_param_value_t values[], size_t n) {
+    if (!keys || !values || n == 0) return ESP_ERR_INVALID_ARG;
+
+    // walidacja całej grupy przed zapisem - albo wszystko, albo nic
+    for (size_t i = 0; i < n; i++) {
+        bbapi_param_id_t id;
+        if (BBAPI_param_lookup(keys[i], &id) != ESP_OK) return ESP_ERR_NOT_SUPPORTED;
+        const bbapi_param_info_t* p = &s_params[id];
+        if (p->access != BBAPI_PARAM_ACCESS_RW) return ESP_ERR_NOT_ALLOWED;
+        if (values[i].type != p->type) return ESP_ERR_INVALID_ARG;
+        if (p->type == BBAPI_PARAM_TYPE_STR && strnlen(values[i].str, sizeof(values[i].str)) > p->max_len) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+    }
+
+    nvs_txn_handle_t txn;
+    esp_err_t err = nvs_store_txn_begin(&txn);
+    if (err != ESP_OK) return err;
+    for (size_t i = 0; i < n && err == ESP_OK; i++) {
+        bbapi_param_id_t id;
+        BBAPI_param_lookup(keys[i], &id);
+        const bbapi_param_info_t* p = &s_params[id];
+        err = (p->type == BBAPI_PARAM_TYPE_STR) ? nvs_store_txn_set_str(txn, p->nvs_key, values[i].str)
+                                                : nvs_store_txn_set_u32(txn, p->nvs_key, values[i].u32);
+    }
+    if (err != ESP_OK) {
+        nvs_store_txn_abort(txn);
+        return err;
+    }
+    return nvs_store_txn_commit(txn);
+}
+
+// ===== TABLICA FUNKCJI DLA APLIKACJI =====
+_Static_assert(offsetof(bbapi_api_t, size) == 8, "bbapi_api_t header layout is ABI");
+
+static const bbapi_api_t s_api = {
+    .magic = BBAPI_API_MAGIC,
+    .major = BBAPI_API_MAJOR,
+    .minor = BBAPI_API_MINOR,
+    .size = sizeof(bbapi_api_t),
+
+    .is_ready = BBAPI_is_ready,
+    .send_text = BBAPI_send_text,
+    .send_text_timeout = BBAPI_send_text_timeout,
+    .recv_text = BBAPI_recv_text,
+    .tx_queued = BBAPI_tx_queued,
+    .rx_queued = BBAPI_rx_queued,
+
+    .get_param = BBAPI_get_param,
+    .get_param_by_id = BBAPI_get_param_by_id,
+    .param_lookup = BBAPI_param_lookup,
+    .param_info = BBAPI_param_info,
+    .get_params = BBAPI_get_params,
+    .get_params_by_id = BBAPI_get_params_by_id,
+    .set_params = BBAPI_set_params,
+    .config = BBAPI_config,
+    .config_copy = BBAPI_config_copy,
+
+    .json_begin = BBAPI_json_begin,
+    .json_send = BBAPI_json_send,
+    .json_cancel = BBAPI_json_cancel,
+
+    .register_rx_handler = BBAPI_register_rx_handler,
+    .unregister_rx_handler = BBAPI_unregister_rx_handler,
+    .msg_field = BBAPI_msg_field,
+    .msg_get_int = BBAPI_msg_get_int,
+    .msg_get_str = BBAPI_msg_get_str,
+
+    .register_cmd = BBAPI_register_cmd,
+    .cmd_stats = BBAPI_cmd_stats,
+
+    .event_wait = BBAPI_event_wait,
+    .event_done = BBAPI_event_done,
+    .cmd_reply = BBAPI_cmd_reply,
+
+    .ts_register = bb_ts_register,
+    .ts_add = bb_ts_add,
+    .ts_get_rollup = bb_ts_get_rollup,
+};
+
+const bbapi_api_t* BBAPI_get_api(void) {
+    return &s_api;
 }
@@ -0,0 +1,430 @@
+#include "bbapi.h"
+#include "bbapi_cmd.h"
+#include "bb_hash.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <string.h>
+
+#define TAG "BBAPI_CMD"
+
+#define BBAPI_CMD_HASH_SLOTS    32      // potęga 2, >= 2 * BBAPI_CMD_MAX
+#define BBAPI_CMD_WORKERS       2
+#define BBAPI_CMD_WORKER_STACK  4096
+#define BBAPI_CMD_QUEUE_LEN     8
+#define BBAPI_CMD_ID_MAX        31
+#define BBAPI_CMD_TS_MAX        23
+#define BBAPI_CMD_REPLY_TO_MS   1000
+#define BBAPI_CMD_APP_RING      1024    // ~3 oczekujące komendy aplikacji
+
+typedef struct {
+    char name[BBAPI_CMD_NAME_MAX + 1];
+    bbapi_cmd_handler_t handler;
+    const bbapi_arg_t* schema;
+    uint8_t nargs;
+    void* ctx;
+    // statystyki, pod s_cmd_lock
+    uint32_t count;
+    uint32_t errors;
+    uint64_t lat_sum_us;
+    uint32_t lat_max_us;
+    uint32_t wait_max_us;
+} cmd_entry_t;
+
+// Zadanie dla workera: kopia wszystkiego, co potrzebne po zwolnieniu slotu RX
+typedef struct {
+    uint8_t cmd;                        // indeks w s_cmds
+    bool id_is_str;
+    bool ts_is_str;
+    char id[BBAPI_CMD_ID_MAX + 1];
+    char ts[BBAPI_CMD_TS_MAX + 1];      // surowy tekst, echo w odpowiedzi
+    int64_t t_rx_us;
+    uint32_t present;
+    union {
+        int32_t i;
+        bool b;
+        uint16_t s_off;                 // STR: offset w arena
+    } args[BBAPI_CMD_MAX_ARGS];
+    char arena[BBAPI_CMD_STR_ARENA];
+} cmd_job_t;
+
+static cmd_entry_t s_cmds[BBAPI_CMD_MAX];
+static uint8_t s_ncmds = 0;
+static uint8_t s_cmd_slots[BBAPI_CMD_HASH_SLOTS];      // id + 1, 0 = pusty
+static portMUX_TYPE s_cmd_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static QueueHandle_t s_jobq = NULL;
+static bb_spsc_t s_app_cmd;             // producent: router RX, konsument: aplikacja
+static uint32_t s_app_cmd_buf[BBAPI_CMD_APP_RING / 4];
+static volatile bool s_cmd_run = false;
+static volatile int s_workers = 0;
+
+// ===== REJESTR =====
+// Wpisy tylko przybywają: indeks i pola poza statystykami są stałe po
+// rejestracji, więc po znalezieniu pod s_cmd_lock wolno ich używać bez niego
+static int cmd_lookup_locked(const char* name, size_t n) {
+    uint32_t i = bb_fnv1a_n(name, n) & (BBAPI_CMD_HASH_SLOTS - 1);
+    while (s_cmd_slots[i]) {
+        const cmd_entry_t* e = &s_cmds[s_cmd_slots[i] - 1];
+        if (strlen(e->name) == n && memcmp(e->name, name, n) == 0) return s_cmd_slots[i] - 1;
+        i = (i + 1) & (BBAPI_CMD_HASH_SLOTS - 1);
+    }
+    return -1;
+}
+
+static int cmd_lookup(const char* name, size_t n) {
+    portENTER_CRITICAL(&s_cmd_lock);
+    int cmd = cmd_lookup_locked(name, n);
+    portEXIT_CRITICAL(&s_cmd_lock);
+    return cmd;
+}
+
+esp_err_t BBAPI_register_cmd(const char* name, bbapi_cmd_handler_t handler, const bbapi_arg_t* arg_schema, void* ctx) {
+    if (!name) return ESP_ERR_INVALID_ARG;
+    size_t n = strlen(name);
+    if (n == 0 || n > BBAPI_CMD_NAME_MAX) return ESP_ERR_INVALID_SIZE;
+
+    uint8_t nargs = 0;
+    while (arg_schema && arg_schema[nargs].name) {
+        if (++nargs > BBAPI_CMD_MAX_ARGS) return ESP_ERR_INVALID_SIZE;
+    }
+
+    esp_err_t err = ESP_OK;
+    portENTER_CRITICAL(&s_cmd_lock);
+    if (cmd_lookup_locked(name, n) >= 0) {
+        err = ESP_ERR_INVALID_STATE;
+    } else if (s_ncmds >= BBAPI_CMD_MAX) {
+        err = ESP_ERR_NO_MEM;
+    } else {
+        cmd_entry_t* e = &s_cmds[s_ncmds];
+        memset(e, 0, sizeof(*e));
+        memcpy(e->name, name, n + 1);
+        e->handler = handler;
+        e->schema = arg_schema;
+        e->nargs = nargs;
+        e->ctx = ctx;
+
+        uint32_t i = bb_fnv1a_n(name, n) & (BBAPI_CMD_HASH_SLOTS - 1);
+        while (s_cmd_slots[i]) i = (i + 1) & (BBAPI_CMD_HASH_SLOTS - 1);
+        s_cmd_slots[i] = ++s_ncmds;
+    }
+    portEXIT_CRITICAL(&s_cmd_lock);
+    return err;
+}
+
+static void stats_update(int cmd, bool failed, int64_t wait_us, int64_t lat_us) {
+    portENTER_CRITICAL(&s_cmd_lock);
+    cmd_entry_t* e = &s_cmds[cmd];
+    e->count++;
+    if (failed) e->errors++;
+    e->lat_sum_us += (uint64_t)lat_us;
+    if (lat_us > e->lat_max_us) e->lat_max_us = (uint32_t)lat_us;
+    if (wait_us > e->wait_max_us) e->wait_max_us = (uint32_t)wait_us;
+    portEXIT_CRITICAL(&s_cmd_lock);
+}
+
+esp_err_t BBAPI_cmd_stats(const char* name, bbapi_cmd_stats_t* out) {
+    if (!name || !out) return ESP_ERR_INVALID_ARG;
+    int cmd = cmd_lookup(name, strlen(name));
+    if (cmd < 0) return ESP_ERR_NOT_FOUND;
+
+    portENTER_CRITICAL(&s_cmd_lock);
+    const cmd_entry_t* e = &s_cmds[cmd];
+    out->count = e->count;
+    out->errors = e->errors;
+    out->lat_avg_us = e->count ? (uint32_t)(e->lat_sum_us / e->count) : 0;
+    out->lat_max_us = e->lat_max_us;
+    out->wait_max_us = e->wait_max_us;
+    portEXIT_CRITICAL(&s_cmd_lock);
+    return ESP_OK;
+}
+
+// ===== ODPOWIEDZI =====
+static esp_err_t reply_begin(bbapi_json_t* m, const cmd_job_t* job, const char* name, const char* type, TickType_t to) {
+    esp_err_t err = BBAPI_json_begin(m, to);
+    if (err != ESP_OK) return err;
+    bb_json_obj(&m->json);
+    bb_json_key(&m->json, "v");     bb_json_int(&m->json, 1);
+    bb_json_key(&m->json, "type");  bb_json_str(&m->json, type);
+    if (job->id[0]) {
+        bb_json_key(&m->json, "id");
+        if (job->id_is_str) bb_json_str(&m->json, job->id);
+        else bb_json_raw(&m->json, job->id, strlen(job->id));
+    }
+    bb_json_key(&m->json, "cmd");   bb_json_str(&m->json, name);
+    if (job->ts[0]) {
+        bb_json_key(&m->json, "ts");
+        if (job->ts_is_str) bb_json_str(&m->json, job->ts);
+        else bb_json_raw(&m->json, job->ts, strlen(job->ts));
+    }
+    return ESP_OK;
+}
+
+static void reply_err(const cmd_job_t* job, const char* name, esp_err_t err, const char* msg, TickType_t to) {
+    bbapi_json_t m;
+    if (reply_begin(&m, job, name, "err", to) != ESP_OK) {
+        ESP_LOGW(TAG, "%s: no TX slot for error reply", name);
+        return;
+    }
+    bb_json_key(&m.json, "err");    bb_json_str(&m.json, esp_err_to_name(err));
+    if (msg) {
+        bb_json_key(&m.json, "msg");
+        bb_json_str(&m.json, msg);
+    }
+    bb_json_end(&m.json);
+    BBAPI_json_send(&m);
+}
+
+// ===== ODBIÓR (router RX, bez blokowania) =====
+// Napis rozwinięty z escape'ów (reply_begin escapuje go raz, bb_json_str),
+// liczba jako surowy tekst (bb_json_raw)
+static bool copy_raw(const bbapi_msg_t* m, const char* key, char* out, size_t outsize, bool* is_str) {
+    out[0] = '\0';
+    int i = BBAPI_msg_field(m, key);
+    if (i <= 0) return true;
+    const bb_jtok_t* t = &m->tok[i];
+    if (t->type == BB_JTOK_STR) {
+        *is_str = true;
+        return bb_jtok_str(m->js, t, out, outsize) >= 0;
+    }
+    if (t->type != BB_JTOK_PRIM) return false;
+    size_t n = t->end - t->start;
+    if (n >= outsize) return false;
+    memcpy(out, m->js + t->start, n);
+    out[n] = '\0';
+    *is_str = false;
+    return true;
+}
+
+// Walidacja wg schematu; przy błędzie zwraca nazwę argumentu do komunikatu
+static esp_err_t parse_args(const bbapi_msg_t* m, const cmd_entry_t* e, cmd_job_t* job, const char** bad) {
+    int i = BBAPI_msg_field(m, "args");
+    int obj = (i > 0 && m->tok[i].type == BB_JTOK_OBJ) ? i : 0;
+    size_t used = 0;
+
+    for (int k = 0; k < e->nargs; k++) {
+        const bbapi_arg_t* a = &e->schema[k];
+        *bad = a->name;
+        int t = bb_jtok_obj_get(m->js, m->tok, m->ntok, obj, a->name);
+        if (t < 0) {
+            if (a->required) return ESP_ERR_INVALID_ARG;
+            continue;
+        }
+
+        switch (a->type) {
+            case BBAPI_ARG_INT:
+                if (!bb_jtok_int(m->js, &m->tok[t], &job->args[k].i)) return ESP_ERR_INVALID_ARG;
+                if (a->min < a->max && (job->args[k].i < a->min || job->args[k].i > a->max)) return ESP_ERR_INVALID_ARG;
+                break;
+            case BBAPI_ARG_BOOL:
+                if (!bb_jtok_bool(m->js, &m->tok[t], &job->args[k].b)) return ESP_ERR_INVALID_ARG;
+                break;
+            case BBAPI_ARG_STR: {
+                size_t room = sizeof(job->arena) - used;
+                if (a->max > 0 && (size_t)a->max + 1 < room) room = (size_t)a->max + 1;
+                int n = bb_jtok_str(m->js, &m->tok[t], job->arena + used, room);
+                if (n < 0) return (m->tok[t].type == BB_JTOK_STR) ? ESP_ERR_INVALID_SIZE : ESP_ERR_INVALID_ARG;
+                job->args[k].s_off = (uint16_t)used;
+                used += (size_t)n + 1;
+                break;
+            }
+        }
+        job->present |= 1u << k;
+    }
+    *bad = NULL;
+    return ESP_OK;
+}
+
+static bool on_cmd_msg(const bbapi_msg_t* m, void* ctx) {
+    static cmd_job_t job;       // tylko router RX, za duży na jego stos
+    memset(&job, 0, sizeof(job));
+    job.t_rx_us = esp_timer_get_time();
+
+    if (!copy_raw(m, "id", job.id, sizeof(job.id), &job.id_is_str)) job.id[0] = '\0';
+    if (!copy_raw(m, "ts", job.ts, sizeof(job.ts), &job.ts_is_str)) job.ts[0] = '\0';
+
+    int i = BBAPI_msg_field(m, "name");
+    if (i <= 0 || m->tok[i].type != BB_JTOK_STR) {
+        reply_err(&job, "", ESP_ERR_INVALID_ARG, "name", 0);
+        return true;
+    }
+    int cmd = cmd_lookup(m->js + m->tok[i].start, m->tok[i].end - m->tok[i].start);
+    if (cmd < 0) {
+        char name[BBAPI_CMD_NAME_MAX + 1];
+        if (bb_jtok_str(m->js, &m->tok[i], name, sizeof(name)) < 0) strcpy(name, "?");
+        reply_err(&job, name, ESP_ERR_NOT_FOUND, "unknown command", 0);
+        return true;
+    }
+    job.cmd = (uint8_t)cmd;
+    const cmd_entry_t* e = &s_cmds[cmd];
+
+    const char* bad = NULL;
+    esp_err_t err = parse_args(m, e, &job, &bad);
+    if (err == ESP_OK) {
+        bool queued = e->handler ? (xQueueSend(s_jobq, &job, 0) == pdTRUE)
+                                 : bb_spsc_push(&s_app_cmd, &job, sizeof(job));
+        if (!queued) {
+            err = ESP_ERR_NO_MEM;
+            bad = "busy";
+        }
+    }
+    if (err != ESP_OK) {
+        reply_err(&job, e->name, err, bad, 0);
+        stats_update(cmd, true, 0, esp_timer_get_time() - job.t_rx_us);
+    }
+    return true;
+}
+
+static void job_to_cmd(const cmd_job_t* job, bbapi_cmd_t* cmd) {
+    const cmd_entry_t* e = &s_cmds[job->cmd];
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->name = e->name;
+    cmd->id = job->id;
+    cmd->present = job->present;
+    for (int k = 0; k < e->nargs; k++) {
+        if (e->schema[k].type == BBAPI_ARG_STR) {
+            cmd->args[k].s = (job->present & (1u << k)) ? job->arena + job->args[k].s_off : NULL;
+        } else if (e->schema[k].type == BBAPI_ARG_BOOL) {
+            cmd->args[k].b = job->args[k].b;
+        } else {
+            cmd->args[k].i = job->args[k].i;
+        }
+    }
+}
+
+// ===== WORKERY =====
+static void cmd_worker(void* pv) {
+    cmd_job_t job;
+
+    while (s_cmd_run) {
+        if (xQueueReceive(s_jobq, &job, pdMS_TO_TICKS(100)) != pdTRUE) continue;
+        int64_t t_start = esp_timer_get_time();
+        const cmd_entry_t* e = &s_cmds[job.cmd];
+
+        bbapi_cmd_t cmd;
+        job_to_cmd(&job, &cmd);
+
+        // Odpowiedź budowana w slocie TX; bez slotu handler pisze w pustkę
+        bbapi_json_t m;
+        bb_json_t sink;
+        bb_json_t* result = &sink;
+        bool have_reply = (reply_begin(&m, &job, e->name, "ack", pdMS_TO_TICKS(BBAPI_CMD_REPLY_TO_MS)) == ESP_OK);
+        if (have_reply) {
+            result = &m.json;
+            bb_json_key(result, "result");
+            bb_json_obj(result);
+        } else {
+            bb_json_begin(&sink, NULL, 0);
+        }
+
+        esp_err_t err = e->handler(&cmd, result, e->ctx);
+
+        if (have_reply && err == ESP_OK) {
+            bb_json_end(result);
+            bb_json_end(result);
+            err = BBAPI_json_send(&m);
+            if (err != ESP_OK) reply_err(&job, e->name, err, "result", pdMS_TO_TICKS(BBAPI_CMD_REPLY_TO_MS));
+        } else if (have_reply) {
+            BBAPI_json_cancel(&m);
+            reply_err(&job, e->name, err, NULL, pdMS_TO_TICKS(BBAPI_CMD_REPLY_TO_MS));
+        } else {
+            ESP_LOGW(TAG, "%s: no TX slot for reply", e->name);
+        }
+        stats_update(job.cmd, err != ESP_OK, t_start - job.t_rx_us, esp_timer_get_time() - job.t_rx_us);
+    }
+
+    portENTER_CRITICAL(&s_cmd_lock);
+    s_workers--;
+    portEXIT_CRITICAL(&s_cmd_lock);
+    vTaskDelete(NULL);
+}
+
+// ===== KOMENDY APLIKACJI =====
+bb_spsc_t* bbapi_cmd_app_channel(void) {
+    return s_jobq ? &s_app_cmd : NULL;
+}
+
+void bbapi_cmd_app_view(const void* rec, bbapi_cmd_t* out) {
+    job_to_cmd((const cmd_job_t*)rec, out);
+}
+
+esp_err_t bbapi_cmd_app_reply(const void* rec, esp_err_t result) {
+    const cmd_job_t* job = (const cmd_job_t*)rec;
+    const cmd_entry_t* e = &s_cmds[job->cmd];
+    esp_err_t err = result;
+
+    if (result == ESP_OK) {
+        bbapi_json_t m;
+        err = reply_begin(&m, job, e->name, "ack", pdMS_TO_TICKS(BBAPI_CMD_REPLY_TO_MS));
+        if (err == ESP_OK) {
+            bb_json_end(&m.json);
+            err = BBAPI_json_send(&m);
+        } else {
+            ESP_LOGW(TAG, "%s: no TX slot for reply", e->name);
+        }
+    } else {
+        reply_err(job, e->name, result, NULL, pdMS_TO_TICKS(BBAPI_CMD_REPLY_TO_MS));
+    }
+    stats_update(job->cmd, result != ESP_OK, 0, esp_timer_get_time() - job->t_rx_us);
+    return err;
+}
+
+// Wbudowana: statystyki wszystkich komend
+static esp_err_t cmd_stats_handler(const bbapi_cmd_t* cmd, bb_json_t* result, void* ctx) {
+    portENTER_CRITICAL(&s_cmd_lock);
+    int n = s_ncmds;
+    portEXIT_CRITICAL(&s_cmd_lock);
+    for (int i = 0; i < n; i++) {
+        bbapi_cmd_stats_t st;
+        if (BBAPI_cmd_stats(s_cmds[i].name, &st) != ESP_OK) continue;
+        bb_json_key(result, s_cmds[i].name);
+        bb_json_obj(result);
+        bb_json_key(result, "n");         bb_json_uint(result, st.count);
+        bb_json_key(result, "err");       bb_json_uint(result, st.errors);
+        bb_json_key(result, "avg_us");    bb_json_uint(result, st.lat_avg_us);
+        bb_json_key(result, "max_us");    bb_json_uint(result, st.lat_max_us);
+        bb_json_key(result, "wait_us");   bb_json_uint(result, st.wait_max_us);
+        bb_json_end(result);
+    }
+    return ESP_OK;
+}
+
+esp_err_t bbapi_cmd_start(void) {
+    if (s_jobq) return ESP_OK;
+    s_jobq = xQueueCreate(BBAPI_CMD_QUEUE_LEN, sizeof(cmd_job_t));
+    if (!s_jobq) return ESP_ERR_NO_MEM;
+    bb_spsc_init(&s_app_cmd, s_app_cmd_buf, sizeof(s_app_cmd_buf));
+
+    if (cmd_lookup("cmd_stats", strlen("cmd_stats")) < 0) {
+        BBAPI_register_cmd("cmd_stats", cmd_stats_handler, NULL, NULL);
+    }
+
+    s_cmd_run = true;
+    for (int i = 0; i < BBAPI_CMD_WORKERS; i++) {
+        if (xTaskCreate(cmd_worker, "bbapi_cmd", BBAPI_CMD_WORKER_STACK, NULL, 5, NULL) != pdPASS) {
+            ESP_LOGE(TAG, "worker %d create failed", i);
+            break;
+        }
+        portENTER_CRITICAL(&s_cmd_lock);
+        s_workers++;
+        portEXIT_CRITICAL(&s_cmd_lock);
+    }
+    if (s_workers == 0) {
+        s_cmd_run = false;
+        vQueueDelete(s_jobq);
+        s_jobq = NULL;
+        return ESP_FAIL;
+    }
+    return BBAPI_register_rx_handler("cmd", on_cmd_msg, NULL);
+}
+
+void bbapi_cmd_stop(void) {
+    if (!s_jobq) return;
+    BBAPI_unregister_rx_handler(on_cmd_msg, NULL);
+    s_cmd_run = false;
+    for (int i = 0; i < 50 && s_workers > 0; ++i) vTaskDelay(pdMS_TO_TICKS(20));
+    vQueueDelete(s_jobq);
+    s_jobq = NULL;
+}
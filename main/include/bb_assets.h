@@ -0,0 +1,56 @@
+#pragma once
+#include "esp_err.h"
+#include "esp_partition.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Zasoby portalu (logo.png i kolejne) jako paczka tylko do odczytu w jednym
+// z dwóch banków "storage" / "storage1" (partitions.csv), czytana przez
+// esp_partition_mmap - bez systemu plików, bez kopiowania, bez montowania.
+// Aktywny bank w NVS (jeden klucz): przełączenie jest atomowe, przerwany
+// zapis nie rusza aktywnego banku. Nową paczkę zapisuje bb_ota do
+// nieaktywnego banku, po weryfikacji SHA-256 wywołuje bb_assets_commit.
+//
+// Format paczki (LE, tools/gen_web_assets.py --bundle):
+//   nagłówek 32 B: "BBA1" | u32 version | u32 count | u32 size | u32 crc32 | 12 B 0
+//                  crc32 (jak zlib) z bajtów [32, size)
+//   katalog:       count wpisów BB_ASSETS_ENTRY_SIZE, posortowany po path (strcmp)
+//                  u32 offset | u32 len | u32 flags | u8 hash[8] | char type[28] | char path[48]
+//                  hash = początek SHA-256 danych (ETag), napisy zakończone 0
+//   dane:          od offset, wyrównane do 4 B
+
+#define BB_ASSETS_MAGIC         "BBA1"
+#define BB_ASSETS_HDR_SIZE      32
+#define BB_ASSETS_ENTRY_SIZE    96
+#define BB_ASSETS_F_GZIP        0x01        // dane to gzip -> Content-Encoding: gzip
+
+typedef struct {
+    const uint8_t* data;            // w zmapowanym flash
+    uint32_t len;
+    const char* type;               // MIME
+    bool gzip;
+    char etag[19];                  // "<16 hex>" z cudzysłowami
+} bb_asset_t;
+
+// Mapuje aktywny bank (albo drugi, jeśli aktywny nie ma poprawnej paczki)
+esp_err_t bb_assets_init(void);
+// Wyszukiwanie binarne po ścieżce; ESP_ERR_NOT_FOUND także bez paczki
+esp_err_t bb_assets_find(const char* path, bb_asset_t* out);
+const esp_partition_t* bb_assets_active(void);
+// Bank do zapisu nowej paczki
+const esp_partition_t* bb_assets_next(void);
+// Wersja aktywnej paczki, 0 = brak paczki
+uint32_t bb_assets_version(void);
+// part: zapisany bank; sprawdza paczkę (format, crc32, version), potem NVS
+esp_err_t bb_assets_commit(const esp_partition_t* part, uint32_t version);
+// Wysyłanie danych z bb_assets_find - bank nie zmieni się do unlock
+void bb_assets_lock(void);
+void bb_assets_unlock(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,12 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Mikrobenchmarki na urządzeniu (CONFIG_BB_BENCH): cykle CPU i zużycie stosu
+void bb_bench_run(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,106 @@
+#pragma once
+#include "esp_err.h"
+#include "esp_log.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Binarne logi odroczone: w miejscu wywołania zapisywany jest tylko adres
+// deskryptora (poziom, tag, format - stałe we flash) i surowe argumenty, bez
+// printf. Formatuje później task niskiego priorytetu (wynik idzie zwykłym
+// esp_log_write, więc też do bb_rlog) albo - w trybie "host" - serwer
+// narzędziem tools/blog_decode.py z pliku ELF tej samej kompilacji.
+//
+//   BB_BLOGI(TAG, "WS RX %u B: %s", (unsigned)len, text);
+//
+// Argumenty: liczby całkowite do 32 bitów, long long, double, napisy (char*,
+// kopiowane, do BB_BLOG_STR_MAX znaków). Najwyżej BB_BLOG_MAX_ARGS.
+// TAG musi być stałą (literał albo static const char TAG[]).
+
+#define BB_BLOG_MAX_ARGS    6
+#define BB_BLOG_STR_MAX     32
+#define BB_BLOG_REC_MAX     96      // nagłówek 12 B + argumenty
+
+// Typy argumentów, po 2 bity na argument w polu types rekordu
+#define BB_BLOG_T_U32       0
+#define BB_BLOG_T_U64       1
+#define BB_BLOG_T_DBL       2
+#define BB_BLOG_T_STR       3
+
+typedef struct {
+    uint8_t level;
+    const char* tag;
+    const char* fmt;
+} bb_blog_desc_t;
+
+typedef enum {
+    BB_BLOG_MODE_TEXT,              // formatowanie na urządzeniu
+    BB_BLOG_MODE_HOST,              // surowe rekordy do serwera (hex), dekodowanie z ELF
+} bb_blog_mode_t;
+
+typedef struct {
+    uint32_t written;
+    uint32_t dropped;               // pełny ring - odrzucany najnowszy rekord
+    uint32_t formatted;
+    uint32_t sent;                  // rekordy wysłane w trybie host
+    uint32_t ring_used;
+} bb_blog_stats_t;
+
+extern volatile uint8_t bb_blog_level;     // rekordy powyżej poziomu są pomijane w miejscu wywołania
+
+void bb_blog_write(const bb_blog_desc_t* d, uint8_t argc, uint16_t types, ...);
+// Sam zapis rekordu do bufora (bez ringu) - dla bb_bench; zwraca długość albo 0
+size_t bb_blog_encode(uint8_t* out, size_t outsize, const bb_blog_desc_t* d, uint8_t argc, uint16_t types, ...);
+
+void bb_blog_set_mode(bb_blog_mode_t mode);
+void bb_blog_get_stats(bb_blog_stats_t* out);
+
+// Wewnętrzne - wywoływane przez BBAPI_init / BBAPI_deinit
+esp_err_t bb_blog_start(void);
+void bb_blog_stop(void);
+
+// ===== MAKRA =====
+#define BB_BLOG_T(x) _Generic((x),                      \
+        char*: BB_BLOG_T_STR, const char*: BB_BLOG_T_STR, \
+        float: BB_BLOG_T_DBL, double: BB_BLOG_T_DBL,      \
+        long long: BB_BLOG_T_U64, unsigned long long: BB_BLOG_T_U64, \
+        default: BB_BLOG_T_U32)
+
+#define BB_BLOG_NARG(...)   BB_BLOG_NARG_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define BB_BLOG_NARG_(_0, _1, _2, _3, _4, _5, _6, n, ...) n
+
+#define BB_BLOG_TYPES_0()                   0
+#define BB_BLOG_TYPES_1(a)                  (BB_BLOG_T(a))
+#define BB_BLOG_TYPES_2(a, b)               (BB_BLOG_TYPES_1(a) | BB_BLOG_T(b) << 2)
+#define BB_BLOG_TYPES_3(a, b, c)            (BB_BLOG_TYPES_2(a, b) | BB_BLOG_T(c) << 4)
+#define BB_BLOG_TYPES_4(a, b, c, d)         (BB_BLOG_TYPES_3(a, b, c) | BB_BLOG_T(d) << 6)
+#define BB_BLOG_TYPES_5(a, b, c, d, e)      (BB_BLOG_TYPES_4(a, b, c, d) | BB_BLOG_T(e) << 8)
+#define BB_BLOG_TYPES_6(a, b, c, d, e, f)   (BB_BLOG_TYPES_5(a, b, c, d, e) | BB_BLOG_T(f) << 10)
+#define BB_BLOG_CAT(a, b)   BB_BLOG_CAT_(a, b)
+#define BB_BLOG_CAT_(a, b)  a##b
+#define BB_BLOG_TYPES(...)  BB_BLOG_CAT(BB_BLOG_TYPES_, BB_BLOG_NARG(__VA_ARGS__))(__VA_ARGS__)
+
+// Deskryptor statyczny: jego adres jest identyfikatorem formatu w rekordzie
+#define BB_BLOG_DESC(name, lvl_, tag_, fmt_) \
+    static const bb_blog_desc_t name = { .level = (lvl_), .tag = (tag_), .fmt = (fmt_) }
+
+#define BB_BLOG(lvl, tag, fmt, ...) do {                                            \
+        BB_BLOG_DESC(_bb_blog_desc, lvl, tag, fmt);                                 \
+        if ((lvl) <= bb_blog_level) {                                               \
+            bb_blog_write(&_bb_blog_desc, BB_BLOG_NARG(__VA_ARGS__),                \
+                          (uint16_t)(BB_BLOG_TYPES(__VA_ARGS__)), ##__VA_ARGS__);   \
+        }                                                                           \
+    } while (0)
+
+#define BB_BLOGE(tag, fmt, ...) BB_BLOG(ESP_LOG_ERROR, tag, fmt, ##__VA_ARGS__)
+#define BB_BLOGW(tag, fmt, ...) BB_BLOG(ESP_LOG_WARN, tag, fmt, ##__VA_ARGS__)
+#define BB_BLOGI(tag, fmt, ...) BB_BLOG(ESP_LOG_INFO, tag, fmt, ##__VA_ARGS__)
+#define BB_BLOGD(tag, fmt, ...) BB_BLOG(ESP_LOG_DEBUG, tag, fmt, ##__VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
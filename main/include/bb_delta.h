@@ -0,0 +1,40 @@
+#pragma once
+#include "esp_err.h"
+#include "esp_partition.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Dekoder łatek delta OTA (tools/bbdelta.py): nowy obraz powstaje z obrazu
+// w działającym slocie i strumienia łatki, bez buforowania żadnego z nich.
+// Format (LE, długości jako varint LEB128):
+//   nagłówek "BBD1" | u32 old_size | u32 new_size | old_sha256[32]
+//   0x00 COPY n        nowy += stary[pos..pos+n], pos += n
+//   0x01 ADD  n, d[n]  nowy += stary[pos+i] + d[i], pos += n
+//   0x02 DATA n, d[n]  nowy += d
+//   0x03 SEEK z        pos += zigzag(z)
+//   0x04 END
+// old_sha256 sprawdzany z flash po odebraniu nagłówka, zanim cokolwiek
+// trafi do slotu. Pamięć: stan dekodera i bufor BB_DELTA_BUF_SIZE.
+
+#define BB_DELTA_MAGIC          "BBD1"
+#define BB_DELTA_HDR_SIZE       44
+#define BB_DELTA_BUF_SIZE       512
+
+// Odbiorca zdekodowanych bajtów nowego obrazu (kolejno, kawałkami)
+typedef esp_err_t (*bb_delta_out_t)(const uint8_t* data, size_t len);
+
+// base: slot z obrazem bazowym; new_size musi się zgadzać z nagłówkiem łatki
+esp_err_t bb_delta_begin(const esp_partition_t* base, uint32_t new_size, bb_delta_out_t out);
+// Kolejne bajty łatki; błąd formatu, bazy albo odbiorcy kończy dekodowanie
+esp_err_t bb_delta_feed(const uint8_t* data, size_t len);
+// Łatka zakończona END i wyprodukowano dokładnie new_size bajtów
+bool bb_delta_done(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,30 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// FNV-1a: hasz kluczy dla małych tablic z adresowaniem otwartym (rejestry BBAPI)
+static inline uint32_t bb_fnv1a_n(const char* s, size_t n) {
+    uint32_t h = 2166136261u;
+    while (n--) {
+        h ^= (uint8_t)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static inline uint32_t bb_fnv1a(const char* s) {
+    uint32_t h = 2166136261u;
+    while (*s) {
+        h ^= (uint8_t)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+#ifdef __cplusplus
+}
+#endif
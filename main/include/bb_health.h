@@ -0,0 +1,63 @@
+#pragma once
+#include "esp_err.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Raport zdrowia urządzenia: sterta, fragmentacja, zapas stosu i udział CPU
+// każdego taska, liczniki połączenia WebSocket. Wysyłany co interval_s jako
+// ramka binarna (little-endian): bb_health_hdr_t i ntasks x bb_health_task_t.
+// Interwał ustawia serwer:
+//   {"type":"cmd","name":"health_cfg","args":{"interval":300}}   (0 = wyłączony)
+//   {"type":"cmd","name":"health_cfg","args":{"now":true}}       (raport od razu)
+// Udział CPU wymaga CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS, lista tasków
+// CONFIG_FREERTOS_USE_TRACE_FACILITY (oba w sdkconfig.defaults).
+
+#define BB_HEALTH_MAGIC         0xBB
+#define BB_HEALTH_TYPE          0x01
+#define BB_HEALTH_VERSION       1
+#define BB_HEALTH_MAX_TASKS     20      // w raporcie; ntotal mówi ile jest w systemie
+#define BB_HEALTH_NAME_LEN      16      // bez '\0' gdy nazwa ma 16 znaków
+#define BB_HEALTH_CPU_UNKNOWN   0xFFFF
+
+typedef struct __attribute__((packed)) {
+    uint8_t magic;
+    uint8_t type;
+    uint8_t version;
+    uint8_t ntasks;
+    uint8_t ntotal;
+    uint8_t reset_reason;           // esp_reset_reason_t
+    uint16_t interval_s;
+    uint32_t uptime_s;
+    uint32_t heap_free;
+    uint32_t heap_min;              // minimum od startu
+    uint32_t heap_largest;          // największy wolny blok - fragmentacja
+    uint16_t cpu_load;              // promile od poprzedniego raportu (bez IDLE)
+    uint16_t reserved;
+    uint32_t ws_connects;
+    uint32_t ws_disconnects;
+    uint32_t ws_rx_timeouts;
+    uint32_t ws_rx_drop;
+    uint32_t ws_tx_fail;
+} bb_health_hdr_t;
+
+typedef struct __attribute__((packed)) {
+    char name[BB_HEALTH_NAME_LEN];
+    uint16_t stack_free;            // minimalny zapas stosu od startu taska [B]
+    uint16_t cpu;                   // promile od poprzedniego raportu
+    uint8_t prio;
+    uint8_t state;                  // eTaskState
+} bb_health_task_t;
+
+esp_err_t bb_health_set_interval(uint32_t seconds);
+esp_err_t bb_health_send_now(void);
+
+// Wewnętrzne - wywoływane przez BBAPI_init / BBAPI_deinit
+esp_err_t bb_health_start(void);
+void bb_health_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
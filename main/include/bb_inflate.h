@@ -0,0 +1,31 @@
+#pragma once
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Strumieniowa dekompresja zlib (tinfl z ROM) dla OTA: wejście kawałkami,
+// wynik kolejno do odbiorcy, bez bufora na całość. Okno słownika
+// BB_INFLATE_DICT_SIZE zamiast 32 KB - nadawca kompresuje z wbits <= 12
+// (tools/ota_server.py --zlib), większe okno z nagłówka zlib jest odrzucane.
+// Dekompresor i słownik (~15 KB) zajęte tylko od begin do end.
+
+#define BB_INFLATE_DICT_SIZE    4096    // potęga 2, = 1 << wbits nadawcy
+
+typedef esp_err_t (*bb_inflate_out_t)(const uint8_t* data, size_t len);
+
+esp_err_t bb_inflate_begin(bb_inflate_out_t out);
+// Kolejne bajty strumienia; dane po końcu strumienia są błędem
+esp_err_t bb_inflate_feed(const uint8_t* data, size_t len);
+// Strumień zakończony, suma adler32 zgodna
+bool bb_inflate_done(void);
+uint32_t bb_inflate_total_out(void);
+void bb_inflate_end(void);
+
+#ifdef __cplusplus
+}
+#endif
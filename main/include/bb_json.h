@@ -0,0 +1,60 @@
+#pragma once
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Strumieniowy zapis JSON do bufora wywołującego (zwykle slot TX ws_comm):
+// bez alokacji, bez printf. Przepełnienie jest "lepkie" - kolejne wywołania
+// nic nie piszą, a bb_json_finish zwraca ESP_ERR_INVALID_SIZE.
+//
+//   bb_json_t j;
+//   bb_json_begin(&j, buf, sizeof(buf));
+//   bb_json_obj(&j);
+//   bb_json_key(&j, "type"); bb_json_str(&j, "hello");
+//   bb_json_key(&j, "seq");  bb_json_int(&j, seq);
+//   bb_json_end(&j);
+//   err = bb_json_finish(&j, &len);
+
+#define BB_JSON_MAX_DEPTH 8
+
+typedef struct {
+    char* buf;
+    size_t cap;                 // bez miejsca na '\0'
+    size_t len;
+    uint8_t depth;
+    uint8_t need_comma;         // bit d = na poziomie d był już element
+    uint8_t arrays;             // bit d = poziom d to tablica
+    bool after_key;
+    bool overflow;
+    bool invalid;               // niezbalansowane obj/end, wartość bez klucza
+} bb_json_t;
+
+void bb_json_begin(bb_json_t* j, char* buf, size_t bufsize);
+void bb_json_obj(bb_json_t* j);
+void bb_json_arr(bb_json_t* j);
+void bb_json_end(bb_json_t* j);                     // zamyka ostatni obj/arr
+void bb_json_key(bb_json_t* j, const char* key);
+void bb_json_str(bb_json_t* j, const char* s);      // z escapowaniem, NULL -> null
+void bb_json_strn(bb_json_t* j, const char* s, size_t n);
+void bb_json_int(bb_json_t* j, int32_t v);
+void bb_json_uint(bb_json_t* j, uint32_t v);
+void bb_json_dec(bb_json_t* j, int32_t v, uint8_t decimals);   // 235, 1 -> 23.5
+void bb_json_bool(bb_json_t* j, bool v);
+void bb_json_null(bb_json_t* j);
+void bb_json_raw(bb_json_t* j, const char* s, size_t n);     // gotowy fragment JSON, bez walidacji
+
+// Kończy dokument i dopisuje '\0'. ESP_ERR_INVALID_SIZE przy przepełnieniu,
+// ESP_ERR_INVALID_STATE gdy struktura jest niezamknięta lub niepoprawna.
+esp_err_t bb_json_finish(bb_json_t* j, size_t* out_len);
+
+// Dziesiętny zapis bez printf, zwraca liczbę znaków (bez '\0'); out >= 11 B
+size_t bb_json_utoa(uint32_t v, char* out);
+
+#ifdef __cplusplus
+}
+#endif
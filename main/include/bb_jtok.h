@@ -0,0 +1,56 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Tokenizer JSON w miejscu (styl jsmn): jeden przebieg po tekście, wynik to
+// tablica tokenów z offsetami do oryginalnego bufora - bez kopiowania i alokacji.
+//
+// Układ jak w jsmn: dzieci obiektu to klucze (STR, size = 1), wartość jest
+// dzieckiem klucza. Token na indeksie 0 to korzeń dokumentu.
+
+typedef enum {
+    BB_JTOK_UNDEF = 0,
+    BB_JTOK_OBJ,
+    BB_JTOK_ARR,
+    BB_JTOK_STR,                // start/end bez cudzysłowów, escape'y nierozwinięte
+    BB_JTOK_PRIM,               // liczba, true, false, null
+} bb_jtok_type_t;
+
+typedef struct {
+    uint8_t  type;
+    uint16_t start;
+    uint16_t end;               // za ostatnim znakiem
+    uint16_t size;              // liczba dzieci
+    int16_t  parent;            // -1 = korzeń
+} bb_jtok_t;
+
+#define BB_JTOK_ERR_NOMEM  (-1)     // za mało tokenów
+#define BB_JTOK_ERR_INVAL  (-2)     // niepoprawny JSON
+#define BB_JTOK_ERR_PART   (-3)     // niekompletny JSON
+#define BB_JTOK_MAX_LEN    0xFFFE   // offsety są 16-bitowe
+
+// Zwraca liczbę tokenów albo BB_JTOK_ERR_*
+int bb_jtok_parse(const char* js, size_t len, bb_jtok_t* tok, unsigned ntok);
+
+// Indeks pierwszego tokenu za poddrzewem i (następny brat)
+int bb_jtok_skip(const bb_jtok_t* tok, int ntok, int i);
+
+// Indeks wartości pod kluczem w obiekcie obj, -1 gdy brak
+int bb_jtok_obj_get(const char* js, const bb_jtok_t* tok, int ntok, int obj, const char* key);
+
+bool bb_jtok_eq(const char* js, const bb_jtok_t* t, const char* s);    // dokładne porównanie surowego tekstu
+bool bb_jtok_int(const char* js, const bb_jtok_t* t, int32_t* out);
+bool bb_jtok_bool(const char* js, const bb_jtok_t* t, bool* out);
+
+// Kopia napisu z rozwinięciem escape'ów (\uXXXX -> UTF-8). Zwraca długość
+// bez '\0' albo -1 gdy token nie jest napisem lub się nie mieści.
+int bb_jtok_str(const char* js, const bb_jtok_t* t, char* out, size_t outsize);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Syntetyczne obciążenie łącza BBAPI do testów pojemności (CONFIG_BB_LOADGEN).
+// Sterowanie z Kconfig albo komendą serwera:
+//   {"type":"cmd","name":"loadgen","args":{"action":"start","rate":50,"size_max":400}}
+
+typedef struct {
+    uint32_t rate;              // wiadomości/s w trybie ciągłym, 0 = tylko paczki
+    uint16_t burst_len;         // dodatkowa paczka wiadomości wysyłanych jedna za drugą
+    uint32_t burst_period_ms;
+    uint16_t size_min;          // rozmiar wiadomości losowany z [size_min, size_max]
+    uint16_t size_max;
+    uint8_t mix_telemetry;      // wagi rodzajów wiadomości
+    uint8_t mix_event;
+    uint8_t mix_text;
+    uint32_t duration_s;        // 0 = do zatrzymania
+    uint32_t report_ms;
+} bb_loadgen_cfg_t;
+
+typedef struct {
+    bool running;
+    uint32_t elapsed_ms;
+    uint32_t sent;
+    uint32_t dropped;           // brak slotu TX / limit tx_rate_limit / przepełnienie
+    uint64_t bytes;
+    uint32_t rate_x10;          // osiągnięte wiadomości/s * 10
+    uint32_t lat_avg_us;        // oczekiwanie na slot + budowa + commit
+    uint32_t lat_max_us;
+    uint32_t txq_max;           // największa zajętość kolejki TX ws_comm
+} bb_loadgen_stats_t;
+
+void bb_loadgen_default_cfg(bb_loadgen_cfg_t* cfg);     // wartości z Kconfig
+// ESP_ERR_INVALID_STATE: poprzedni task jeszcze działa (stop nie zdążył)
+esp_err_t bb_loadgen_start(const bb_loadgen_cfg_t* cfg);
+// Czeka na koniec taska; ESP_ERR_TIMEOUT, jeśli wciąż działa
+esp_err_t bb_loadgen_stop(void);
+void bb_loadgen_get_stats(bb_loadgen_stats_t* out);
+
+// Rejestruje komendę "loadgen" i startuje z Kconfig przy CONFIG_BB_LOADGEN_AUTOSTART
+esp_err_t bb_loadgen_init(void);
+
+#ifdef __cplusplus
+}
+#endif
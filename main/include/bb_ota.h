@@ -0,0 +1,118 @@
+#pragma once
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// OTA aplikacji strumieniem przez WebSocket: obraz idzie prosto do nieaktywnego
+// slotu (esp_ota_write), bez buforowania całości. Dwa bufory BB_OTA_BUF_SIZE:
+// jeden się zapełnia z sieci, drugi w tym czasie zapisuje task "bb_ota".
+// SHA-256 liczony w locie z zapisywanych danych.
+//
+//   serwer: {"type":"cmd","name":"ota_begin","id":"1","args":{"size":1234567,"sha256":"<64 hex>","reboot":true}}
+//   BB:     {"v":1,"type":"ack","id":"1","cmd":"ota_begin","result":{"part":"app1","offset":0,"chunk":4096,"window":8192}}
+//   serwer: ramki binarne [u8 'O'][u8 0][u16 0][u32 offset LE][dane], kolejno,
+//           nie więcej niż "window" bajtów bez potwierdzenia
+//   BB:     {"v":1,"type":"ota_ack","off":8192}                 (zapisane we flash)
+//   BB:     {"v":1,"type":"ota_done","ok":true,"bytes":..,"image":..,"resumed":..,"decode_ms":..,
+//            "ms":..,"kBps":..,"heap_min":..}
+//           "err":"<esp_err>" tylko przy ok false; bytes = przetworzone bajty przesyłane, image = bajty
+//           obrazu w slocie, resumed = offset wznowienia, kBps = bytes / ms w KiB/s
+// Zwykły ruch (komendy, telemetria) idzie dalej slotami tekstowymi ws_comm.
+// ota_abort przerywa, ota_status zwraca postęp.
+//
+// Wznawianie: offset zapisanych danych trafia do NVS co 64 KB i przy zerwaniu
+// (cisza 30 s, utrata łącza). ota_begin z tym samym sha256 i rozmiarem wznawia
+// zapis slotu od tego offsetu (wielokrotność BB_OTA_BUF_SIZE = sektor flash)
+// i zwraca go w "offset"; SHA-256 części już zapisanej liczony z flash.
+// Po ponownym połączeniu BB sam zgłasza przerwaną sesję:
+//   BB:     {"v":1,"type":"ota_resume","sha256":"..","size":..,"off":65536}
+//
+// Kodowanie (ramki, offsety i ota_ack liczą wtedy bajty przesyłane, a "size"
+// i "sha256" dotyczą nowego obrazu; takich sesji się nie wznawia):
+//   "delta":<rozmiar łatki>  łatka bb_delta.h względem działającego slotu
+//   "zlib":<bajty zlib>      strumień zlib z oknem <= 4 KB (bb_inflate.h),
+//                            z "delta" skompresowana jest łatka
+// ota_done podaje "decode_ms" - czas dekodowania razem z zapisem wyniku.
+//
+// Zasoby portalu: "target":"assets","version":N - paczka bb_assets.h trafia
+// do nieaktywnego banku (kodowanie jak wyżej, łatka względem aktywnego
+// banku). Po zgodnym sha256 i sprawdzeniu paczki (version z nagłówka = N)
+// bank przełączany w NVS, bez restartu. N większe od bieżącej, bez wznawiania.
+
+#define BB_OTA_BUF_SIZE         4096
+#define BB_OTA_FRAME_MAGIC      'O'
+#define BB_OTA_FRAME_DATA       0
+#define BB_OTA_FRAME_HDR        8
+
+typedef enum {
+    BB_OTA_IDLE,
+    BB_OTA_RECV,
+    BB_OTA_DONE,                    // obraz zweryfikowany, ustawiony do startu
+    BB_OTA_FAILED,
+} bb_ota_state_t;
+
+typedef enum {
+    BB_OTA_TARGET_APP,
+    BB_OTA_TARGET_ASSETS,
+} bb_ota_target_t;
+
+typedef struct {
+    bb_ota_state_t state;
+    bb_ota_target_t target;
+    esp_err_t err;                  // przyczyna FAILED
+    uint32_t size;                  // przesyłane bajty (obraz albo łatka)
+    uint32_t received;              // przyjęte do buforów
+    uint32_t written;               // przetworzone (zapisane albo zdekodowane)
+    uint32_t image_size;            // obraz w slocie; = size bez łatki
+    uint32_t image_written;         // zapisane we flash i policzone w SHA
+    uint32_t resumed;               // offset wznowienia, 0 = od początku
+    uint32_t ms;                    // od begin (do końca po DONE/FAILED)
+    uint32_t heap_min;              // najmniej wolnej sterty w trakcie
+} bb_ota_status_t;
+
+#define BB_OTA_ENC_DELTA        0x01
+#define BB_OTA_ENC_ZLIB         0x02
+
+// Źródło danych: WS wysyła ota_ack/ota_done, inne tylko stan
+typedef enum {
+    BB_OTA_SRC_WS,
+    BB_OTA_SRC_LOCAL,
+} bb_ota_src_t;
+
+// offset: NULL = zawsze od początku, inaczej wznowienie przerwanej sesji tego
+// obrazu; zwraca offset, od którego trzeba podawać dane. sha256 NULL (tylko
+// bez offsetu): obraz sprawdza wyłącznie esp_ota_end - suma i SHA-256
+// dołączony przez build do pliku .bin
+esp_err_t bb_ota_begin(uint32_t size, const uint8_t sha256[32], bb_ota_src_t src, bool reboot, uint32_t* offset);
+// Jak bb_ota_begin, ale feed podaje in_size bajtów zakodowanych BB_OTA_ENC_*
+esp_err_t bb_ota_begin_enc(uint32_t size, const uint8_t sha256[32], uint32_t in_size, uint8_t enc,
+                           bb_ota_src_t src, bool reboot);
+// Paczka zasobów do nieaktywnego banku; sha256 wymagany, enc jak wyżej
+esp_err_t bb_ota_begin_assets(uint32_t size, const uint8_t sha256[32], uint32_t in_size, uint8_t enc,
+                              uint32_t version, bb_ota_src_t src);
+// Kolejne bajty obrazu od offsetu received; czeka na wolny bufor najwyżej to
+esp_err_t bb_ota_feed(uint32_t offset, const void* data, size_t len, TickType_t to);
+// Czeka na zapis i weryfikację całego obrazu (po ostatnim feed)
+esp_err_t bb_ota_wait(TickType_t to);
+// Przerywa sesję i kasuje postęp wznawiania w NVS
+void bb_ota_abort(void);
+void bb_ota_get_status(bb_ota_status_t* out);
+const char* bb_ota_state_name(bb_ota_state_t state);   // "idle", "recv", "done", "failed"
+// Dokładnie 64 znaki hex -> 32 B
+bool bb_ota_sha256_from_hex(const char* hex, uint8_t out[32]);
+
+// Wewnętrzne - wywoływane przez BBAPI_init / BBAPI_deinit
+esp_err_t bb_ota_start(void);
+// Zamyka sesję jako przerwaną (jak utrata łącza) - postęp zostaje do wznowienia
+void bb_ota_stop(void);
+// Stan łącza WS z ws_comm: utrata przerywa sesję WS z zachowaniem postępu
+void bb_ota_link(bool up);
+
+#ifdef __cplusplus
+}
+#endif
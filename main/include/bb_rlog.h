@@ -0,0 +1,50 @@
+#pragma once
+#include "esp_err.h"
+#include "esp_log.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Zdalne logi (CONFIG_BB_RLOG): hook esp_log_set_vprintf kopiuje linie logów
+// (UART dalej działa) do ringu w RAM. Logowanie nigdy nie czeka - pełny ring
+// wyrzuca najstarsze linie i liczy je w dropped. Task niskiego priorytetu wysyła
+// paczki klasą niską ws_comm, z limitem bajtów/s:
+//   {"v":1,"type":"log","drop":3,"l":["W (1234) WS_COMM: WS disconnected",...]}
+// Sterowanie komendą serwera:
+//   {"type":"cmd","name":"log_cfg","args":{"level":"D","tag":"WS_COMM","rate":2048}}
+// Filtry poziomów są niezależne od esp_log_level_set (dotyczą tylko strumienia).
+
+// Dłuższe linie są obcinane. Bufor tej wielkości ląduje na stosie każdego
+// taska, który loguje (bb_rlog.c, capture)
+#define BB_RLOG_LINE_MAX        128
+#define BB_RLOG_MAX_FILTERS     8
+#define BB_RLOG_TAG_MAX         15
+
+typedef struct {
+    bool enabled;
+    uint32_t rate;              // limit B/s treści linii, 0 = bez limitu
+    uint32_t captured;          // linie przyjęte do ringu
+    uint32_t filtered;          // odrzucone przez filtr poziomu
+    uint32_t dropped;           // wyrzucone z pełnego ringu
+    uint32_t truncated;         // wysłane obcięte: po escapowaniu większe niż slot TX
+    uint32_t sent;              // linie wysłane
+    uint32_t bytes;
+    uint32_t ring_used;
+} bb_rlog_stats_t;
+
+// tag "*" = poziom domyślny dla tagów bez własnego filtra
+esp_err_t bb_rlog_set_level(const char* tag, esp_log_level_t level);
+void bb_rlog_set_rate(uint32_t bytes_per_s);
+void bb_rlog_enable(bool on);
+void bb_rlog_get_stats(bb_rlog_stats_t* out);
+
+// Wewnętrzne - wywoływane przez BBAPI_init / BBAPI_deinit
+esp_err_t bb_rlog_start(void);
+void bb_rlog_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
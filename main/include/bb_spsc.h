@@ -0,0 +1,63 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Kanał SPSC bez blokad: jeden producent, jeden konsument, rekordy zmiennej
+// długości w ciągłej pamięci (odczyt bez kopiowania). Producent nigdy nie
+// czeka - gdy brak miejsca, rekord jest odrzucany i liczony w dropped.
+// Konsument czeka na indeksowanym powiadomieniu taska (BB_SPSC_NOTIFY_INDEX),
+// więc nie koliduje z xTaskNotifyGive (indeks 0) ani z nvs_store (indeks 2).
+
+#define BB_SPSC_NOTIFY_INDEX 1
+
+#if configTASK_NOTIFICATION_ARRAY_ENTRIES <= BB_SPSC_NOTIFY_INDEX
+#error "bb_spsc needs CONFIG_FREERTOS_TASK_NOTIFICATION_ARRAY_ENTRIES >= 2"
+#endif
+
+typedef struct {
+    uint8_t* buf;
+    uint32_t size;                  // potęga 2
+    volatile uint32_t head;         // pisze tylko producent (offset rosnący bez modulo)
+    volatile uint32_t tail;         // pisze tylko konsument
+    TaskHandle_t volatile consumer; // budzony po commit, NULL = bez powiadomień
+    // liczniki - każdy ma jednego piszącego
+    volatile uint32_t pushed;
+    volatile uint32_t popped;
+    volatile uint32_t dropped;
+    // stan bieżącej rezerwacji / odczytu
+    uint32_t wr_need;
+    uint32_t rd_need;
+} bb_spsc_t;
+
+// size: potęga 2, bufor wyrównany do 4
+bool bb_spsc_init(bb_spsc_t* r, void* buf, size_t size);
+
+// Producent
+void* bb_spsc_reserve(bb_spsc_t* r, size_t len);    // NULL = brak miejsca (liczone w dropped)
+void bb_spsc_commit(bb_spsc_t* r);
+bool bb_spsc_push(bb_spsc_t* r, const void* data, size_t len);
+
+// Konsument
+const void* bb_spsc_peek(bb_spsc_t* r, size_t* len);   // NULL = pusto; ważne do pop
+void bb_spsc_pop(bb_spsc_t* r);
+void bb_spsc_set_consumer(bb_spsc_t* r, TaskHandle_t task);
+bool bb_spsc_wait(bb_spsc_t* r, TickType_t to);        // true = jest rekord
+
+static inline bool bb_spsc_empty(const bb_spsc_t* r) {
+    return r->head == r->tail;
+}
+
+static inline uint32_t bb_spsc_count(const bb_spsc_t* r) {
+    return r->pushed - r->popped;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Szeregi czasowe telemetrii: stała pamięć na metrykę - ring surowych próbek
+// i agregaty min/max/średnia/liczba w oknach 10 s, 1 min i 15 min (wyrównane
+// do czasu od startu). Aplikacja tylko dodaje próbki, o raporcie decyduje serwer:
+//   {"type":"cmd","name":"ts_cfg","args":{"metric":"temp","mode":"1m"}}
+// (metric "*" = wszystkie, bez argumentów - tylko lista metryk i trybów)
+// Raporty:
+//   {"v":1,"type":"ts","w":"1m","t":120000,"m":{"temp":[21.5,23.1,22.4,60]}}  [min,max,avg,n]
+//   {"v":1,"type":"ts_raw","m":"temp","s":[[120010,22.4],[121010,22.5]]}  [t_ms,v]
+// Próbki są całkowite ze stałym przecinkiem (224 przy decimals 1), w raportach
+// już jako liczby dziesiętne. t: ms od startu, modulo 2^32.
+
+#define BB_TS_MAX_METRICS   8
+#define BB_TS_NAME_MAX      15
+#define BB_TS_RAW_LEN       32      // surowe próbki na metrykę (potęga 2)
+
+typedef uint8_t bb_ts_id_t;
+
+typedef enum {
+    BB_TS_W10S,
+    BB_TS_W1M,
+    BB_TS_W15M,
+    BB_TS_WINDOWS,
+} bb_ts_window_t;
+
+typedef enum {
+    BB_TS_MODE_OFF,
+    BB_TS_MODE_RAW,                 // każda próbka, wysyłane paczkami
+    BB_TS_MODE_10S,                 // agregat po zamknięciu okna
+    BB_TS_MODE_1M,
+    BB_TS_MODE_15M,
+} bb_ts_mode_t;
+
+typedef struct {
+    uint32_t t_ms;                  // początek okna
+    uint32_t count;
+    int32_t min;
+    int32_t max;
+    int32_t mean;
+} bb_ts_rollup_t;
+
+typedef struct {
+    uint32_t t_ms;
+    int32_t v;
+} bb_ts_sample_t;
+
+// Rejestracja jest idempotentna - ta sama nazwa zwraca ten sam id
+esp_err_t bb_ts_register(const char* name, uint8_t decimals, bb_ts_mode_t mode, bb_ts_id_t* out);
+esp_err_t bb_ts_add(bb_ts_id_t id, int32_t v);
+esp_err_t bb_ts_set_mode(bb_ts_id_t id, bb_ts_mode_t mode);
+
+// Ostatnie zamknięte okno (ESP_ERR_NOT_FOUND gdy jeszcze żadnego) i okno bieżące
+esp_err_t bb_ts_get_rollup(bb_ts_id_t id, bb_ts_window_t w, bb_ts_rollup_t* last, bb_ts_rollup_t* cur);
+// Najnowsze surowe próbki, od najstarszej; zwraca liczbę skopiowanych
+size_t bb_ts_get_raw(bb_ts_id_t id, bb_ts_sample_t* out, size_t n);
+
+// Wewnętrzne - wywoływane przez BBAPI_init / BBAPI_deinit
+esp_err_t bb_ts_start(void);
+void bb_ts_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -3,6 +3,11 @@
 #include <stdbool.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include "bbapi_params.h"
+#include "bb_json.h"
+#include "bb_jtok.h"
+#include "bbapi_cmd.h"
+#include "ws_comm.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -14,10 +19,103 @@ bool BBAPI_is_ready(void);
 esp_err_t BBAPI_send_text(const char* text);
 esp_err_t BBAPI_send_text_timeout(const char* text, TickType_t to);
 bool BBAPI_recv_text(char* out, size_t out_len, TickType_t to);
+
+// Wiadomość JSON budowana bezpośrednio w slocie TX ws_comm:
+//   bbapi_json_t m;
+//   if (BBAPI_json_begin(&m, to) == ESP_OK) {
+//       bb_json_obj(&m.json); ... bb_json_end(&m.json);
+//       err = BBAPI_json_send(&m);     // ESP_ERR_INVALID_SIZE gdy się nie zmieściła
+//   }
+typedef struct {
+    bb_json_t json;
+    ws_tx_slot_t slot;
+} bbapi_json_t;
+
+esp_err_t BBAPI_json_begin(bbapi_json_t* m, TickType_t to);
+esp_err_t BBAPI_json_send(bbapi_json_t* m);
+void BBAPI_json_cancel(bbapi_json_t* m);
+
+// Wiadomość od serwera sparsowana raz przez router RX. Tekst i tokeny należą
+// do slotu RX - ważne tylko w czasie wywołania handlera.
+typedef struct {
+    const char* js;
+    size_t len;
+    const bb_jtok_t* tok;       // tok[0] = obiekt główny
+    int ntok;
+    int32_t v;                  // wersja protokołu, 0 gdy brak
+    const char* type;           // widok w js (bez '\0'), NULL gdy brak
+    size_t type_len;
+    const char* id;             // surowy tekst wartości id, NULL gdy brak
+    size_t id_len;
+} bbapi_msg_t;
+
+// Zwraca true, gdy wiadomość została obsłużona. Nieobsłużone (i nie-JSON)
+// trafiają do kanału RX aplikacji (BBAPI_event_wait / BBAPI_recv_text).
+typedef bool (*bbapi_rx_handler_t)(const bbapi_msg_t* msg, void* ctx);
+
+esp_err_t BBAPI_register_rx_handler(const char* type, bbapi_rx_handler_t fn, void* ctx);   // type "*" = wszystkie
+esp_err_t BBAPI_unregister_rx_handler(bbapi_rx_handler_t fn, void* ctx);
+
+int BBAPI_msg_field(const bbapi_msg_t* msg, const char* key);      // indeks tokenu wartości, -1 gdy brak
+bool BBAPI_msg_get_int(const bbapi_msg_t* msg, const char* key, int32_t* out);
+bool BBAPI_msg_get_str(const bbapi_msg_t* msg, const char* key, char* out, size_t outsize);
 size_t BBAPI_tx_queued(void);
 size_t BBAPI_rx_queued(void);
+
+// Zdarzenia dla aplikacji: kanały SPSC bez blokad (bb_spsc.h) - RX, zmiana
+// połączenia i komendy z handler == NULL. Odbiera je jeden task aplikacji
+// (ten sam, który woła BBAPI_recv_text). Dane zdarzenia leżą w kanale i są
+// ważne do BBAPI_event_done:
+//   bbapi_event_t ev;
+//   if (BBAPI_event_wait(&ev, to)) {
+//       ...
+//       BBAPI_event_done(&ev);
+//   }
+typedef enum {
+    BBAPI_EVENT_NONE,
+    BBAPI_EVENT_RX,             // nieobsłużona wiadomość serwera
+    BBAPI_EVENT_LINK,           // połączenie z serwerem nawiązane / zerwane
+    BBAPI_EVENT_CMD,            // komenda aplikacji, odpowiedź przez BBAPI_cmd_reply
+} bbapi_event_type_t;
+
+typedef struct {
+    bbapi_event_type_t type;
+    union {
+        struct {
+            const char* text;   // zakończony '\0'
+            size_t len;
+        } rx;
+        struct {
+            bool up;
+        } link;
+        bbapi_cmd_t cmd;
+    };
+    const void* rec;            // wewnętrzne
+} bbapi_event_t;
+
+bool BBAPI_event_wait(bbapi_event_t* ev, TickType_t to);       // false = timeout
+void BBAPI_event_done(bbapi_event_t* ev);
+esp_err_t BBAPI_cmd_reply(const bbapi_event_t* ev, esp_err_t result);  // ack lub err
 esp_err_t BBAPI_get_param(const char* key, void* buffer, size_t bufsize, size_t* out_len);
 
+// Rejestr parametrów (bbapi_params.h): id -> bez operacji na napisach
+esp_err_t BBAPI_get_param_by_id(bbapi_param_id_t id, void* buffer, size_t bufsize, size_t* out_len);
+esp_err_t BBAPI_param_lookup(const char* key, bbapi_param_id_t* out);
+const bbapi_param_info_t* BBAPI_param_info(bbapi_param_id_t id);
+
+// Operacje grupowe: jeden przebieg workera NVS / jedna transakcja.
+// Zwracają ESP_OK gdy wszystkie elementy się powiodły; status każdego w out[i].err.
+esp_err_t BBAPI_get_params(const char* const keys[], size_t n, bbapi_param_value_t out[]);
+esp_err_t BBAPI_get_params_by_id(const bbapi_param_id_t ids[], size_t n, bbapi_param_value_t out[]);
+esp_err_t BBAPI_set_params(const char* const keys[], const bbapi_param_value_t values[], size_t n);
+
+// Migawka konfiguracji tylko do odczytu (NULL przed BBAPI_init). Wskaźnik pozostaje
+// spójny do drugiej kolejnej publikacji; gdy to ważne, powtórz odczyt przy
+// nieparzystym seq albo innym po odczycie, albo użyj BBAPI_config_copy
+// (kopia z kontrolą seq i CRC).
+const bbapi_config_t* BBAPI_config(void);
+esp_err_t BBAPI_config_copy(bbapi_config_t* out);
+
 #ifdef __cplusplus
 }
 #endif
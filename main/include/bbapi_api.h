@@ -0,0 +1,93 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "bbapi.h"
+#include "bb_ts.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Stała tablica funkcji BBAPI dla aplikacji głównej. BootBone publikuje ją
+// w pamięci tylko do odczytu, aplikacja pobiera wskaźnik raz przy starcie
+// (pvParameters taska aplikacji) i woła funkcje pośrednio - bez symboli
+// BootBone w swoim obrazie, więc obie strony można aktualizować osobno.
+//
+// Zasady zgodności:
+//  - major: zmiana niekompatybilna (kolejność/sygnatury wpisów, układ struktur
+//    przekazywanych przez wskaźnik: bbapi_json_t, bb_json_t, bbapi_msg_t, ...)
+//  - minor: nowe wpisy wyłącznie na końcu struktury
+//  - aplikacja sprawdza BBAPI_API_HAS przed użyciem wpisu nowszego niż 1.0
+
+#define BBAPI_API_MAGIC     0x49504242u     // "BBPI"
+#define BBAPI_API_MAJOR     1
+#define BBAPI_API_MINOR     2
+
+typedef struct {
+    uint32_t magic;
+    uint16_t major;
+    uint16_t minor;
+    uint32_t size;              // sizeof(bbapi_api_t) po stronie BootBone
+
+    // ===== 1.0 =====
+    bool      (*is_ready)(void);
+    esp_err_t (*send_text)(const char* text);
+    esp_err_t (*send_text_timeout)(const char* text, TickType_t to);
+    bool      (*recv_text)(char* out, size_t out_len, TickType_t to);
+    size_t    (*tx_queued)(void);
+    size_t    (*rx_queued)(void);
+
+    esp_err_t (*get_param)(const char* key, void* buffer, size_t bufsize, size_t* out_len);
+    esp_err_t (*get_param_by_id)(bbapi_param_id_t id, void* buffer, size_t bufsize, size_t* out_len);
+    esp_err_t (*param_lookup)(const char* key, bbapi_param_id_t* out);
+    const bbapi_param_info_t* (*param_info)(bbapi_param_id_t id);
+    esp_err_t (*get_params)(const char* const keys[], size_t n, bbapi_param_value_t out[]);
+    esp_err_t (*get_params_by_id)(const bbapi_param_id_t ids[], size_t n, bbapi_param_value_t out[]);
+    esp_err_t (*set_params)(const char* const keys[], const bbapi_param_value_t values[], size_t n);
+    const bbapi_config_t* (*config)(void);
+    esp_err_t (*config_copy)(bbapi_config_t* out);
+
+    esp_err_t (*json_begin)(bbapi_json_t* m, TickType_t to);
+    esp_err_t (*json_send)(bbapi_json_t* m);
+    void      (*json_cancel)(bbapi_json_t* m);
+
+    esp_err_t (*register_rx_handler)(const char* type, bbapi_rx_handler_t fn, void* ctx);
+    esp_err_t (*unregister_rx_handler)(bbapi_rx_handler_t fn, void* ctx);
+    int       (*msg_field)(const bbapi_msg_t* msg, const char* key);
+    bool      (*msg_get_int)(const bbapi_msg_t* msg, const char* key, int32_t* out);
+    bool      (*msg_get_str)(const bbapi_msg_t* msg, const char* key, char* out, size_t outsize);
+
+    esp_err_t (*register_cmd)(const char* name, bbapi_cmd_handler_t handler, const bbapi_arg_t* arg_schema, void* ctx);
+    esp_err_t (*cmd_stats)(const char* name, bbapi_cmd_stats_t* out);
+
+    // ===== 1.1 =====
+    bool      (*event_wait)(bbapi_event_t* ev, TickType_t to);
+    void      (*event_done)(bbapi_event_t* ev);
+    esp_err_t (*cmd_reply)(const bbapi_event_t* ev, esp_err_t result);
+
+    // ===== 1.2 =====
+    esp_err_t (*ts_register)(const char* name, uint8_t decimals, bb_ts_mode_t mode, bb_ts_id_t* out);
+    esp_err_t (*ts_add)(bb_ts_id_t id, int32_t v);
+    esp_err_t (*ts_get_rollup)(bb_ts_id_t id, bb_ts_window_t w, bb_ts_rollup_t* last, bb_ts_rollup_t* cur);
+} bbapi_api_t;
+
+// Wpis dostępny w tablicy opublikowanej przez BootBone (może być starszy niż aplikacja)
+#define BBAPI_API_HAS(api, field) \
+    ((api)->size >= offsetof(bbapi_api_t, field) + sizeof(((bbapi_api_t*)0)->field) && (api)->field != NULL)
+
+const bbapi_api_t* BBAPI_get_api(void);
+
+// Sprawdzenie po stronie aplikacji: ta sama wersja major, minor >= wymaganego
+static inline esp_err_t bbapi_api_check(const bbapi_api_t* api, uint16_t need_minor) {
+    if (!api || api->magic != BBAPI_API_MAGIC) return ESP_ERR_INVALID_ARG;
+    if (api->major != BBAPI_API_MAJOR) return ESP_ERR_NOT_SUPPORTED;
+    // 1.0 = wszystkie wpisy do cmd_stats włącznie
+    if (api->minor < need_minor || api->size < offsetof(bbapi_api_t, cmd_stats) + sizeof(api->cmd_stats)) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+    return ESP_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,85 @@
+#pragma once
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include "bb_json.h"
+#include "bb_spsc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Komendy serwera:
+//   {"v":1,"type":"cmd","name":"set_led","id":"17","args":{"value":1}}
+// Argumenty mogą też leżeć bezpośrednio w obiekcie głównym. Odpowiedź wysyłana
+// automatycznie po wykonaniu handlera:
+//   {"v":1,"type":"ack","id":"17","cmd":"set_led","result":{...}}
+//   {"v":1,"type":"err","id":"17","cmd":"set_led","err":"ESP_ERR_INVALID_ARG","msg":"value"}
+// Pole "ts" z komendy (jeśli jest) wraca w odpowiedzi - serwer liczy z niego RTT.
+//
+// Komenda zarejestrowana z handler == NULL nie idzie do workerów, tylko kanałem
+// SPSC do aplikacji (BBAPI_event_wait, typ BBAPI_EVENT_CMD). Aplikacja odpowiada
+// przez BBAPI_cmd_reply przed BBAPI_event_done.
+
+#define BBAPI_CMD_MAX           16
+#define BBAPI_CMD_MAX_ARGS      8
+#define BBAPI_CMD_NAME_MAX      23
+#define BBAPI_CMD_STR_ARENA     160     // łącznie na argumenty STR jednej komendy
+
+typedef enum {
+    BBAPI_ARG_INT,
+    BBAPI_ARG_BOOL,
+    BBAPI_ARG_STR,
+} bbapi_arg_type_t;
+
+// Schemat argumentu. INT: zakres [min, max] gdy min < max. STR: max = maks. długość.
+// Tablica schematów kończy się wpisem z name == NULL.
+typedef struct {
+    const char* name;
+    bbapi_arg_type_t type;
+    bool required;
+    int32_t min;
+    int32_t max;
+} bbapi_arg_t;
+
+typedef union {
+    int32_t i;
+    bool b;
+    const char* s;
+} bbapi_arg_value_t;
+
+// Zwalidowana komenda - argumenty pozycyjnie wg schematu, bez szukania po nazwie
+typedef struct {
+    const char* name;
+    const char* id;                 // "" gdy brak
+    uint32_t present;               // bit i = args[i] podany w wiadomości
+    bbapi_arg_value_t args[BBAPI_CMD_MAX_ARGS];
+} bbapi_cmd_t;
+
+// result: obiekt "result" odpowiedzi, handler dopisuje pary klucz/wartość.
+// Zwrócenie błędu zamienia odpowiedź na "err".
+typedef esp_err_t (*bbapi_cmd_handler_t)(const bbapi_cmd_t* cmd, bb_json_t* result, void* ctx);
+
+typedef struct {
+    uint32_t count;
+    uint32_t errors;                // walidacja, błąd handlera, brak wolnego workera
+    uint32_t lat_avg_us;            // odbiór wiadomości -> odpowiedź w slocie TX
+    uint32_t lat_max_us;
+    uint32_t wait_max_us;           // najdłuższe oczekiwanie w kolejce workerów
+} bbapi_cmd_stats_t;
+
+esp_err_t BBAPI_register_cmd(const char* name, bbapi_cmd_handler_t handler, const bbapi_arg_t* arg_schema, void* ctx);
+esp_err_t BBAPI_cmd_stats(const char* name, bbapi_cmd_stats_t* out);
+
+// Wewnętrzne - wywoływane przez BBAPI_init / BBAPI_deinit
+esp_err_t bbapi_cmd_start(void);
+void bbapi_cmd_stop(void);
+
+// Wewnętrzne - kanał komend aplikacji, rekord ważny do bb_spsc_pop
+bb_spsc_t* bbapi_cmd_app_channel(void);
+void bbapi_cmd_app_view(const void* rec, bbapi_cmd_t* out);
+esp_err_t bbapi_cmd_app_reply(const void* rec, esp_err_t result);
+
+#ifdef __cplusplus
+}
+#endif
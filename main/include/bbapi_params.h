@@ -0,0 +1,93 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MAKE_VERSION(major, minor, patch, build) \
+    (((uint32_t)(major) << 24) | ((uint32_t)(minor) << 16) | ((uint32_t)(patch) << 8) | (uint32_t)(build))
+
+// Jedyne źródło prawdy o parametrach BootBone: klucz API, klucz NVS (max 15 znaków),
+// typ, wartość domyślna, maksymalna długość napisu i prawa dostępu aplikacji.
+//
+// X(name, nvs_key, type, def_str, def_u32, max_len, access)
+#define BBAPI_PARAMS(X) \
+    X(device_id,           "device_id",     STR, "ESP32C3-DEFAULT",     0,                       31, RO) \
+    X(hw_model,            "hw_model",      STR, "ESP32C3-DEV",         0,                       31, RO) \
+    X(device_type,         "device_type",   STR, "bootbone_controller", 0,                       31, RO) \
+    X(serial_number,       "serial_number", STR, "SN-00000000",         0,                       31, RO) \
+    X(nazwa_klienta,       "nazwa_klienta", STR, "Perplexity Labs",     0,                       63, RW) \
+    X(pub_key_hash,        "pub_key_hash",  STR, "0000000000000000000000000000000000000000000000000000000000000000", 0, 64, RO) \
+    X(hw_version,          "hw_version",    U32, "",                    MAKE_VERSION(1, 0, 0, 0), 0, RO) \
+    X(bootbone_fw_version, "bb_fw_ver",     U32, "",                    MAKE_VERSION(1, 0, 0, 0), 0, RO) \
+    X(mainapp_fw_version,  "app_fw_ver",    U32, "",                    0,                       0,  RW) \
+    X(ws_uri,              "ws_uri",        STR, "",                    0,                       127, RW) \
+    X(ws_hb_ms,            "ws_hb_ms",      U32, "",                    30000,                   0,  RW) \
+    X(tx_rate_limit,       "tx_rate_limit", U32, "",                    0,                       0,  RW)
+
+typedef enum {
+#define BBAPI_PARAM_ENUM(name, nvs_key, type, def_str, def_u32, max_len, access) BBAPI_PARAM_##name,
+    BBAPI_PARAMS(BBAPI_PARAM_ENUM)
+#undef BBAPI_PARAM_ENUM
+    BBAPI_PARAM_COUNT
+} bbapi_param_id_t;
+
+typedef enum {
+    BBAPI_PARAM_TYPE_STR,
+    BBAPI_PARAM_TYPE_U32
+} bbapi_param_type_t;
+
+typedef enum {
+    BBAPI_PARAM_ACCESS_RO,      // tylko odczyt dla aplikacji (tożsamość, wersje BootBone)
+    BBAPI_PARAM_ACCESS_RW
+} bbapi_param_access_t;
+
+#define BBAPI_PARAM_STR_MAX 127     // najdłuższy max_len w rejestrze
+
+// Wartość parametru dla operacji grupowych (BBAPI_get_params / BBAPI_set_params)
+typedef struct {
+    esp_err_t err;
+    bbapi_param_type_t type;
+    size_t len;                 // STR: bez '\0'
+    union {
+        uint32_t u32;
+        char str[BBAPI_PARAM_STR_MAX + 1];
+    };
+} bbapi_param_value_t;
+
+// Migawka wszystkich parametrów w RAM, budowana raz przy starcie i publikowana
+// ponownie po każdej zmianie w NVS. Odczyt pola to zwykły load, bez kolejek.
+#define BBAPI_CONFIG_MAGIC    0x43464242u   // "BBFC"
+#define BBAPI_CONFIG_VERSION  1
+
+#define BBAPI_CONFIG_FIELD_STR(name, max_len) char name[(max_len) + 1];
+#define BBAPI_CONFIG_FIELD_U32(name, max_len) uint32_t name;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;              // sizeof(bbapi_config_t) po stronie BootBone
+    uint32_t seq;               // parzysty po publikacji, nieparzysty w trakcie zmian bufora
+    uint32_t crc32;             // CRC32 od pola present do końca struktury
+    uint32_t present;           // bit id = parametr istnieje w NVS
+#define BBAPI_CONFIG_FIELD(name, nvs_key, type, def_str, def_u32, max_len, access) BBAPI_CONFIG_FIELD_##type(name, max_len)
+    BBAPI_PARAMS(BBAPI_CONFIG_FIELD)
+#undef BBAPI_CONFIG_FIELD
+} bbapi_config_t;
+
+typedef struct {
+    const char* key;
+    const char* nvs_key;
+    bbapi_param_type_t type;
+    bbapi_param_access_t access;
+    const char* def_str;
+    uint32_t def_u32;
+    uint16_t max_len;           // STR: bez '\0'
+} bbapi_param_info_t;
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,29 +1,89 @@
 #pragma once
 
 #include "esp_err.h"
+#include "nvs.h"
 #include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Odpowiedzi workera (GET, commit transakcji) przychodzą na własnym indeksie
+// powiadomień taska: obce xTaskNotifyGive (indeks 0) ich nie podrobi.
+#define NVS_STORE_NOTIFY_INDEX 2
+
+#if configTASK_NOTIFICATION_ARRAY_ENTRIES <= NVS_STORE_NOTIFY_INDEX
+#error "nvs_store needs CONFIG_FREERTOS_TASK_NOTIFICATION_ARRAY_ENTRIES >= 3"
+#endif
 
 typedef enum {
     NVS_CMD_SET_STR,
     NVS_CMD_SET_U32,
     NVS_CMD_GET_STR,
     NVS_CMD_GET_U32,
-    NVS_CMD_RESET
+    NVS_CMD_RESET,
+    NVS_CMD_TXN_COMMIT,
+    NVS_CMD_GET_MANY,
+    NVS_CMD_STOP
 } nvs_cmd_type_t;
 
+// Transakcja: grupa zapisów stosowana atomowo jednym commitem
+typedef struct nvs_txn* nvs_txn_handle_t;
+
+// Element odczytu grupowego (nvs_store_get_many)
+typedef struct {
+    const char* key;
+    nvs_type_t type;        // NVS_TYPE_STR albo NVS_TYPE_U32
+    void* buf;
+    size_t bufsize;
+    size_t out_len;         // wynik: długość z '\0' (STR) albo 4 (U32)
+    esp_err_t err;          // wynik dla tego klucza
+} nvs_store_item_t;
+
 typedef struct {
     nvs_cmd_type_t type;
     char key[32];
     union {
         char str_value[256];
         uint32_t u32_value;
+        nvs_txn_handle_t txn;
+        struct {
+            nvs_store_item_t* items;
+            size_t n;
+        } many;
     };
     size_t out_len;
+    TaskHandle_t waiter;    // GET: zadanie czekające na odpowiedź
+    void* reply;            // GET: nvs_cmd_t wywołującego
 } nvs_cmd_t;
 
+// Zdarzenia bez klucza: key = NULL, type = NVS_TYPE_ANY, value = const nvs_store_event_t*
+typedef enum {
+    NVS_STORE_EVENT_RESET,      // nvs_store_reset: wszystkie klucze skasowane
+    NVS_STORE_EVENT_COMMIT,     // koniec grupy: klucze jednego zapisu albo transakcji już podane
+} nvs_store_event_t;
+
+// Powiadomienie o zatwierdzonej zmianie. value: const char* dla NVS_TYPE_STR,
+// const uint32_t* dla NVS_TYPE_U32. Wołane z kontekstu workera NVS - callback
+// musi być krótki i nie może czekać na nvs_store_get_* (zakleszczenie).
+// Po kluczach jednego set_* albo transakcji obserwator, który dostał choć
+// jeden z nich, dostaje NVS_STORE_EVENT_COMMIT - dopiero wtedy grupa jest
+// kompletna. Po nvs_store_reset każdy obserwator dostaje NVS_STORE_EVENT_RESET.
+typedef void (*nvs_store_watch_cb_t)(const char* key, nvs_type_t type, const void* value, void* ctx);
+
 esp_err_t nvs_store_init(void);
+esp_err_t nvs_store_deinit(void);
 esp_err_t nvs_store_set_str(const char* key, const char* value);
 esp_err_t nvs_store_set_u32(const char* key, uint32_t value);
 esp_err_t nvs_store_get_str(const char* key, char* buffer, size_t bufsize, size_t* out_len);
 esp_err_t nvs_store_get_u32(const char* key, uint32_t* value);
 esp_err_t nvs_store_reset(void);
+esp_err_t nvs_store_get_many(nvs_store_item_t* items, size_t n);    // jeden przebieg workera
+
+esp_err_t nvs_store_txn_begin(nvs_txn_handle_t* out);
+esp_err_t nvs_store_txn_set_str(nvs_txn_handle_t txn, const char* key, const char* value);
+esp_err_t nvs_store_txn_set_u32(nvs_txn_handle_t txn, const char* key, uint32_t value);
+esp_err_t nvs_store_txn_commit(nvs_txn_handle_t txn);   // zwalnia txn niezależnie od wyniku
+void nvs_store_txn_abort(nvs_txn_handle_t txn);
+
+// key_or_prefix: dokładny klucz ("ws_uri") albo prefiks zakończony '*' ("ws_*")
+esp_err_t nvs_store_watch(const char* key_or_prefix, nvs_store_watch_cb_t cb, void* ctx);
+esp_err_t nvs_store_unwatch(nvs_store_watch_cb_t cb, void* ctx);
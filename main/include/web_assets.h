@@ -0,0 +1,29 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Strony portalu wbudowane w aplikację, generowane przy buildzie z main/web
+// (tools/gen_web_assets.py): skompresowane gzip, gdy to się opłaca, z mocnym
+// ETag. Tablica posortowana po uri (strcmp). Paczka bb_assets ma pierwszeństwo
+// poza HTML i trasami aplikacji.
+
+typedef struct {
+    const char* uri;
+    const char* type;               // MIME
+    const char* etag;               // z cudzysłowami, jak w nagłówku
+    const uint8_t* data;
+    uint32_t len;
+    bool gzip;                      // data to gzip -> Content-Encoding: gzip
+} web_asset_t;
+
+extern const web_asset_t web_assets[];
+extern const size_t web_assets_count;
+
+#ifdef __cplusplus
+}
+#endif
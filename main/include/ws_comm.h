@@ -1,6 +1,8 @@
 #pragma once
 #include "esp_err.h"
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 
@@ -12,11 +14,63 @@ esp_err_t ws_comm_start(const char* uri);
 void ws_comm_stop(void);                  
 bool ws_comm_is_connected(void);          
 
+typedef struct {
+    uint32_t connects;
+    uint32_t disconnects;
+    uint32_t errors;
+    uint32_t rx_timeouts;       // brak ruchu przez 2x heartbeat -> reconnect
+    uint32_t rx_drop;           // brak wolnego slotu RX
+    uint32_t rx_trunc;          // wiadomość tekstowa ponad 4 KB albo urwana, odrzucona
+    uint32_t tx_fail;
+} ws_comm_stats_t;
+
+void ws_comm_get_stats(ws_comm_stats_t* out);
+
+esp_err_t ws_comm_set_uri(const char* uri);           // rozłącza i łączy się z nowym URI
+esp_err_t ws_comm_set_heartbeat_ms(uint32_t ms);      // timeout RX = 2x heartbeat
+
+// Zmiana stanu połączenia, wołane z taska klienta websocket (nie blokować)
+typedef void (*ws_comm_link_cb_t)(bool up, void* ctx);
+void ws_comm_set_link_cb(ws_comm_link_cb_t cb, void* ctx);
+
+// Ramki binarne serwera, wołane z taska klienta websocket z danymi w jego buforze.
+// Ramka dłuższa niż bufor klienta przychodzi w kilku wywołaniach:
+// offset = pozycja części w ramce, total = długość całej ramki.
+typedef void (*ws_comm_bin_cb_t)(const uint8_t* data, size_t len, size_t offset, size_t total, void* ctx);
+void ws_comm_set_bin_cb(ws_comm_bin_cb_t cb, void* ctx);
+
 esp_err_t ws_comm_send_text(const char* text);                   
 esp_err_t ws_comm_send_text_timeout(const char* text, TickType_t to); 
 
+// Slot TX do budowania wiadomości w miejscu (bez kopiowania przez kolejkę).
+// Po reserve trzeba wywołać commit albo cancel.
+typedef struct {
+    char*   buf;
+    size_t  cap;                // rozmiar bufora
+    uint8_t idx;
+    uint8_t low;                // klasa niskiego priorytetu
+    uint8_t bin;                // ustawić przed commit: wysyłka jako ramka binarna
+} ws_tx_slot_t;
+
+esp_err_t ws_comm_tx_reserve(ws_tx_slot_t* slot, TickType_t to);    // ESP_ERR_TIMEOUT gdy brak wolnych slotów
+// Klasa niskiego priorytetu (logi, diagnostyka): bez czekania, tylko gdy zostaje
+// zapas wolnych slotów dla zwykłego ruchu; wysyłana, gdy zwykła kolejka jest pusta.
+esp_err_t ws_comm_tx_reserve_low(ws_tx_slot_t* slot);
+esp_err_t ws_comm_tx_commit(ws_tx_slot_t* slot, size_t len);
+void ws_comm_tx_cancel(ws_tx_slot_t* slot);
+
 bool ws_comm_recv_text(char* out, size_t out_len, TickType_t to); 
 
+// Odbiór bez kopiowania: wiadomość zakończona '\0' w slocie RX, ważna do release
+typedef struct {
+    char*   buf;                // modyfikowalny w miejscu do czasu release
+    size_t  len;
+    uint8_t idx;
+} ws_rx_slot_t;
+
+bool ws_comm_rx_take(ws_rx_slot_t* slot, TickType_t to);
+void ws_comm_rx_release(ws_rx_slot_t* slot);
+
 size_t ws_comm_tx_queued(void);            
 size_t ws_comm_rx_queued(void);           
 
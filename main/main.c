@@ -3,14 +3,18 @@
 #include "freertos/event_groups.h"
 #include "esp_log.h"
 #include "nvs_flash.h"
+#include <inttypes.h>
 #include "events.h"
 
 #include "nvs_store.h"
 #include "webserver.h"
+#include "bb_assets.h"
 #include "sta_comm.h"
 #include "ws_comm.h"
 #include "network_mgr.h"
 #include "bbapi.h"
+#include "bbapi_api.h"
+#include "bb_bench.h"
 
 #include "driver/gpio.h"
 #include "indicator.h"
@@ -23,10 +27,78 @@ EventGroupHandle_t bootbone_s;
 
 void wifi_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data);
 
+// Komenda serwera: {"type":"cmd","name":"set_led","args":{"value":0|1|2}}
+static const bbapi_arg_t s_set_led_args[] = {
+    { .name = "value", .type = BBAPI_ARG_INT, .required = true, .min = INDICATOR_OFF, .max = INDICATOR_BLINK },
+    { 0 }
+};
+
+static esp_err_t cmd_set_led(const bbapi_cmd_t* cmd, bb_json_t* result, void* ctx) {
+    Indicator_Control(&led, (Indicator_State_t)cmd->args[0].i);
+    bb_json_key(result, "value");
+    bb_json_int(result, cmd->args[0].i);
+    return ESP_OK;
+}
+
+// Aplikacja dostaje tablicę BBAPI w pvParameters i korzysta wyłącznie z niej
 void fake_main_app_task(void* pv) {
     ESP_LOGW("MAINAPP", "🚀 MainApp STUB - wgraj prawdziwą app!");
+
+    const bbapi_api_t* bb = (const bbapi_api_t*)pv;
+    esp_err_t err = bbapi_api_check(bb, 0);
+    if (err != ESP_OK) {
+        ESP_LOGE("MAINAPP", "BBAPI table rejected: %s", esp_err_to_name(err));
+        vTaskDelete(NULL);
+        return;
+    }
+    ESP_LOGI("MAINAPP", "BBAPI %u.%u (%u B table)", bb->major, bb->minor, (unsigned)bb->size);
+
+    // Konfiguracja startowa jednym wywołaniem zamiast osobnych BBAPI_get_param
+    static const bbapi_param_id_t ids[] = {
+        BBAPI_PARAM_device_id, BBAPI_PARAM_device_type, BBAPI_PARAM_serial_number,
+        BBAPI_PARAM_hw_version, BBAPI_PARAM_bootbone_fw_version,
+    };
+    bbapi_param_value_t vals[sizeof(ids) / sizeof(ids[0])];
+    bb->get_params_by_id(ids, sizeof(ids) / sizeof(ids[0]), vals);
+    ESP_LOGI("MAINAPP", "id=%s type=%s sn=%s hw=0x%08" PRIx32 " bb=0x%08" PRIx32,
+             vals[0].err == ESP_OK ? vals[0].str : "?",
+             vals[1].err == ESP_OK ? vals[1].str : "?",
+             vals[2].err == ESP_OK ? vals[2].str : "?",
+             vals[3].u32, vals[4].u32);
+
+    bb->register_cmd("set_led", cmd_set_led, s_set_led_args, NULL);
+
+    if (BBAPI_API_HAS(bb, cmd_reply)) {
+        // Komenda bez handlera - przychodzi jako zdarzenie do tego taska
+        bb->register_cmd("identify", NULL, NULL, NULL);
+
+        bbapi_event_t ev;
+        while(1) {
+            if (!bb->event_wait(&ev, pdMS_TO_TICKS(5000))) continue;
+            switch (ev.type) {
+                case BBAPI_EVENT_RX:
+                    ESP_LOGI("MAINAPP", "RX <- SERVER: %s", ev.rx.text);
+                    break;
+                case BBAPI_EVENT_LINK:
+                    ESP_LOGI("MAINAPP", "Server link %s", ev.link.up ? "up" : "down");
+                    break;
+                case BBAPI_EVENT_CMD:
+                    Indicator_Control(&led, INDICATOR_BLINK);
+                    bb->cmd_reply(&ev, ESP_OK);
+                    break;
+                default:
+                    break;
+            }
+            bb->event_done(&ev);
+        }
+    }
+
+    // BootBone 1.0: wiadomości serwera nieobsłużone przez komendy BBAPI
+    char buf[512];
     while(1) {
-        vTaskDelay(pdMS_TO_TICKS(5000));
+        if (bb->recv_text(buf, sizeof(buf), pdMS_TO_TICKS(5000))) {
+            ESP_LOGI("MAINAPP", "RX <- SERVER: %s", buf);
+        }
     }
 }
 
@@ -41,7 +113,7 @@ static void bootbone_task(void *pvParameters) {
     ESP_ERROR_CHECK(network_mgr_register_handlers(wifi_event_handler, NULL)); 
 
     bootbone_s = xEventGroupCreate();
-    mount_spiffs();                                                        
+    bb_assets_init();                                                      // paczka zasobów portalu, bez niej tylko strony wbudowane
 
     ESP_ERROR_CHECK(webserver_start());                                   
 
@@ -107,7 +179,7 @@ static void bootbone_task(void *pvParameters) {
                 }
                 
                 ESP_LOGI(TAG, "=== BBAPI READY - STARTING MAINAPP TASK (prio=6) ===");
-                xTaskCreate(fake_main_app_task, "main_app", 12288, NULL, 6, NULL);
+                xTaskCreate(fake_main_app_task, "main_app", 12288, (void*)BBAPI_get_api(), 6, NULL);
                 mainapp_started = true;
                 
                 ESP_LOGI(TAG, "BootBone task ENDING - handover complete!");
@@ -122,6 +194,9 @@ static void bootbone_task(void *pvParameters) {
 void app_main(void) {       
     Indicator_Init(&led, GPIO_NUM_6);
     Indicator_Control(&led, INDICATOR_BLINK);
+#if CONFIG_BB_BENCH
+    bb_bench_run();
+#endif
     vTaskDelay(pdMS_TO_TICKS(2000));
 
     xTaskCreate(bootbone_task, "bootbone_task", 8192, NULL, 5, NULL);
@@ -6,25 +6,292 @@
 #include "freertos/task.h"
 #include "freertos/queue.h"
 
-#include "esp_task_wdt.h"
 #include "esp_log.h"
 #include <string.h>
+#include <stdlib.h>
 #include <inttypes.h>
 
+// Target linux (tools/nvs_bench) nie ma Task WDT
+#if CONFIG_ESP_TASK_WDT_EN
+#include "esp_task_wdt.h"
+#define NVS_WDT_ADD()      esp_task_wdt_add(NULL)
+#define NVS_WDT_RESET()    esp_task_wdt_reset()
+#define NVS_WDT_DELETE()   esp_task_wdt_delete(NULL)
+#else
+#define NVS_WDT_ADD()
+#define NVS_WDT_RESET()
+#define NVS_WDT_DELETE()
+#endif
+
 #define NVS_NAMESPACE "boneboot"
 #define TAG "NVS_STORE"
 
+// Journal transakcji trzymany w osobnej przestrzeni nazw. Pojedynczy zapis
+// bloba jest w NVS atomowy, więc obecność "journal" = transakcja zatwierdzona.
+// Koszt: blob (indeks + nagłówek + dane po 32 B) i kasowanie, dlatego do
+// journala idą tylko klucze zmieniające wartość, a transakcja z jedną
+// zmianą jest zwykłym zapisem (koszt: tools/nvs_bench/README.md, pomiar
+// w tools/host_test).
+#define NVS_TXN_NAMESPACE  "bb_txn"
+#define NVS_TXN_KEY        "journal"
+#define NVS_TXN_MAGIC      0x4A544242u   // "BBTJ"
+#define NVS_TXN_MAX_BYTES  1024
+#define NVS_KEY_MAX_LEN    15            // NVS_KEY_NAME_MAX_SIZE - 1
+#define NVS_STR_MAX_LEN    255
+
+#define NVS_STORE_MAX_WATCHERS 8
+
+struct nvs_txn {
+    size_t len;
+    uint16_t n_ops;
+    TaskHandle_t waiter;
+    esp_err_t result;
+    uint8_t buf[NVS_TXN_MAX_BYTES];      // nagłówek + rekordy [typ][len klucza][klucz][len wartości][wartość]
+};
+
+typedef struct {
+    uint32_t magic;
+    uint16_t n_ops;
+    uint16_t len;
+} nvs_txn_hdr_t;
+
+typedef struct {
+    char pattern[NVS_KEY_MAX_LEN + 2];   // klucz albo prefiks z '*'
+    nvs_store_watch_cb_t cb;
+    void* ctx;
+} nvs_watcher_t;
+
 static nvs_handle_t s_nvs_handle = 0;
+static nvs_handle_t s_txn_handle = 0;
 static QueueHandle_t s_nvs_queue = NULL;
 static TaskHandle_t s_nvs_task = NULL;
 
+static nvs_watcher_t s_watchers[NVS_STORE_MAX_WATCHERS];
+static portMUX_TYPE s_watch_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Obserwatorzy powiadomieni w bieżącej grupie (tylko worker)
+static nvs_watcher_t s_group[NVS_STORE_MAX_WATCHERS];
+static int s_group_n = 0;
+
+static bool watch_match(const char* pattern, const char* key)
+{
+    size_t plen = strlen(pattern);
+    if (plen > 0 && pattern[plen - 1] == '*') {
+        return strncmp(pattern, key, plen - 1) == 0;
+    }
+    return strcmp(pattern, key) == 0;
+}
+
+// Wołane przez workera po udanym zapisie
+static void notify_watchers(const char* key, nvs_type_t type, const void* value)
+{
+    nvs_watcher_t hits[NVS_STORE_MAX_WATCHERS];
+    int n = 0;
+
+    portENTER_CRITICAL(&s_watch_lock);
+    for (int i = 0; i < NVS_STORE_MAX_WATCHERS; i++) {
+        if (s_watchers[i].cb && watch_match(s_watchers[i].pattern, key)) {
+            hits[n++] = s_watchers[i];
+        }
+    }
+    portEXIT_CRITICAL(&s_watch_lock);
+
+    for (int i = 0; i < n; i++) {
+        hits[i].cb(key, type, value, hits[i].ctx);
+
+        int g = 0;
+        while (g < s_group_n && (s_group[g].cb != hits[i].cb || s_group[g].ctx != hits[i].ctx)) g++;
+        if (g == s_group_n) s_group[s_group_n++] = hits[i];
+    }
+}
+
+// Koniec grupy: NVS_STORE_EVENT_COMMIT do tych, którzy dostali jej klucze
+static void notify_watchers_commit(void)
+{
+    static const nvs_store_event_t ev = NVS_STORE_EVENT_COMMIT;
+    int n = s_group_n;
+    s_group_n = 0;
+    for (int i = 0; i < n; i++) {
+        s_group[i].cb(NULL, NVS_TYPE_ANY, &ev, s_group[i].ctx);
+    }
+}
+
+// Po nvs_store_reset: każdy obserwator raz, niezależnie od wzorca
+static void notify_watchers_reset(void)
+{
+    static const nvs_store_event_t ev = NVS_STORE_EVENT_RESET;
+    nvs_watcher_t hits[NVS_STORE_MAX_WATCHERS];
+    int n = 0;
+
+    portENTER_CRITICAL(&s_watch_lock);
+    for (int i = 0; i < NVS_STORE_MAX_WATCHERS; i++) {
+        if (s_watchers[i].cb) hits[n++] = s_watchers[i];
+    }
+    portEXIT_CRITICAL(&s_watch_lock);
+
+    for (int i = 0; i < n; i++) {
+        hits[i].cb(NULL, NVS_TYPE_ANY, &ev, hits[i].ctx);
+    }
+}
+
+typedef esp_err_t (*txn_op_fn_t)(nvs_cmd_type_t type, const char* key, const char* str, uint32_t u32);
+
+// Przechodzi po rekordach journala i woła fn dla każdego z nich
+static esp_err_t txn_walk(const uint8_t* buf, size_t len, txn_op_fn_t fn)
+{
+    const nvs_txn_hdr_t* hdr = (const nvs_txn_hdr_t*)buf;
+    if (len < sizeof(*hdr) || hdr->magic != NVS_TXN_MAGIC || hdr->len != len) {
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    size_t pos = sizeof(*hdr);
+    for (uint16_t i = 0; i < hdr->n_ops; i++) {
+        if (pos + 2 > len) return ESP_ERR_INVALID_SIZE;
+        uint8_t type = buf[pos++];
+        uint8_t klen = buf[pos++];
+        if (klen > NVS_KEY_MAX_LEN || pos + klen + 2 > len) return ESP_ERR_INVALID_SIZE;
+
+        char key[NVS_KEY_MAX_LEN + 1];
+        memcpy(key, &buf[pos], klen);
+        key[klen] = '\0';
+        pos += klen;
+
+        uint16_t vlen = (uint16_t)(buf[pos] | (buf[pos + 1] << 8));
+        pos += 2;
+        if (pos + vlen > len || vlen > NVS_STR_MAX_LEN) return ESP_ERR_INVALID_SIZE;
+
+        esp_err_t err;
+        if (type == NVS_CMD_SET_STR) {
+            char val[NVS_STR_MAX_LEN + 1];
+            memcpy(val, &buf[pos], vlen);
+            val[vlen] = '\0';
+            err = fn(NVS_CMD_SET_STR, key, val, 0);
+        } else {
+            uint32_t v;
+            memcpy(&v, &buf[pos], sizeof(v));
+            err = fn(NVS_CMD_SET_U32, key, NULL, v);
+        }
+        if (err != ESP_OK) return err;
+        pos += vlen;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t txn_op_set(nvs_cmd_type_t type, const char* key, const char* str, uint32_t u32)
+{
+    return type == NVS_CMD_SET_STR ? nvs_set_str(s_nvs_handle, key, str)
+                                   : nvs_set_u32(s_nvs_handle, key, u32);
+}
+
+static esp_err_t txn_op_notify(nvs_cmd_type_t type, const char* key, const char* str, uint32_t u32)
+{
+    if (type == NVS_CMD_SET_STR) {
+        notify_watchers(key, NVS_TYPE_STR, str);
+    } else {
+        notify_watchers(key, NVS_TYPE_U32, &u32);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t txn_apply(const uint8_t* buf, size_t len)
+{
+    esp_err_t err = txn_walk(buf, len, txn_op_set);
+    if (err != ESP_OK) return err;
+    return nvs_commit(s_nvs_handle);
+}
+
+static esp_err_t txn_append(nvs_txn_handle_t txn, nvs_cmd_type_t type, const char* key, const void* val, size_t vlen);
+static void txn_seal(struct nvs_txn* txn);
+
+// Rekordy, które zmieniają zapisaną wartość (tylko worker)
+static struct nvs_txn s_txn_changed;
+
+static esp_err_t txn_op_filter(nvs_cmd_type_t type, const char* key, const char* str, uint32_t u32)
+{
+    if (type == NVS_CMD_SET_STR) {
+        char cur[NVS_STR_MAX_LEN + 1];
+        size_t len = sizeof(cur);
+        if (nvs_get_str(s_nvs_handle, key, cur, &len) == ESP_OK && strcmp(cur, str) == 0) return ESP_OK;
+        return txn_append(&s_txn_changed, type, key, str, strlen(str));
+    }
+    uint32_t cur;
+    if (nvs_get_u32(s_nvs_handle, key, &cur) == ESP_OK && cur == u32) return ESP_OK;
+    return txn_append(&s_txn_changed, type, key, &u32, sizeof(u32));
+}
+
+static esp_err_t txn_commit(struct nvs_txn* txn)
+{
+    s_txn_changed.len = sizeof(nvs_txn_hdr_t);
+    s_txn_changed.n_ops = 0;
+    esp_err_t err = txn_walk(txn->buf, txn->len, txn_op_filter);
+    if (err != ESP_OK) return err;
+    txn_seal(&s_txn_changed);
+    const struct nvs_txn* ch = &s_txn_changed;
+
+    if (ch->n_ops <= 1) {
+        // jeden zapis NVS jest atomowy sam w sobie - bez journala
+        err = txn_apply(ch->buf, ch->len);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "TXN write failed: %s", esp_err_to_name(err));
+            return err;
+        }
+    } else {
+        // 1) journal - do tego momentu nic nie zostało zmienione
+        err = nvs_set_blob(s_txn_handle, NVS_TXN_KEY, ch->buf, ch->len);
+        if (err == ESP_OK) err = nvs_commit(s_txn_handle);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "TXN journal write failed: %s", esp_err_to_name(err));
+            return err;
+        }
+
+        // 2) zastosowanie zmian; przy resecie journal zostanie odtworzony w nvs_store_init
+        err = txn_apply(ch->buf, ch->len);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "TXN apply failed (%s), replay on next init", esp_err_to_name(err));
+            return err;
+        }
+
+        // 3) sprzątanie journala
+        nvs_erase_key(s_txn_handle, NVS_TXN_KEY);
+        nvs_commit(s_txn_handle);
+    }
+    ESP_LOGD(TAG, "TXN committed (%u ops, %u changed)", txn->n_ops, ch->n_ops);
+
+    txn_walk(txn->buf, txn->len, txn_op_notify);
+    notify_watchers_commit();
+    return ESP_OK;
+}
+
+static void txn_recover(void)
+{
+    size_t len = 0;
+    if (nvs_get_blob(s_txn_handle, NVS_TXN_KEY, NULL, &len) != ESP_OK || len == 0) {
+        return;
+    }
+
+    uint8_t* buf = malloc(len);
+    if (!buf) return;
+
+    esp_err_t err = nvs_get_blob(s_txn_handle, NVS_TXN_KEY, buf, &len);
+    if (err == ESP_OK) err = txn_apply(buf, len);
+    free(buf);
+
+    if (err == ESP_OK || err == ESP_ERR_INVALID_CRC || err == ESP_ERR_INVALID_SIZE) {
+        ESP_LOGW(TAG, "TXN journal %s", err == ESP_OK ? "replayed" : "corrupted, dropped");
+        nvs_erase_key(s_txn_handle, NVS_TXN_KEY);
+        nvs_commit(s_txn_handle);
+    } else {
+        ESP_LOGE(TAG, "TXN replay failed: %s", esp_err_to_name(err));
+    }
+}
+
 static void nvs_worker_task(void *param) 
 {
-    esp_task_wdt_add(NULL);
+    NVS_WDT_ADD();
 
     nvs_cmd_t cmd;
     while (1) {
-        esp_task_wdt_reset();
+        NVS_WDT_RESET();
 
         if (xQueueReceive(s_nvs_queue, &cmd, pdMS_TO_TICKS(100)) == pdTRUE) {
             esp_err_t err = ESP_OK;
@@ -33,34 +300,69 @@ static void nvs_worker_task(void *param)
                     ESP_LOGD(TAG, "SET STR: %s", cmd.key);
                     err = nvs_set_str(s_nvs_handle, cmd.key, cmd.str_value);
                     nvs_commit(s_nvs_handle);
+                    if (err == ESP_OK) {
+                        notify_watchers(cmd.key, NVS_TYPE_STR, cmd.str_value);
+                        notify_watchers_commit();
+                    }
                     break;
                 case NVS_CMD_SET_U32:
                     ESP_LOGD(TAG, "SET U32: %s", cmd.key);
                     err = nvs_set_u32(s_nvs_handle, cmd.key, cmd.u32_value);
                     nvs_commit(s_nvs_handle);
+                    if (err == ESP_OK) {
+                        notify_watchers(cmd.key, NVS_TYPE_U32, &cmd.u32_value);
+                        notify_watchers_commit();
+                    }
                     break;
                 case NVS_CMD_GET_STR:
                     cmd.out_len = sizeof(cmd.str_value);
                     err = nvs_get_str(s_nvs_handle, cmd.key, cmd.str_value, &cmd.out_len);
                     if (err != ESP_OK) cmd.out_len = 0;
-                    xQueueSend(s_nvs_queue, &cmd, 0);
-                    vTaskDelay(pdMS_TO_TICKS(1));
+                    // odpowiedź bezpośrednio do wywołującego - nie przez wspólną kolejkę
+                    memcpy(cmd.reply, &cmd, sizeof(cmd));
+                    xTaskNotifyGiveIndexed(cmd.waiter, NVS_STORE_NOTIFY_INDEX);
                     continue;
                 case NVS_CMD_GET_U32:
                     err = nvs_get_u32(s_nvs_handle, cmd.key, &cmd.u32_value);
                     cmd.out_len = (err == ESP_OK) ? 4 : 0;
-                    xQueueSend(s_nvs_queue, &cmd, 0);
-                    vTaskDelay(pdMS_TO_TICKS(1));
+                    memcpy(cmd.reply, &cmd, sizeof(cmd));
+                    xTaskNotifyGiveIndexed(cmd.waiter, NVS_STORE_NOTIFY_INDEX);
                     continue;
                 case NVS_CMD_RESET:
                     ESP_LOGW(TAG, "RESET NVS");
                     nvs_erase_all(s_nvs_handle);
                     nvs_commit(s_nvs_handle);
+                    notify_watchers_reset();
+                    break;
+                case NVS_CMD_GET_MANY:
+                    for (size_t i = 0; i < cmd.many.n; i++) {
+                        nvs_store_item_t* it = &cmd.many.items[i];
+                        if (it->type == NVS_TYPE_STR) {
+                            it->out_len = it->bufsize;
+                            it->err = nvs_get_str(s_nvs_handle, it->key, (char*)it->buf, &it->out_len);
+                        } else if (it->type == NVS_TYPE_U32 && it->bufsize >= sizeof(uint32_t)) {
+                            it->err = nvs_get_u32(s_nvs_handle, it->key, (uint32_t*)it->buf);
+                            it->out_len = sizeof(uint32_t);
+                        } else {
+                            it->err = ESP_ERR_INVALID_ARG;
+                        }
+                        if (it->err != ESP_OK) it->out_len = 0;
+                    }
+                    xTaskNotifyGiveIndexed(cmd.waiter, NVS_STORE_NOTIFY_INDEX);
+                    continue;
+                case NVS_CMD_STOP:
+                    NVS_WDT_DELETE();
+                    xTaskNotifyGiveIndexed(cmd.waiter, NVS_STORE_NOTIFY_INDEX);
+                    vTaskDelete(NULL);
+                    break;
+                case NVS_CMD_TXN_COMMIT:
+                    cmd.txn->result = txn_commit(cmd.txn);
+                    xTaskNotifyGiveIndexed(cmd.txn->waiter, NVS_STORE_NOTIFY_INDEX);
                     break;
             }
             vTaskDelay(pdMS_TO_TICKS(2));
         } else {
-            esp_task_wdt_reset();
+            NVS_WDT_RESET();
             vTaskDelay(pdMS_TO_TICKS(10));
         }
     }
@@ -68,6 +370,8 @@ static void nvs_worker_task(void *param)
 
 esp_err_t nvs_store_init(void) 
 {
+    if (s_nvs_queue) return ESP_OK;
+
     esp_err_t ret = nvs_flash_init();
     if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
         ESP_ERROR_CHECK(nvs_flash_erase());
@@ -78,6 +382,10 @@ esp_err_t nvs_store_init(void)
     ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &s_nvs_handle);
     if (ret != ESP_OK) return ret;
 
+    ret = nvs_open(NVS_TXN_NAMESPACE, NVS_READWRITE, &s_txn_handle);
+    if (ret != ESP_OK) return ret;
+    txn_recover();
+
     s_nvs_queue = xQueueCreate(10, sizeof(nvs_cmd_t));
     if (!s_nvs_queue) return ESP_ERR_NO_MEM;
 
@@ -85,6 +393,36 @@ esp_err_t nvs_store_init(void)
     return ESP_OK;
 }
 
+// Zatrzymuje workera i zamyka NVS; kolejka musi być pusta od strony zapisujących
+esp_err_t nvs_store_deinit(void)
+{
+    if (!s_nvs_queue) return ESP_OK;
+
+    nvs_cmd_t cmd = { .type = NVS_CMD_STOP, .waiter = xTaskGetCurrentTaskHandle() };
+    if (xQueueSend(s_nvs_queue, &cmd, pdMS_TO_TICKS(1000)) != pdTRUE) return ESP_ERR_TIMEOUT;
+    ulTaskNotifyTakeIndexed(NVS_STORE_NOTIFY_INDEX, pdTRUE, portMAX_DELAY);
+
+    vQueueDelete(s_nvs_queue);
+    s_nvs_queue = NULL;
+    s_nvs_task = NULL;
+    nvs_close(s_txn_handle);
+    nvs_close(s_nvs_handle);
+    s_txn_handle = s_nvs_handle = 0;
+    return nvs_flash_deinit();
+}
+
+// Wysyła GET do workera i czeka na odpowiedź zapisaną w *cmd
+static esp_err_t nvs_request(nvs_cmd_t* cmd) {
+    cmd->waiter = xTaskGetCurrentTaskHandle();
+    cmd->reply = cmd;
+    if (xQueueSend(s_nvs_queue, cmd, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return ESP_FAIL;
+    }
+    // worker zawsze odpowiada, a odpowiedź trafia na stos wywołującego
+    ulTaskNotifyTakeIndexed(NVS_STORE_NOTIFY_INDEX, pdTRUE, portMAX_DELAY);
+    return ESP_OK;
+}
+
 esp_err_t nvs_store_set_str(const char* key, const char* value) {
     if (!s_nvs_queue) return ESP_FAIL;
     nvs_cmd_t cmd = { .type = NVS_CMD_SET_STR };
@@ -110,10 +448,10 @@ esp_err_t nvs_store_get_str(const char* key, char* buffer, size_t bufsize, size_
     strncpy(cmd.key, key, sizeof(cmd.key) - 1);
     cmd.key[sizeof(cmd.key) - 1] = '\0';
 
-    if (xQueueSend(s_nvs_queue, &cmd, pdMS_TO_TICKS(100)) != pdTRUE) {
+    if (nvs_request(&cmd) != ESP_OK) {
         return ESP_FAIL;
     }
-    if (xQueueReceive(s_nvs_queue, &cmd, pdMS_TO_TICKS(500)) == pdTRUE) {
+    if (cmd.out_len > 0) {
         size_t len = cmd.out_len <= bufsize ? cmd.out_len : bufsize;
         strncpy(buffer, cmd.str_value, len);
         if (len > 0 && len < bufsize) buffer[len] = '\0';
@@ -129,18 +467,134 @@ esp_err_t nvs_store_get_u32(const char* key, uint32_t* value) {
     strncpy(cmd.key, key, sizeof(cmd.key) - 1);
     cmd.key[sizeof(cmd.key) - 1] = '\0';
 
-    if (xQueueSend(s_nvs_queue, &cmd, pdMS_TO_TICKS(100)) != pdTRUE) {
+    if (nvs_request(&cmd) != ESP_OK) {
         return ESP_FAIL;
     }
-    if (xQueueReceive(s_nvs_queue, &cmd, pdMS_TO_TICKS(500)) == pdTRUE) {
+    if (cmd.out_len > 0) {
         *value = cmd.u32_value;
         return ESP_OK;
     }
     return ESP_FAIL;
 }
 
+esp_err_t nvs_store_get_many(nvs_store_item_t* items, size_t n) {
+    if (!s_nvs_queue) return ESP_FAIL;
+    if (!items || n == 0) return ESP_ERR_INVALID_ARG;
+    nvs_cmd_t cmd = { .type = NVS_CMD_GET_MANY, .many = { .items = items, .n = n } };
+    if (nvs_request(&cmd) != ESP_OK) return ESP_FAIL;
+
+    for (size_t i = 0; i < n; i++) {
+        if (items[i].err != ESP_OK) return items[i].err;
+    }
+    return ESP_OK;
+}
+
 esp_err_t nvs_store_reset(void) {
     if (!s_nvs_queue) return ESP_FAIL;
     nvs_cmd_t cmd = { .type = NVS_CMD_RESET };
     return xQueueSend(s_nvs_queue, &cmd, pdMS_TO_TICKS(100)) == pdTRUE ? ESP_OK : ESP_FAIL;
-}
\ No newline at end of file
+}
+
+esp_err_t nvs_store_txn_begin(nvs_txn_handle_t* out) {
+    if (!out) return ESP_ERR_INVALID_ARG;
+    struct nvs_txn* txn = calloc(1, sizeof(*txn));
+    if (!txn) return ESP_ERR_NO_MEM;
+    txn->len = sizeof(nvs_txn_hdr_t);
+    *out = txn;
+    return ESP_OK;
+}
+
+static esp_err_t txn_append(nvs_txn_handle_t txn, nvs_cmd_type_t type, const char* key, const void* val, size_t vlen) {
+    if (!txn || !key) return ESP_ERR_INVALID_ARG;
+    size_t klen = strlen(key);
+    if (klen == 0 || klen > NVS_KEY_MAX_LEN) return ESP_ERR_NVS_KEY_TOO_LONG;
+    if (vlen > NVS_STR_MAX_LEN) return ESP_ERR_NVS_INVALID_LENGTH;
+    if (txn->len + 2 + klen + 2 + vlen > NVS_TXN_MAX_BYTES) return ESP_ERR_NO_MEM;
+
+    uint8_t* p = &txn->buf[txn->len];
+    *p++ = (uint8_t)type;
+    *p++ = (uint8_t)klen;
+    memcpy(p, key, klen);
+    p += klen;
+    *p++ = (uint8_t)(vlen & 0xFF);
+    *p++ = (uint8_t)(vlen >> 8);
+    memcpy(p, val, vlen);
+
+    txn->len += 2 + klen + 2 + vlen;
+    txn->n_ops++;
+    return ESP_OK;
+}
+
+// Nagłówek przed zapisem albo przejściem txn_walk
+static void txn_seal(struct nvs_txn* txn) {
+    nvs_txn_hdr_t hdr = { .magic = NVS_TXN_MAGIC, .n_ops = txn->n_ops, .len = (uint16_t)txn->len };
+    memcpy(txn->buf, &hdr, sizeof(hdr));
+}
+
+esp_err_t nvs_store_txn_set_str(nvs_txn_handle_t txn, const char* key, const char* value) {
+    if (!value) return ESP_ERR_INVALID_ARG;
+    return txn_append(txn, NVS_CMD_SET_STR, key, value, strlen(value));
+}
+
+esp_err_t nvs_store_txn_set_u32(nvs_txn_handle_t txn, const char* key, uint32_t value) {
+    return txn_append(txn, NVS_CMD_SET_U32, key, &value, sizeof(value));
+}
+
+esp_err_t nvs_store_txn_commit(nvs_txn_handle_t txn) {
+    if (!txn) return ESP_ERR_INVALID_ARG;
+    if (!s_nvs_queue || txn->n_ops == 0) {
+        esp_err_t err = s_nvs_queue ? ESP_OK : ESP_FAIL;
+        free(txn);
+        return err;
+    }
+
+    txn_seal(txn);
+    txn->waiter = xTaskGetCurrentTaskHandle();
+
+    nvs_cmd_t cmd = { .type = NVS_CMD_TXN_COMMIT, .txn = txn };
+    if (xQueueSend(s_nvs_queue, &cmd, pdMS_TO_TICKS(100)) != pdTRUE) {
+        free(txn);
+        return ESP_FAIL;
+    }
+    // worker zawsze odpowiada; txn musi żyć do końca zapisu
+    ulTaskNotifyTakeIndexed(NVS_STORE_NOTIFY_INDEX, pdTRUE, portMAX_DELAY);
+    esp_err_t err = txn->result;
+    free(txn);
+    return err;
+}
+
+void nvs_store_txn_abort(nvs_txn_handle_t txn) {
+    free(txn);
+}
+
+esp_err_t nvs_store_watch(const char* key_or_prefix, nvs_store_watch_cb_t cb, void* ctx) {
+    if (!key_or_prefix || !cb) return ESP_ERR_INVALID_ARG;
+    if (strlen(key_or_prefix) >= sizeof(s_watchers[0].pattern)) return ESP_ERR_NVS_KEY_TOO_LONG;
+
+    esp_err_t err = ESP_ERR_NO_MEM;
+    portENTER_CRITICAL(&s_watch_lock);
+    for (int i = 0; i < NVS_STORE_MAX_WATCHERS; i++) {
+        if (!s_watchers[i].cb) {
+            strcpy(s_watchers[i].pattern, key_or_prefix);
+            s_watchers[i].ctx = ctx;
+            s_watchers[i].cb = cb;
+            err = ESP_OK;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_watch_lock);
+    return err;
+}
+
+esp_err_t nvs_store_unwatch(nvs_store_watch_cb_t cb, void* ctx) {
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+    portENTER_CRITICAL(&s_watch_lock);
+    for (int i = 0; i < NVS_STORE_MAX_WATCHERS; i++) {
+        if (s_watchers[i].cb == cb && s_watchers[i].ctx == ctx) {
+            s_watchers[i].cb = NULL;
+            err = ESP_OK;
+        }
+    }
+    portEXIT_CRITICAL(&s_watch_lock);
+    return err;
+}
@@ -6,168 +6,110 @@
 #include "esp_event.h"
 #include "esp_netif.h"
 #include "esp_http_server.h"
-#include "esp_spiffs.h"
 #include "network_mgr.h"
 #include "sta_comm.h"
+#include "bb_assets.h"
+#include "bb_json.h"
+#include "bb_ota.h"
+#include "web_assets.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 static const char *TAG = "WebServer";
 
 static httpd_handle_t server = NULL;
 
-static const char* form_html = 
-   "<!DOCTYPE html>"
-   "<html>"
-   "<head>"
-   "  <style>"
-   "    html, body {"
-   "      margin: 0; padding: 0; height: 100%;"
-   "      background-color: #f9fbff;"
-   "      font-family: Arial, sans-serif;"
-   "      display: flex;"
-   "      flex-direction: column;"
-   "      min-height: 100vh;"
-   "    }"
-   "    .logo-wrapper {"
-   "      width: 100%;"
-   "      text-align: center;"
-   "      padding-top: 60px;"
-   "      padding-bottom: 40px;"
-   "      box-sizing: border-box;"
-   "    }"
-   "    .container {"
-   "      max-width: 400px;"
-   "      margin: 0 auto 40px auto;"
-   "      flex: 1 0 auto;"
-   "      text-align: center;"
-   "      padding: 0 20px;"
-   "      box-sizing: border-box;"
-   "    }"
-   "    form {"
-   "      margin-top: 30px;"
-   "    }"
-   "    label {"
-   "      display: block;"
-   "      margin: 15px 0 8px 0;"
-   "      text-align: left;"
-   "      font-weight: 600;"
-   "      font-size: 14px;"
-   "      color: #333;"
-   "    }"
-   "    input[type='text'], input[type='password'] {"
-   "      width: 100%;"
-   "      padding: 10px;"
-   "      box-sizing: border-box;"
-   "      font-size: 14px;"
-   "      border: 1px solid #ccc;"
-   "      border-radius: 4px;"
-   "      transition: border-color 0.3s;"
-   "    }"
-   "    input[type='text']:focus, input[type='password']:focus {"
-   "      border-color: #77aaff;"
-   "      outline: none;"
-   "    }"
-   "    input[type='submit'] {"
-   "      margin-top: 25px;"
-   "      padding: 12px 25px;"
-   "      font-size: 16px;"
-   "      background-color: #77aaff;"
-   "      border: none;"
-   "      border-radius: 5px;"
-   "      color: white;"
-   "      cursor: pointer;"
-   "      transition: background-color 0.3s;"
-   "    }"
-   "    input[type='submit']:hover {"
-   "      background-color: #5599ee;"
-   "    }"
-   "    img {"
-   "      max-width: 35vw;"
-   "      height: auto;"
-   "      display: inline-block;"
-   "      border: 1px solid #EDEDFF;"
-   "    }"
-   "    footer {"
-   "      flex-shrink: 0;"
-   "      padding: 15px 30px;"
-   "      font-size: 12px;"
-   "      font-weight: bold;"
-   "      color: #555;"
-   "      display: flex;"
-   "      justify-content: space-between;"
-   "      background: #e6ecff;"
-   "      border-top: 1px solid #ccd7ff;"
-   "      box-sizing: border-box;"
-   "    }"
-   "  </style>"
-   "</head>"
-   "<body>"
-   "  <div class='logo-wrapper'>"
-   "    <img src='logo.png' alt='Logo'>"
-   "  </div>"
-   "  <div class='container'>"
-   "    <h2>WiFi network configuration</h2>"
-   "    <form method='POST' action='/save'>"
-   "      <label for='ssid'>Network name (SSID):</label>"
-   "      <input id='ssid' name='ssid' type='text' required>"
-   "      <label for='pass'>Network password:</label>"
-   "      <input id='pass' name='pass' type='password'>"
-   "      <input type='submit' value='Save'>"
-   "    </form>"
-   "  </div>"
-   "  <footer>"
-   "    <span>embedberight.com</span>"
-   "    <span>&copy; 2025</span>"
-   "  </footer>"
-   "</body>"
-   "</html>";
-
-void mount_spiffs() 
-{
-    esp_vfs_spiffs_conf_t conf = {
-      .base_path = "/spiffs",
-      .partition_label = NULL,
-      .max_files = 5,
-      .format_if_mount_failed = true
-    };
-    esp_err_t ret = esp_vfs_spiffs_register(&conf);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "SPIFFS Mount failed");
-    } else {
-        size_t total = 0, used = 0;
-        esp_spiffs_info(NULL, &total, &used);
-        ESP_LOGI(TAG, "SPIFFS mounted. Total: %d, Used: %d", total, used);
+#define UPDATE_CHUNK            2048
+#define UPDATE_FEED_TO_MS       5000
+#define UPDATE_DONE_TO_MS       30000
+#define UPDATE_RECV_RETRIES     3
+// Task odbioru może czekać w httpd_req_recv (recv_wait_timeout 5 s na próbę)
+#define UPDATE_STOP_TO_MS       ((UPDATE_RECV_RETRIES + 1) * 5000 + UPDATE_FEED_TO_MS)
+
+// HTML bez cache (ETag -> 304 po aktualizacji), reszta na dobę
+#define CACHE_HTML              "no-cache"
+#define CACHE_STATIC            "public, max-age=86400"
+
+// ===== ZASOBY =====
+// Paczka bb_assets (bank storage) ma pierwszeństwo dla zasobów statycznych.
+// HTML i trasy aplikacji ("/", "/update") wołają formularze i endpointy tej
+// wersji kodu, więc idą tylko z wbudowanych web_assets[] - paczka z innej
+// wersji ich nie podmieni. Oba wysyłane jednym httpd_resp_send prosto z
+// flash, gzip bez rozpakowywania (przeglądarki portalu przyjmują gzip).
+// If-None-Match z aktualnym ETag -> 304 bez treści.
+static const web_asset_t* find_asset(const char *uri) {
+    size_t lo = 0, hi = web_assets_count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        int c = strcmp(uri, web_assets[mid].uri);
+        if (c == 0) return &web_assets[mid];
+        if (c < 0) hi = mid;
+        else lo = mid + 1;
     }
+    return NULL;
 }
 
-static esp_err_t root_handler(httpd_req_t *req) {
-    httpd_resp_set_type(req, "text/html");
-    httpd_resp_send(req, form_html, HTTPD_RESP_USE_STRLEN);
-    return ESP_OK;
+static bool etag_matches(httpd_req_t *req, const char *etag) {
+    char buf[64];
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", buf, sizeof(buf)) != ESP_OK) return false;
+    return strstr(buf, etag) != NULL || strcmp(buf, "*") == 0;     // także lista ETagów
 }
 
-static esp_err_t logo_handler(httpd_req_t *req) {
-    const char *filepath = "/spiffs/logo.png";
-    FILE *file = fopen(filepath, "rb");
-    if (!file) {
-        httpd_resp_send_404(req);
-        return ESP_FAIL;
-    }
-
-    httpd_resp_set_type(req, "image/png");
+// Zasób z paczki, o ile wolno: nie dla tras aplikacji, wbudowanego HTML
+// ani HTML dodanego przez paczkę
+static bool bundle_find(const char *uri, bool app_route, const web_asset_t *wa, bb_asset_t *out) {
+    if (app_route || (wa && strcmp(wa->type, "text/html") == 0)) return false;
+    if (bb_assets_find(uri, out) != ESP_OK) return false;
+    return strcmp(out->type, "text/html") != 0;
+}
 
-    char buf[1024];
-    size_t read_bytes;
-    while ((read_bytes = fread(buf, 1, sizeof(buf), file)) > 0) {
-        if (httpd_resp_send_chunk(req, buf, read_bytes) != ESP_OK) {
-            fclose(file);
-            httpd_resp_send_chunk(req, NULL, 0); 
+static esp_err_t send_asset(httpd_req_t *req, const char *uri, bool app_route) {
+    bb_asset_t asset;
+    const web_asset_t *wa = find_asset(uri);
+    bb_assets_lock();                               // bank nie zmieni się w trakcie wysyłki
+    if (!bundle_find(uri, app_route, wa, &asset)) {
+        if (!wa) {
+            bb_assets_unlock();
+            httpd_resp_send_404(req);
             return ESP_FAIL;
         }
+        asset.data = wa->data;
+        asset.len = wa->len;
+        asset.type = wa->type;
+        asset.gzip = wa->gzip;
+        snprintf(asset.etag, sizeof(asset.etag), "%s", wa->etag);
     }
-    fclose(file);
-    httpd_resp_send_chunk(req, NULL, 0); 
-    return ESP_OK;
+
+    const char *cache = strcmp(asset.type, "text/html") == 0 ? CACHE_HTML : CACHE_STATIC;
+    httpd_resp_set_hdr(req, "ETag", asset.etag);
+    httpd_resp_set_hdr(req, "Cache-Control", cache);
+    esp_err_t err;
+    if (etag_matches(req, asset.etag)) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        err = httpd_resp_send(req, NULL, 0);
+    } else {
+        httpd_resp_set_type(req, asset.type);
+        if (asset.gzip) httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+        err = httpd_resp_send(req, (const char *)asset.data, asset.len);
+    }
+    bb_assets_unlock();
+    return err;
+}
+
+static esp_err_t root_handler(httpd_req_t *req) {
+    return send_asset(req, "/", true);
+}
+
+static esp_err_t asset_handler(httpd_req_t *req) {
+    char uri[48];                                   // jak path w katalogu paczki
+    size_t n = strcspn(req->uri, "?");              // bez query
+    if (n >= sizeof(uri)) return httpd_resp_send_404(req);
+    memcpy(uri, req->uri, n);
+    uri[n] = '\0';
+    return send_asset(req, uri, false);
 }
 
 static esp_err_t save_handler(httpd_req_t *req) {
@@ -180,8 +122,19 @@ static esp_err_t save_handler(httpd_req_t *req) {
 
     char ssid[64] = {0}, pass[64] = {0};
     sscanf(buf, "ssid=%63[^&]&pass=%63s", ssid, pass);
-    nvs_store_set_str("wifi_ssid", ssid);
-    nvs_store_set_str("wifi_passwd", pass);
+    nvs_txn_handle_t txn;
+    esp_err_t err = nvs_store_txn_begin(&txn);
+    if (err == ESP_OK) {
+        err = nvs_store_txn_set_str(txn, "wifi_ssid", ssid);
+        if (err == ESP_OK) err = nvs_store_txn_set_str(txn, "wifi_passwd", pass);
+        if (err == ESP_OK) err = nvs_store_txn_commit(txn);     // zwalnia txn także przy błędzie
+        else nvs_store_txn_abort(txn);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Saving Wi-Fi credentials failed: %s", esp_err_to_name(err));
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "NVS write failed");
+        return ESP_FAIL;
+    }
 
     httpd_resp_set_status(req, "302 Found");
     httpd_resp_set_hdr(req, "Location", "/");
@@ -191,6 +144,157 @@ static esp_err_t save_handler(httpd_req_t *req) {
     return ESP_OK;
 }
 
+// ===== AKTUALIZACJA APLIKACJI =====
+// Body idzie kawałkami UPDATE_CHUNK prosto do bb_ota (dwa bufory sektora,
+// zapis w tasku bb_ota). Odbiór w osobnym tasku przez async handler, więc
+// task httpd dalej obsługuje /update/status i resztę portalu.
+static volatile bool s_update_busy = false;
+static uint8_t s_update_buf[UPDATE_CHUNK];      // tylko task odbioru, jeden upload naraz
+
+static esp_err_t update_send_result(httpd_req_t *req, esp_err_t err) {
+    bb_ota_status_t st;
+    bb_ota_get_status(&st);
+    char buf[160];
+    bb_json_t j;
+    bb_json_begin(&j, buf, sizeof(buf));
+    bb_json_obj(&j);
+    bb_json_key(&j, "ok");      bb_json_bool(&j, err == ESP_OK);
+    if (err != ESP_OK) {
+        bb_json_key(&j, "err"); bb_json_str(&j, esp_err_to_name(err));
+    }
+    bb_json_key(&j, "bytes");   bb_json_uint(&j, st.written);
+    bb_json_key(&j, "ms");      bb_json_uint(&j, st.ms);
+    bb_json_end(&j);
+    size_t len;
+    bb_json_finish(&j, &len);
+
+    if (err != ESP_OK) httpd_resp_set_status(req, err == ESP_ERR_INVALID_CRC ? "422 Unprocessable Entity" : "500 Internal Server Error");
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_send(req, buf, len);
+}
+
+static void update_task(void *pv) {
+    httpd_req_t *req = (httpd_req_t *)pv;
+    size_t total = req->content_len;
+    size_t off = 0;
+    int retries = 0;
+    esp_err_t err = ESP_OK;
+    while (off < total && err == ESP_OK) {
+        size_t want = total - off < sizeof(s_update_buf) ? total - off : sizeof(s_update_buf);
+        int n = httpd_req_recv(req, (char *)s_update_buf, want);
+        if (n == HTTPD_SOCK_ERR_TIMEOUT && ++retries <= UPDATE_RECV_RETRIES) continue;
+        if (n <= 0) {
+            err = ESP_ERR_TIMEOUT;
+            break;
+        }
+        retries = 0;
+        err = bb_ota_feed(off, s_update_buf, n, pdMS_TO_TICKS(UPDATE_FEED_TO_MS));
+        off += n;
+    }
+    if (err == ESP_OK) {
+        err = bb_ota_wait(pdMS_TO_TICKS(UPDATE_DONE_TO_MS));
+    } else {
+        ESP_LOGW(TAG, "Update upload failed at %u/%u B: %s", (unsigned)off, (unsigned)total, esp_err_to_name(err));
+        bb_ota_abort();
+        bb_ota_wait(pdMS_TO_TICKS(UPDATE_FEED_TO_MS));
+    }
+    update_send_result(req, err);
+    httpd_req_async_handler_complete(req);
+    s_update_busy = false;
+    vTaskDelete(NULL);
+}
+
+// POST /update[?reboot=0], body = plik .bin aplikacji, opcjonalnie nagłówek
+// X-SHA256 (64 hex); bez niego obraz sprawdza esp_ota_end.
+// POST /update?target=assets&version=N, body = paczka bb_assets, X-SHA256
+// wymagany; bank przełączany bez restartu
+static esp_err_t update_handler(httpd_req_t *req) {
+    if (req->content_len == 0) {
+        return httpd_resp_send_err(req, HTTPD_411_LENGTH_REQUIRED, "Image body required");
+    }
+    uint8_t sha[32];
+    bool has_sha = false;
+    char hex[65];
+    if (httpd_req_get_hdr_value_str(req, "X-SHA256", hex, sizeof(hex)) == ESP_OK) {
+        if (!bb_ota_sha256_from_hex(hex, sha)) return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Bad X-SHA256");
+        has_sha = true;
+    }
+    bool reboot = true;
+    bool assets = false;
+    uint32_t version = 0;
+    char query[64], val[12];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+        if (httpd_query_key_value(query, "reboot", val, sizeof(val)) == ESP_OK) reboot = strcmp(val, "0") != 0;
+        if (httpd_query_key_value(query, "target", val, sizeof(val)) == ESP_OK) assets = strcmp(val, "assets") == 0;
+        if (httpd_query_key_value(query, "version", val, sizeof(val)) == ESP_OK) version = strtoul(val, NULL, 10);
+    }
+    if (assets && (!has_sha || version == 0)) {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Assets need X-SHA256 and version");
+    }
+
+    if (s_update_busy) {
+        httpd_resp_set_status(req, "409 Conflict");
+        return httpd_resp_sendstr(req, "Update in progress");
+    }
+    esp_err_t err = bb_ota_start();             // w trybie portalu BBAPI jeszcze nie działa
+    if (err == ESP_OK && assets) {
+        err = bb_ota_begin_assets(req->content_len, sha, req->content_len, 0, version, BB_OTA_SRC_LOCAL);
+    } else if (err == ESP_OK) {
+        err = bb_ota_begin(req->content_len, has_sha ? sha : NULL, BB_OTA_SRC_LOCAL, reboot, NULL);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Update rejected: %s", esp_err_to_name(err));
+        bool bad = err == ESP_ERR_INVALID_SIZE || err == ESP_ERR_INVALID_VERSION;
+        return httpd_resp_send_err(req, bad ? HTTPD_400_BAD_REQUEST : HTTPD_500_INTERNAL_SERVER_ERROR,
+                                   esp_err_to_name(err));
+    }
+
+    httpd_req_t *copy = NULL;
+    err = httpd_req_async_handler_begin(req, &copy);
+    if (err == ESP_OK) {
+        s_update_busy = true;
+        if (xTaskCreate(update_task, "web_update", 3072, copy, 4, NULL) != pdPASS) {
+            s_update_busy = false;
+            err = ESP_ERR_NO_MEM;
+            httpd_req_async_handler_complete(copy);
+        }
+    }
+    if (err != ESP_OK) {
+        bb_ota_abort();
+        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, esp_err_to_name(err));
+    }
+    ESP_LOGI(TAG, "Update upload started: %u B", (unsigned)req->content_len);
+    return ESP_OK;
+}
+
+static esp_err_t update_status_handler(httpd_req_t *req) {
+    bb_ota_status_t st;
+    bb_ota_get_status(&st);
+    char buf[160];
+    bb_json_t j;
+    bb_json_begin(&j, buf, sizeof(buf));
+    bb_json_obj(&j);
+    bb_json_key(&j, "state");       bb_json_str(&j, bb_ota_state_name(st.state));
+    bb_json_key(&j, "target");      bb_json_str(&j, st.target == BB_OTA_TARGET_ASSETS ? "assets" : "app");
+    if (st.state == BB_OTA_FAILED) {
+        bb_json_key(&j, "err");     bb_json_str(&j, esp_err_to_name(st.err));
+    }
+    bb_json_key(&j, "size");        bb_json_uint(&j, st.size);
+    bb_json_key(&j, "received");    bb_json_uint(&j, st.received);
+    bb_json_key(&j, "written");     bb_json_uint(&j, st.written);
+    bb_json_key(&j, "ms");          bb_json_uint(&j, st.ms);
+    bb_json_end(&j);
+    size_t len;
+    bb_json_finish(&j, &len);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    return httpd_resp_send(req, buf, len);
+}
+
+static esp_err_t update_page_handler(httpd_req_t *req) {
+    return send_asset(req, "/update.html", true);
+}
+
 static esp_err_t save_get_redirect(httpd_req_t *req) 
 {
     httpd_resp_set_status(req, "302 Found");
@@ -208,6 +312,7 @@ esp_err_t webserver_start(void) {
     ESP_ERROR_CHECK(network_mgr_start_ap(&ap));  // bez esp_netif_init/esp_event_loop_create_default/esp_wifi_init tutaj
 
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.uri_match_fn = httpd_uri_match_wildcard;    // "/*" - pozostałe GET z paczki zasobów
 
     if (httpd_start(&server, &config) == ESP_OK) {
         httpd_uri_t root = {
@@ -219,19 +324,38 @@ esp_err_t webserver_start(void) {
         httpd_uri_t save_get = { 
             .uri="/save", .method=HTTP_GET, .handler = save_get_redirect 
         };
-        httpd_uri_t logo_uri = { 
-            .uri = "/logo.png", .method = HTTP_GET, .handler = logo_handler
+        httpd_uri_t update_page = {
+            .uri = "/update", .method = HTTP_GET, .handler = update_page_handler
+        };
+        httpd_uri_t update = {
+            .uri = "/update", .method = HTTP_POST, .handler = update_handler
+        };
+        httpd_uri_t update_status = {
+            .uri = "/update/status", .method = HTTP_GET, .handler = update_status_handler
+        };
+        httpd_uri_t assets = {
+            .uri = "/*", .method = HTTP_GET, .handler = asset_handler
         };
         httpd_register_uri_handler(server, &root);
         httpd_register_uri_handler(server, &save);
         httpd_register_uri_handler(server, &save_get);
-        httpd_register_uri_handler(server, &logo_uri);
+        httpd_register_uri_handler(server, &update_page);
+        httpd_register_uri_handler(server, &update);
+        httpd_register_uri_handler(server, &update_status);
+        httpd_register_uri_handler(server, &assets);    // ostatni - dopasowanie w kolejności rejestracji
         return ESP_OK;
     }
     return ESP_FAIL;
 }
 
 void webserver_stop(void) {
+    if (s_update_busy) {
+        // upload w toku: przerwany zapis, task odbioru kończy żądanie przed httpd_stop
+        ESP_LOGW(TAG, "Aborting update upload");
+        bb_ota_abort();
+        for (int ms = 0; s_update_busy && ms < UPDATE_STOP_TO_MS; ms += 50) vTaskDelay(pdMS_TO_TICKS(50));
+        if (s_update_busy) ESP_LOGE(TAG, "Update task still running");
+    }
     if (server) {
         ESP_LOGI(TAG, "Stopping HTTP Server");
         httpd_stop(server);
@@ -1,4 +1,5 @@
 #include "ws_comm.h"
+#include "bb_blog.h"
 #include "esp_websocket_client.h"
 #include "esp_event.h"
 #include "esp_log.h"
@@ -9,59 +10,197 @@
 #include <string.h>
 #include <stdlib.h>
 
-static const char* TAG = "WS_COMM";
+static const char TAG[] = "WS_COMM";   // tablica - stały adres dla deskryptorów BB_BLOG
 
 
 #define WS_COMM_TX_QUEUE_LEN   16   
 #define WS_COMM_RX_QUEUE_LEN   16   
 #define WS_COMM_MAX_MSG        512  
+#define WS_COMM_RX_MAX_MSG     1024     // wiadomość tekstowa z '\0', składana z części ramek
+#define WS_COMM_RX_BIG_SLOTS   2
+#define WS_COMM_RX_BIG_MSG     (4096 + 1)   // duże wiadomości serwera do 4 KB
+#define WS_COMM_RX_SLOTS       (WS_COMM_RX_QUEUE_LEN + WS_COMM_RX_BIG_SLOTS)
+#define WS_COMM_RX_NONE        0xFF
 #define WS_COMM_HEARTBEAT_MS   30000 
+#define WS_COMM_TX_LOW_MIN_FREE 4   // wolne sloty zostawiane zwykłemu ruchowi
 
 typedef struct {
     size_t len;
+    uint8_t bin;                // ramka binarna (tylko TX)
     char   data[WS_COMM_MAX_MSG];
 } ws_msg_t; 
 
+typedef struct {
+    size_t len;
+    size_t cap;
+    char*  data;
+} ws_rx_msg_t;
+
+// TX: stała pula slotów; kolejki przenoszą tylko indeksy (1 B zamiast 516 B).
+// Nadawca rezerwuje slot, buduje wiadomość w miejscu i zatwierdza ją.
+static ws_msg_t s_tx_pool[WS_COMM_TX_QUEUE_LEN];
+static QueueHandle_t s_tx_free = NULL;
+
+// RX analogicznie: odbiorca dostaje wskaźnik do slotu i zwalnia go po obsłudze.
+// Dwie klasy: WS_COMM_RX_QUEUE_LEN slotów 1 KB (indeksy od 0) i kilka 4 KB
+// (za nimi, 8 KB) - 16 slotów po 4 KB to za dużo RAM na C3.
+static char s_rx_small[WS_COMM_RX_QUEUE_LEN][WS_COMM_RX_MAX_MSG];
+static char s_rx_big[WS_COMM_RX_BIG_SLOTS][WS_COMM_RX_BIG_MSG];
+static ws_rx_msg_t s_rx_pool[WS_COMM_RX_SLOTS];
+static QueueHandle_t s_rx_free = NULL;
+static QueueHandle_t s_rx_free_big = NULL;
+// Składanie wiadomości (tylko task klienta websocket): ramka większa niż bufor
+// klienta przychodzi w częściach (payload_offset/payload_len), wiadomość
+// podzielona przez serwer w kilku ramkach (fin = 0, dalej op_code 0)
+static bool s_rx_active = false;                // wiadomość tekstowa w toku
+static uint8_t s_rx_asm = WS_COMM_RX_NONE;      // jej slot, NONE = reszta odrzucana
+static size_t s_rx_base;                        // bajty z poprzednich ramek wiadomości
+
 static esp_websocket_client_handle_t s_ws = NULL;
 static TaskHandle_t s_task = NULL;
 static QueueHandle_t s_txq = NULL;
+static QueueHandle_t s_txq_low = NULL;
 static QueueHandle_t s_rxq = NULL;
 static bool s_connected = false;
 static char* s_uri = NULL;
 static volatile bool s_run = false;
 static int64_t s_last_rx_ms = 0; 
+static volatile uint32_t s_hb_ms = WS_COMM_HEARTBEAT_MS;
+static char* volatile s_pending_uri = NULL;   // nowy URI przejmowany przez ws_comm_task
+static portMUX_TYPE s_uri_lock = portMUX_INITIALIZER_UNLOCKED;
+static ws_comm_link_cb_t s_link_cb = NULL;
+static void* s_link_ctx = NULL;
+static ws_comm_bin_cb_t s_bin_cb = NULL;
+static void* s_bin_ctx = NULL;
+static ws_comm_stats_t s_stats;     // każdy licznik ma jednego pisarza
 
 static inline int64_t now_ms(void) { return esp_timer_get_time() / 1000; } 
 
+static void rx_slot_free(uint8_t idx) {
+    xQueueSend(idx < WS_COMM_RX_QUEUE_LEN ? s_rx_free : s_rx_free_big, &idx, 0);
+}
+
+// Slot z klasy, w której mieści się need B tekstu; NONE gdy brak wolnego
+static uint8_t rx_slot_get(size_t need) {
+    uint8_t idx;
+    QueueHandle_t q = (need < WS_COMM_RX_MAX_MSG) ? s_rx_free : s_rx_free_big;
+    return xQueueReceive(q, &idx, 0) == pdTRUE ? idx : WS_COMM_RX_NONE;
+}
+
+static void rx_abort(void) {
+    if (s_rx_asm != WS_COMM_RX_NONE && s_rx_free) rx_slot_free(s_rx_asm);
+    s_rx_asm = WS_COMM_RX_NONE;
+    s_rx_active = false;
+}
+
+// Wiadomość przerosła mały slot (długość ramek fin = 0 nie jest znana z góry):
+// przeniesienie have B do dużego; false = brak dużego slotu albo za długa
+static bool rx_grow(size_t have, size_t need) {
+    if (need >= WS_COMM_RX_BIG_MSG || s_rx_pool[s_rx_asm].cap == WS_COMM_RX_BIG_MSG) return false;
+    uint8_t big = rx_slot_get(need);
+    if (big == WS_COMM_RX_NONE) return false;
+    memcpy(s_rx_pool[big].data, s_rx_pool[s_rx_asm].data, have);
+    rx_slot_free(s_rx_asm);
+    s_rx_asm = big;
+    return true;
+}
+
+// Część wiadomości tekstowej; do kolejki RX trafia tylko cała wiadomość,
+// za długa albo niespójna jest liczona w rx_trunc i odrzucana w całości
+static void rx_text(const esp_websocket_event_data_t* d) {
+    size_t off = (size_t)d->payload_offset;
+    size_t len = (size_t)d->data_len;
+    size_t total = (size_t)d->payload_len;
+    if (d->op_code == 1 && off == 0) {
+        if (s_rx_active) {
+            s_stats.rx_trunc++;
+            BB_BLOGW(TAG, "RX message cut off by a new one");
+            rx_abort();
+        }
+        if (total == 0 && d->fin) return;
+        s_rx_active = true;
+        s_rx_base = 0;
+        s_rx_asm = rx_slot_get(total);
+        if (s_rx_asm == WS_COMM_RX_NONE) {
+            s_stats.rx_drop++;
+            BB_BLOGW(TAG, "RX queue full, drop %u B", (unsigned)total);
+        }
+    } else if (!s_rx_active) {
+        return;                                 // część bez początku
+    }
+
+    if (s_rx_asm != WS_COMM_RX_NONE && (off > total || len > total - off)) {
+        s_stats.rx_trunc++;
+        BB_BLOGW(TAG, "RX part out of frame, drop");
+        rx_slot_free(s_rx_asm);
+        s_rx_asm = WS_COMM_RX_NONE;
+    }
+    if (s_rx_asm != WS_COMM_RX_NONE && total > s_rx_pool[s_rx_asm].cap - 1 - s_rx_base &&
+        !rx_grow(s_rx_base + off, s_rx_base + total)) {
+        if (s_rx_base + total < WS_COMM_RX_BIG_MSG) {
+            s_stats.rx_drop++;
+            BB_BLOGW(TAG, "RX no free big slot, drop %u B", (unsigned)(s_rx_base + total));
+        } else {
+            s_stats.rx_trunc++;
+            BB_BLOGW(TAG, "RX message over %u B, drop", (unsigned)(WS_COMM_RX_BIG_MSG - 1));
+        }
+        rx_slot_free(s_rx_asm);
+        s_rx_asm = WS_COMM_RX_NONE;
+    }
+    if (s_rx_asm != WS_COMM_RX_NONE) memcpy(s_rx_pool[s_rx_asm].data + s_rx_base + off, d->data_ptr, len);
+    if (off + len < total) return;              // dalsze części tej ramki
+    s_rx_base += total;
+    if (!d->fin) return;                        // dalsze ramki wiadomości
+
+    if (s_rx_asm != WS_COMM_RX_NONE) {
+        ws_rx_msg_t* msg = &s_rx_pool[s_rx_asm];
+        msg->data[s_rx_base] = 0;
+        msg->len = s_rx_base;
+        // ścieżka gorąca: bez printf, treść obcięta do BB_BLOG_STR_MAX
+        BB_BLOGI(TAG, "WS RX %u B: %s", (unsigned)msg->len, msg->data);
+        xQueueSend(s_rxq, &s_rx_asm, 0);
+        s_rx_asm = WS_COMM_RX_NONE;
+    }
+    s_rx_active = false;
+}
+
 static void ws_event_handler(void *arg, esp_event_base_t base, int32_t event_id, void *event_data) {
     esp_websocket_event_data_t *data = (esp_websocket_event_data_t *)event_data;
     switch (event_id) {
         case WEBSOCKET_EVENT_CONNECTED:
             s_connected = true;
             s_last_rx_ms = now_ms();
+            rx_abort();
+            s_stats.connects++;
             ESP_LOGI(TAG, "WS connected");
+            if (s_link_cb) s_link_cb(true, s_link_ctx);
             break;
         case WEBSOCKET_EVENT_DATA: {
-            if (data->op_code == 1 && data->data_len > 0) {
-                ws_msg_t msg = {0};
-                size_t cpy = (data->data_len < WS_COMM_MAX_MSG-1) ? data->data_len : (WS_COMM_MAX_MSG-1);
-                memcpy(msg.data, data->data_ptr, cpy);
-                msg.data[cpy] = 0;
-                msg.len = cpy;
+            if (data->op_code == 1 || (data->op_code == 0 && s_rx_active)) {
                 s_last_rx_ms = now_ms();
-                if (xQueueSend(s_rxq, &msg, 0) != pdTRUE) {
-                    ESP_LOGW(TAG, "RX queue full, drop"); 
+                rx_text(data);
+            } else if (data->op_code == 2 && data->data_len > 0) {
+                // binarne bez slotów RX: ramka większa niż bufor klienta przychodzi w częściach
+                s_last_rx_ms = now_ms();
+                ws_comm_bin_cb_t cb = s_bin_cb;
+                if (cb) {
+                    cb((const uint8_t*)data->data_ptr, (size_t)data->data_len,
+                       (size_t)data->payload_offset, (size_t)data->payload_len, s_bin_ctx);
                 } else {
-                    ESP_LOGI(TAG, "WS RX: %s", msg.data);
+                    s_stats.rx_drop++;
                 }
             }
             break;
         }
         case WEBSOCKET_EVENT_DISCONNECTED:
             s_connected = false;
+            s_stats.disconnects++;
+            rx_abort();
             ESP_LOGW(TAG, "WS disconnected");
+            if (s_link_cb) s_link_cb(false, s_link_ctx);
             break;
         case WEBSOCKET_EVENT_ERROR:
+            s_stats.errors++;
             ESP_LOGW(TAG, "WS error");
             break;
         default:
@@ -69,10 +208,12 @@ static void ws_event_handler(void *arg, esp_event_base_t base, int32_t event_id,
     }
 }
 
-static void ws_send_msg(const ws_msg_t* m) {
+static void ws_send_msg(const char* data, size_t len, bool bin) {
     if (!s_ws || !s_connected) return;
-    int sent = esp_websocket_client_send_text(s_ws, m->data, (int)m->len, pdMS_TO_TICKS(5000));
+    int sent = bin ? esp_websocket_client_send_bin(s_ws, data, (int)len, pdMS_TO_TICKS(5000))
+                   : esp_websocket_client_send_text(s_ws, data, (int)len, pdMS_TO_TICKS(5000));
     if (sent < 0) {
+        s_stats.tx_fail++;
         ESP_LOGW(TAG, "send failed");
     }
 }
@@ -82,6 +223,25 @@ static void ws_comm_task(void* pv) {
     int backoff_idx = 0;
 
     while (s_run) {
+        if (s_pending_uri) {
+            portENTER_CRITICAL(&s_uri_lock);
+            char* uri = s_pending_uri;
+            s_pending_uri = NULL;
+            portEXIT_CRITICAL(&s_uri_lock);
+
+            free(s_uri);
+            s_uri = uri;
+            ESP_LOGI(TAG, "URI changed -> %s", s_uri);
+            if (s_ws) {
+                esp_websocket_client_close(s_ws, pdMS_TO_TICKS(2000));
+                esp_websocket_unregister_events(s_ws, WEBSOCKET_EVENT_ANY, ws_event_handler);
+                esp_websocket_client_destroy(s_ws);
+                s_ws = NULL;
+                s_connected = false;
+            }
+            backoff_idx = 0;
+        }
+
         if (!s_ws) {
             esp_websocket_client_config_t cfg = {
                 .uri = s_uri,
@@ -112,15 +272,14 @@ static void ws_comm_task(void* pv) {
             static int64_t last_hb = 0;
             int64_t t = now_ms();
             if (last_hb == 0) last_hb = t;
-            if (t - last_hb >= WS_COMM_HEARTBEAT_MS) {
-                const char* hb = "{\"type\":\"ping\"}";
-                ws_msg_t m = { .len = strlen(hb) };
-                memcpy(m.data, hb, m.len+1);
-                ws_send_msg(&m);
+            if (t - last_hb >= s_hb_ms) {
+                static const char hb[] = "{\"type\":\"ping\"}";
+                ws_send_msg(hb, sizeof(hb) - 1, false);
                 last_hb = t;
             }
 
-            if (t - s_last_rx_ms > WS_COMM_HEARTBEAT_MS * 2) {
+            if (t - s_last_rx_ms > (int64_t)s_hb_ms * 2) {
+                s_stats.rx_timeouts++;
                 ESP_LOGW(TAG, "RX timeout -> reconnect");
                 esp_websocket_client_close(s_ws, pdMS_TO_TICKS(2000));
                 esp_websocket_unregister_events(s_ws, WEBSOCKET_EVENT_ANY, ws_event_handler);
@@ -130,9 +289,13 @@ static void ws_comm_task(void* pv) {
                 continue;
             }
 
-            ws_msg_t to_send;
-            if (xQueueReceive(s_txq, &to_send, pdMS_TO_TICKS(50)) == pdTRUE) {
-                ws_send_msg(&to_send);
+            // klasa niska tylko przy pustej zwykłej kolejce
+            uint8_t idx;
+            if (xQueueReceive(s_txq, &idx, 0) == pdTRUE ||
+                xQueueReceive(s_txq_low, &idx, 0) == pdTRUE ||
+                xQueueReceive(s_txq, &idx, pdMS_TO_TICKS(50)) == pdTRUE) {
+                ws_send_msg(s_tx_pool[idx].data, s_tx_pool[idx].len, s_tx_pool[idx].bin);
+                xQueueSend(s_tx_free, &idx, 0);
             } else {
                 vTaskDelay(pdMS_TO_TICKS(20));
             }
@@ -151,24 +314,43 @@ static void ws_comm_task(void* pv) {
     vTaskDelete(NULL);
 }
 
+static void ws_comm_free_queues(void) {
+    if (s_txq) { vQueueDelete(s_txq); s_txq = NULL; }
+    if (s_txq_low) { vQueueDelete(s_txq_low); s_txq_low = NULL; }
+    if (s_tx_free) { vQueueDelete(s_tx_free); s_tx_free = NULL; }
+    if (s_rxq) { vQueueDelete(s_rxq); s_rxq = NULL; }
+    if (s_rx_free) { vQueueDelete(s_rx_free); s_rx_free = NULL; }
+    if (s_rx_free_big) { vQueueDelete(s_rx_free_big); s_rx_free_big = NULL; }
+}
+
 esp_err_t ws_comm_start(const char* uri) {
     if (s_task) return ESP_ERR_INVALID_STATE;
     if (!uri) return ESP_ERR_INVALID_ARG;
 
-    s_txq = xQueueCreate(WS_COMM_TX_QUEUE_LEN, sizeof(ws_msg_t));
-    s_rxq = xQueueCreate(WS_COMM_RX_QUEUE_LEN, sizeof(ws_msg_t));
-    if (!s_txq || !s_rxq) {
-        if (s_txq) vQueueDelete(s_txq);
-        if (s_rxq) vQueueDelete(s_rxq);
-        s_txq = s_rxq = NULL;
+    s_txq = xQueueCreate(WS_COMM_TX_QUEUE_LEN, sizeof(uint8_t));
+    s_txq_low = xQueueCreate(WS_COMM_TX_QUEUE_LEN, sizeof(uint8_t));
+    s_tx_free = xQueueCreate(WS_COMM_TX_QUEUE_LEN, sizeof(uint8_t));
+    s_rxq = xQueueCreate(WS_COMM_RX_SLOTS, sizeof(uint8_t));
+    s_rx_free = xQueueCreate(WS_COMM_RX_QUEUE_LEN, sizeof(uint8_t));
+    s_rx_free_big = xQueueCreate(WS_COMM_RX_BIG_SLOTS, sizeof(uint8_t));
+    if (!s_txq || !s_txq_low || !s_tx_free || !s_rxq || !s_rx_free || !s_rx_free_big) {
+        ws_comm_free_queues();
         return ESP_ERR_NO_MEM;
     }
+    for (uint8_t i = 0; i < WS_COMM_TX_QUEUE_LEN; i++) xQueueSend(s_tx_free, &i, 0);
+    for (uint8_t i = 0; i < WS_COMM_RX_SLOTS; i++) {
+        bool big = i >= WS_COMM_RX_QUEUE_LEN;
+        s_rx_pool[i].data = big ? s_rx_big[i - WS_COMM_RX_QUEUE_LEN] : s_rx_small[i];
+        s_rx_pool[i].cap = big ? WS_COMM_RX_BIG_MSG : WS_COMM_RX_MAX_MSG;
+        rx_slot_free(i);
+    }
+    s_rx_asm = WS_COMM_RX_NONE;
+    s_rx_active = false;
 
     size_t ulen = strlen(uri);
     s_uri = (char*)malloc(ulen + 1);
     if (!s_uri) {
-        vQueueDelete(s_txq); vQueueDelete(s_rxq);
-        s_txq = s_rxq = NULL;
+        ws_comm_free_queues();
         return ESP_ERR_NO_MEM;
     }
     memcpy(s_uri, uri, ulen+1);
@@ -180,8 +362,7 @@ esp_err_t ws_comm_start(const char* uri) {
     BaseType_t ok = xTaskCreate(ws_comm_task, "ws_comm_task", 4096, NULL, 5, &s_task);
     if (ok != pdPASS) {
         free(s_uri); s_uri = NULL;
-        vQueueDelete(s_txq); vQueueDelete(s_rxq);
-        s_txq = s_rxq = NULL;
+        ws_comm_free_queues();
         s_run = false;
         return ESP_FAIL;
     }
@@ -202,24 +383,107 @@ void ws_comm_stop(void) {
         s_ws = NULL;
     }
     if (s_uri) { free(s_uri); s_uri = NULL; }
-    if (s_txq) { vQueueDelete(s_txq); s_txq = NULL; }
-    if (s_rxq) { vQueueDelete(s_rxq); s_rxq = NULL; }
+    if (s_pending_uri) { free(s_pending_uri); s_pending_uri = NULL; }
+    ws_comm_free_queues();
     s_connected = false;
     ESP_LOGI(TAG, "WS_COMM stopped");
 }
 
+esp_err_t ws_comm_set_uri(const char* uri) {
+    if (!uri || !uri[0]) return ESP_ERR_INVALID_ARG;
+    if (!s_task) return ESP_ERR_INVALID_STATE;
+
+    size_t ulen = strlen(uri);
+    char* copy = (char*)malloc(ulen + 1);
+    if (!copy) return ESP_ERR_NO_MEM;
+    memcpy(copy, uri, ulen + 1);
+
+    portENTER_CRITICAL(&s_uri_lock);
+    char* old = s_pending_uri;
+    s_pending_uri = copy;
+    portEXIT_CRITICAL(&s_uri_lock);
+    free(old);
+    return ESP_OK;
+}
+
+esp_err_t ws_comm_set_heartbeat_ms(uint32_t ms) {
+    if (ms < 1000) return ESP_ERR_INVALID_ARG;
+    s_hb_ms = ms;
+    return ESP_OK;
+}
+
+void ws_comm_set_link_cb(ws_comm_link_cb_t cb, void* ctx) {
+    s_link_cb = NULL;
+    s_link_ctx = ctx;
+    s_link_cb = cb;
+}
+
 bool ws_comm_is_connected(void) {
     return s_connected;
 }
 
+void ws_comm_set_bin_cb(ws_comm_bin_cb_t cb, void* ctx) {
+    s_bin_cb = NULL;
+    s_bin_ctx = ctx;
+    s_bin_cb = cb;
+}
+
+void ws_comm_get_stats(ws_comm_stats_t* out) {
+    if (out) *out = s_stats;
+}
+
+esp_err_t ws_comm_tx_reserve(ws_tx_slot_t* slot, TickType_t to) {
+    if (!slot) return ESP_ERR_INVALID_ARG;
+    if (!s_tx_free) return ESP_ERR_INVALID_STATE;
+    uint8_t idx;
+    if (xQueueReceive(s_tx_free, &idx, to) != pdTRUE) return ESP_ERR_TIMEOUT;
+    slot->idx = idx;
+    slot->low = 0;
+    slot->bin = 0;
+    slot->buf = s_tx_pool[idx].data;
+    slot->cap = WS_COMM_MAX_MSG;
+    return ESP_OK;
+}
+
+esp_err_t ws_comm_tx_reserve_low(ws_tx_slot_t* slot) {
+    if (!slot) return ESP_ERR_INVALID_ARG;
+    if (!s_tx_free) return ESP_ERR_INVALID_STATE;
+    if (uxQueueMessagesWaiting(s_tx_free) <= WS_COMM_TX_LOW_MIN_FREE) return ESP_ERR_TIMEOUT;
+    esp_err_t err = ws_comm_tx_reserve(slot, 0);
+    if (err == ESP_OK) slot->low = 1;
+    return err;
+}
+
+esp_err_t ws_comm_tx_commit(ws_tx_slot_t* slot, size_t len) {
+    if (!slot || !slot->buf) return ESP_ERR_INVALID_ARG;
+    if (len > slot->cap) {
+        ws_comm_tx_cancel(slot);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    uint8_t idx = slot->idx;
+    s_tx_pool[idx].len = len;
+    s_tx_pool[idx].bin = slot->bin;
+    slot->buf = NULL;
+    // zawsze jest miejsce: w obiegu jest dokładnie WS_COMM_TX_QUEUE_LEN indeksów
+    xQueueSend(slot->low ? s_txq_low : s_txq, &idx, 0);
+    return ESP_OK;
+}
+
+void ws_comm_tx_cancel(ws_tx_slot_t* slot) {
+    if (!slot || !slot->buf) return;
+    xQueueSend(s_tx_free, &slot->idx, 0);
+    slot->buf = NULL;
+}
+
 esp_err_t ws_comm_send_text_timeout(const char* text, TickType_t to) {
-    if (!text || !s_txq) return ESP_ERR_INVALID_STATE;
-    ws_msg_t msg = {0};
-    size_t len = strnlen(text, WS_COMM_MAX_MSG-1);
-    memcpy(msg.data, text, len);
-    msg.data[len] = 0;
-    msg.len = len;
-    return xQueueSend(s_txq, &msg, to) == pdTRUE ? ESP_OK : ESP_ERR_TIMEOUT;
+    if (!text) return ESP_ERR_INVALID_STATE;
+    ws_tx_slot_t slot;
+    esp_err_t err = ws_comm_tx_reserve(&slot, to);
+    if (err != ESP_OK) return err;
+    size_t len = strnlen(text, slot.cap - 1);
+    memcpy(slot.buf, text, len);
+    slot.buf[len] = 0;
+    return ws_comm_tx_commit(&slot, len);
 }
 
 esp_err_t ws_comm_send_text(const char* text) {
@@ -227,15 +491,32 @@ esp_err_t ws_comm_send_text(const char* text) {
 }
 
 bool ws_comm_recv_text(char* out, size_t out_len, TickType_t to) {
-    if (!out || out_len == 0 || !s_rxq) return false;
-    ws_msg_t msg;
-    if (xQueueReceive(s_rxq, &msg, to) != pdTRUE) return false;
-    size_t cpy = (msg.len < out_len-1) ? msg.len : (out_len-1);
-    memcpy(out, msg.data, cpy);
+    if (!out || out_len == 0) return false;
+    ws_rx_slot_t slot;
+    if (!ws_comm_rx_take(&slot, to)) return false;
+    size_t cpy = (slot.len < out_len-1) ? slot.len : (out_len-1);
+    memcpy(out, slot.buf, cpy);
     out[cpy] = 0;
+    ws_comm_rx_release(&slot);
     return true;
 }
 
+bool ws_comm_rx_take(ws_rx_slot_t* slot, TickType_t to) {
+    if (!slot || !s_rxq) return false;
+    uint8_t idx;
+    if (xQueueReceive(s_rxq, &idx, to) != pdTRUE) return false;
+    slot->idx = idx;
+    slot->buf = s_rx_pool[idx].data;
+    slot->len = s_rx_pool[idx].len;
+    return true;
+}
+
+void ws_comm_rx_release(ws_rx_slot_t* slot) {
+    if (!slot || !slot->buf || !s_rx_free) return;
+    rx_slot_free(slot->idx);
+    slot->buf = NULL;
+}
+
 size_t ws_comm_tx_queued(void) {
     if (!s_txq) return 0;
     return (size_t)uxQueueMessagesWaiting(s_txq);
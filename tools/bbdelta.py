@@ -0,0 +1,318 @@
+#!/usr/bin/env python3
+"""Create and apply BootBone delta OTA patches (main/bb_delta.c).
+
+A patch rebuilds a new application image from the one running on the device,
+so only the differences travel over the network. Matching follows bsdiff:
+long regions of the new image are paired with regions of the old one and
+stored as byte-wise differences, which stay mostly zero when code only moved
+(relocated addresses differ in a byte or two). Zero runs become COPY ops, so
+the patch is small even without compression.
+
+Format (little-endian, lengths as LEB128 varints):
+
+  header  "BBD1" | u32 old_size | u32 new_size | old_sha256[32]
+  0x00 COPY n        new += old[pos:pos+n]; pos += n
+  0x01 ADD  n, d[n]  new += old[pos+i] + d[i] (mod 256); pos += n
+  0x02 DATA n, d[n]  new += d
+  0x03 SEEK z        pos += zigzag(z)
+  0x04 END
+
+The device checks old_sha256 against its running slot before writing and the
+sha256 of the result (ota_begin) at the end.
+
+Example:
+  tools/bbdelta.py diff old/BootBone.bin build/BootBone.bin build/BootBone.bbd
+  tools/bbdelta.py apply old/BootBone.bin build/BootBone.bbd check.bin
+  tools/bbdelta.py selftest
+  tools/ota_server.py build/BootBone.bin --base old/BootBone.bin
+"""
+
+import argparse
+import hashlib
+import os
+import random
+import struct
+import sys
+import time
+
+MAGIC = b'BBD1'
+HDR = struct.Struct('<4sII32s')
+OP_COPY, OP_ADD, OP_DATA, OP_SEEK, OP_END = range(5)
+KEY = 8             # bytes hashed to find match candidates
+STEP = 4            # old image indexed every STEP bytes (match loses < STEP bytes)
+MIN_ZERO_RUN = 6    # zero run inside an ADD region worth a separate COPY op
+
+
+def _varint(n):
+    out = bytearray()
+    while True:
+        b = n & 0x7F
+        n >>= 7
+        if n:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return bytes(out)
+
+
+def _match_len(a, ai, b, bi):
+    """Length of the common prefix of a[ai:] and b[bi:]."""
+    n = min(len(a) - ai, len(b) - bi)
+    lo = 0
+    step = 256
+    while lo < n:
+        m = min(step, n - lo)
+        if a[ai + lo:ai + lo + m] == b[bi + lo:bi + lo + m]:
+            lo += m
+            step *= 2
+        elif m <= 16:
+            while lo < n and a[ai + lo] == b[bi + lo]:
+                lo += 1
+            return lo
+        else:
+            step = max(16, m // 4)
+    return lo
+
+
+class Matcher:
+    def __init__(self, old):
+        self.old = old
+        self.index = {}
+        for i in range(0, len(old) - KEY + 1, STEP):
+            self.index.setdefault(old[i:i + KEY], i)
+
+    def search(self, new, scan, hint):
+        """(pos, length) of a long match for new[scan:], trying `hint` first."""
+        old = self.old
+        best_pos, best_len = 0, 0
+        if 0 <= hint < len(old):
+            best_pos, best_len = hint, _match_len(old, hint, new, scan)
+        for d in range(STEP):
+            pos = self.index.get(new[scan + d:scan + d + KEY])
+            if pos is None or pos < d:
+                continue
+            n = _match_len(old, pos - d, new, scan)
+            if n > best_len:
+                best_pos, best_len = pos - d, n
+        return best_pos, best_len
+
+
+def _add_ops(out, old, opos, new, npos, n):
+    """Byte-wise difference of new[npos:npos+n] against old[opos:]."""
+    diff = bytes((new[npos + i] - old[opos + i]) & 0xFF for i in range(n))
+    i = 0
+    while i < n:
+        j = i
+        if diff[i] == 0:
+            while j < n and diff[j] == 0:
+                j += 1
+            out += bytes([OP_COPY]) + _varint(j - i)
+            i = j
+            continue
+        # ADD until a zero run long enough to pay for a separate COPY op
+        while j < n:
+            if diff[j]:
+                j += 1
+                continue
+            z = j
+            while z < n and diff[z] == 0:
+                z += 1
+            if z - j >= MIN_ZERO_RUN or z == n:
+                break
+            j = z
+        out += bytes([OP_ADD]) + _varint(j - i) + diff[i:j]
+        i = j
+
+
+def diff(old, new):
+    """Patch turning `old` into `new` (bsdiff scan, BBD1 encoding)."""
+    m = Matcher(old)
+    out = bytearray(HDR.pack(MAGIC, len(old), len(new), hashlib.sha256(old).digest()))
+    oldsize, newsize = len(old), len(new)
+    scan = length = pos = 0
+    lastscan = lastpos = lastoffset = 0
+    while scan < newsize:
+        oldscore = 0
+        scan += length
+        scsc = scan
+        while scan < newsize:
+            pos, length = m.search(new, scan, scan + lastoffset)
+            while scsc < scan + length:
+                if scsc + lastoffset < oldsize and old[scsc + lastoffset] == new[scsc]:
+                    oldscore += 1
+                scsc += 1
+            if (length == oldscore and length != 0) or length > oldscore + 8:
+                break
+            if scan + lastoffset < oldsize and old[scan + lastoffset] == new[scan]:
+                oldscore -= 1
+            scan += 1
+        if length == oldscore and scan != newsize:
+            continue
+
+        # forward extension from the previous match, backward from this one
+        s = sf = lenf = 0
+        i = 0
+        while lastscan + i < scan and lastpos + i < oldsize:
+            if old[lastpos + i] == new[lastscan + i]:
+                s += 1
+            i += 1
+            if s * 2 - i > sf * 2 - lenf:
+                sf, lenf = s, i
+        lenb = 0
+        if scan < newsize:
+            s = sb = 0
+            i = 1
+            while scan >= lastscan + i and pos >= i:
+                if old[pos - i] == new[scan - i]:
+                    s += 1
+                if s * 2 - i > sb * 2 - lenb:
+                    sb, lenb = s, i
+                i += 1
+        if lastscan + lenf > scan - lenb:
+            overlap = (lastscan + lenf) - (scan - lenb)
+            s = ss = lens = 0
+            for i in range(overlap):
+                if new[lastscan + lenf - overlap + i] == old[lastpos + lenf - overlap + i]:
+                    s += 1
+                if new[scan - lenb + i] == old[pos - lenb + i]:
+                    s -= 1
+                if s > ss:
+                    ss, lens = s, i + 1
+            lenf += lens - overlap
+            lenb -= lens
+
+        if lenf:
+            _add_ops(out, old, lastpos, new, lastscan, lenf)
+        extra = (scan - lenb) - (lastscan + lenf)
+        if extra:
+            out += bytes([OP_DATA]) + _varint(extra) + new[lastscan + lenf:scan - lenb]
+        seek = (pos - lenb) - (lastpos + lenf)
+        if seek and scan < newsize:
+            out += bytes([OP_SEEK]) + _varint(seek << 1 if seek >= 0 else (-seek << 1) - 1)
+        lastscan, lastpos, lastoffset = scan - lenb, pos - lenb, pos - scan
+    out.append(OP_END)
+    return bytes(out)
+
+
+def _read_varint(p, i):
+    n = shift = 0
+    while True:
+        b = p[i]
+        i += 1
+        n |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return n, i
+
+
+def apply(old, patch):
+    """Reference decoder, same checks as the device."""
+    magic, old_size, new_size, old_sha = HDR.unpack_from(patch)
+    if magic != MAGIC:
+        raise ValueError('not a BBD1 patch')
+    if old_size > len(old) or hashlib.sha256(old[:old_size]).digest() != old_sha:
+        raise ValueError('patch was made for a different base image')
+    new = bytearray()
+    i, pos = HDR.size, 0
+    while True:
+        op = patch[i]
+        i += 1
+        if op == OP_END:
+            break
+        n, i = _read_varint(patch, i)
+        if op == OP_COPY:
+            new += old[pos:pos + n]
+            pos += n
+        elif op == OP_ADD:
+            new += bytes((a + b) & 0xFF for a, b in zip(old[pos:pos + n], patch[i:i + n]))
+            pos += n
+            i += n
+        elif op == OP_DATA:
+            new += patch[i:i + n]
+            i += n
+        elif op == OP_SEEK:
+            pos += (n >> 1) ^ -(n & 1)
+        else:
+            raise ValueError('bad op 0x%02x at %d' % (op, i - 1))
+        if pos > old_size or len(new) > new_size:
+            raise ValueError('patch out of bounds at %d' % i)
+    if len(new) != new_size or i != len(patch):
+        raise ValueError('truncated or oversized patch')
+    return bytes(new)
+
+
+def _synthetic(size, seed):
+    """Firmware-like pair: code with relocated pointers, inserted and removed blocks."""
+    rnd = random.Random(seed)
+    words = [rnd.choice((rnd.randrange(1 << 32), 0x42000000 + rnd.randrange(size), rnd.randrange(256)))
+             for _ in range(size // 4)]
+    old = struct.pack('<%dI' % len(words), *words)
+    new_words = []
+    shift = 0
+    for i, w in enumerate(words):
+        if i % 5000 == 100:
+            ins = [rnd.randrange(1 << 32) for _ in range(rnd.randrange(1, 64))]
+            new_words += ins
+            shift += 4 * len(ins)
+        if i % 7000 == 200:
+            continue
+        new_words.append(w + shift if 0x42000000 <= w < 0x42000000 + size else w)
+    return old, struct.pack('<%dI' % len(new_words), *new_words)
+
+
+def selftest():
+    for size, seed in ((4096, 1), (300000, 2)):
+        old, new = _synthetic(size, seed)
+        t0 = time.monotonic()
+        patch = diff(old, new)
+        dt = time.monotonic() - t0
+        if apply(old, patch) != new:
+            print('FAIL: size %d seed %d' % (size, seed))
+            return 1
+        print('%7d -> %7d B: patch %6d B (%.1fx) in %.1f s' %
+              (len(old), len(new), len(patch), len(new) / len(patch), dt))
+    for old, new in ((b'', b'abc'), (b'abc', b''), (b'x' * 100, b'x' * 100), (os.urandom(5000), os.urandom(5000))):
+        if apply(old, diff(old, new)) != new:
+            print('FAIL: edge case %d -> %d B' % (len(old), len(new)))
+            return 1
+    print('ok')
+    return 0
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = ap.add_subparsers(dest='cmd', required=True)
+    p = sub.add_parser('diff', help='create a patch')
+    p.add_argument('old')
+    p.add_argument('new')
+    p.add_argument('patch')
+    p = sub.add_parser('apply', help='rebuild the new image from old + patch')
+    p.add_argument('old')
+    p.add_argument('patch')
+    p.add_argument('new')
+    sub.add_parser('selftest', help='round-trip synthetic images')
+    args = ap.parse_args()
+
+    if args.cmd == 'selftest':
+        return selftest()
+    with open(args.old, 'rb') as f:
+        old = f.read()
+    if args.cmd == 'diff':
+        with open(args.new, 'rb') as f:
+            new = f.read()
+        patch = diff(old, new)
+        with open(args.patch, 'wb') as f:
+            f.write(patch)
+        print('%s: %d B for %d B image (%.1fx smaller)' % (args.patch, len(patch), len(new), len(new) / len(patch)))
+    else:
+        with open(args.patch, 'rb') as f:
+            patch = f.read()
+        new = apply(old, patch)
+        with open(args.new, 'wb') as f:
+            f.write(new)
+        print('%s: %d B, sha256 %s' % (args.new, len(new), hashlib.sha256(new).hexdigest()))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
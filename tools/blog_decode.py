@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""Decode BootBone deferred binary log records (BB_BLOGx, main/bb_blog.c).
+
+In "host" mode the device does not format BB_BLOGx lines; it sends the raw
+records instead:
+
+  {"v":1,"type":"blog","elf":"<sha256 prefix>","d":"<hex records>"}
+
+Each record is [u8 len][u8 argc][u16 types][u32 desc][u32 ts_ms] followed by
+the arguments (2 bits of `types` per argument: 0 = u32, 1 = u64, 2 = double,
+3 = string as [u8 n][bytes]). `desc` is the address of a static
+bb_blog_desc_t {u8 level; const char* tag; const char* fmt} in the firmware,
+so the format strings are read back from the ELF of the same build
+(build/BootBone.elf). The "elf" field is checked against the ELF SHA256 so a
+stale file is reported instead of printing garbage.
+
+Input: server log with one JSON message per line (other lines are ignored), or
+bare hex strings with --hex.
+
+Example:
+  tools/blog_decode.py build/BootBone.elf ws_messages.jsonl
+  tools/blog_decode.py build/BootBone.elf --hex 10010000c0424000d2040000...
+"""
+
+import argparse
+import hashlib
+import json
+import re
+import struct
+import sys
+
+LEVELS = 'NEWIDV'
+HDR = struct.Struct('<BBHII')
+SPEC_RE = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|L|q|j|z|t)?([diouxXcsfFeEgGaAp%])')
+
+
+class Elf:
+    """Minimal ELF32 little-endian reader: virtual address -> bytes."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        d = self.data
+        if d[:4] != b'\x7fELF' or d[4] != 1 or d[5] != 1:
+            raise ValueError('%s: not a little-endian ELF32 file' % path)
+        shoff, = struct.unpack_from('<I', d, 0x20)
+        shentsize, shnum = struct.unpack_from('<HH', d, 0x2E)
+        self.sections = []
+        for i in range(shnum):
+            off = shoff + i * shentsize
+            sh_type, _, addr, offset, size = struct.unpack_from('<IIIII', d, off + 4)
+            if addr and sh_type != 8:           # SHT_NOBITS (.bss) has no file data
+                self.sections.append((addr, offset, size))
+        self.sha256 = hashlib.sha256(d).hexdigest()
+
+    def read(self, addr, n):
+        for base, offset, size in self.sections:
+            if base <= addr and addr + n <= base + size:
+                start = offset + addr - base
+                return self.data[start:start + n]
+        raise KeyError('address 0x%08x not in ELF' % addr)
+
+    def cstr(self, addr):
+        for base, offset, size in self.sections:
+            if base <= addr < base + size:
+                start = offset + addr - base
+                end = self.data.index(b'\0', start, offset + size)
+                return self.data[start:end].decode('utf-8', 'replace')
+        raise KeyError('address 0x%08x not in ELF' % addr)
+
+
+def parse_args(rec, argc, types):
+    args, off = [], HDR.size
+    for i in range(argc):
+        t = (types >> (2 * i)) & 3
+        if t == 0:
+            args.append(struct.unpack_from('<I', rec, off)[0])
+            off += 4
+        elif t == 1:
+            args.append(struct.unpack_from('<Q', rec, off)[0])
+            off += 8
+        elif t == 2:
+            args.append(struct.unpack_from('<d', rec, off)[0])
+            off += 8
+        else:
+            n = rec[off]
+            args.append(rec[off + 1:off + 1 + n].decode('utf-8', 'replace'))
+            off += 1 + n
+    return args
+
+
+def signed(v, bits):
+    return v - (1 << bits) if v >= 1 << (bits - 1) else v
+
+
+def c_format(fmt, args):
+    """printf-style formatting of the record arguments, as bb_blog.c does."""
+    it = iter(args)
+
+    def take():
+        return next(it, None)
+
+    def conv(m):
+        flags, width, prec, length, c = m.groups()
+        if c == '%':
+            return '%'
+        if width == '*':
+            width = str(take() or 0)
+        if prec == '*':
+            prec = str(take() or 0)
+        spec = '%' + flags + (width or '') + ('.' + prec if prec is not None else '')
+        v = take()
+        if v is None:
+            return '<?>'
+        if c == 's':
+            return (spec + 's') % v if isinstance(v, str) else '<?>'
+        if c in 'fFeEgGaA':
+            return (spec + ('f' if c in 'aA' else c)) % v if isinstance(v, float) else '<?>'
+        if not isinstance(v, int):
+            return '<?>'
+        bits = 64 if length in ('ll', 'q', 'j') or v >= 1 << 32 else 32
+        if c == 'p':
+            return '0x%08x' % v
+        if c in 'di':
+            return (spec + 'd') % signed(v, bits)
+        if c == 'u':
+            return (spec + 'd') % v
+        if c == 'c':
+            return chr(v & 0xFF)
+        return (spec + c) % v
+
+    return SPEC_RE.sub(conv, fmt)
+
+
+def decode(elf, blob):
+    out, off = [], 0
+    while off + HDR.size <= len(blob):
+        n, argc, types, desc, ts = HDR.unpack_from(blob, off)
+        if n < HDR.size or off + n > len(blob):
+            out.append('<truncated record at %d>' % off)
+            break
+        rec = blob[off:off + n]
+        off += n
+        try:
+            level, = struct.unpack('<B', elf.read(desc, 1))
+            tag_ptr, fmt_ptr = struct.unpack('<II', elf.read(desc + 4, 8))
+            tag, fmt = elf.cstr(tag_ptr), elf.cstr(fmt_ptr)
+        except (KeyError, ValueError) as e:
+            out.append('? (%u) <unknown descriptor 0x%08x: %s>' % (ts, desc, e))
+            continue
+        text = c_format(fmt, parse_args(rec, argc, types))
+        out.append('%s (%u) %s: %s' % (LEVELS[level] if level < len(LEVELS) else '?', ts, tag, text))
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('elf', help='firmware ELF of the running build')
+    ap.add_argument('input', nargs='*', help='JSON-lines files (default: stdin)')
+    ap.add_argument('--hex', action='store_true', help='inputs are hex record strings, not files')
+    args = ap.parse_args()
+
+    elf = Elf(args.elf)
+    if args.hex:
+        for h in args.input:
+            print('\n'.join(decode(elf, bytes.fromhex(h))))
+        return 0
+
+    files = [open(p) for p in args.input] or [sys.stdin]
+    warned = set()
+    for f in files:
+        for line in f:
+            line = line.strip()
+            if not line.startswith('{'):
+                continue
+            try:
+                msg = json.loads(line)
+            except ValueError:
+                continue
+            if msg.get('type') != 'blog':
+                continue
+            fw = msg.get('elf', '')
+            if fw and not elf.sha256.startswith(fw) and fw not in warned:
+                warned.add(fw)
+                print('warning: records from build %s, ELF is %s' % (fw, elf.sha256[:len(fw)]), file=sys.stderr)
+            print('\n'.join(decode(elf, bytes.fromhex(msg.get('d', '')))))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,133 @@
+// Host test dekodera main/bb_delta.c: łatki z tools/bbdelta.py diff podawane
+// kawałkami różnej wielkości, wynik porównywany bajt w bajt z new.bin.
+//   make test
+#include "bb_delta.h"
+#include "mbedtls/sha256.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const size_t s_chunks[] = { 1, 7, 512, 4096, 0 };     // 0 = cała łatka naraz
+
+static uint8_t* s_out;
+static size_t s_out_len;
+static size_t s_out_cap;
+static int s_failures;
+
+static esp_err_t out_cb(const uint8_t* data, size_t len) {
+    if (len > s_out_cap - s_out_len) return ESP_ERR_INVALID_SIZE;
+    memcpy(s_out + s_out_len, data, len);
+    s_out_len += len;
+    return ESP_OK;
+}
+
+static uint8_t* read_file(const char* dir, const char* name, size_t* len) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        exit(2);
+    }
+    fseek(f, 0, SEEK_END);
+    *len = (size_t)ftell(f);
+    rewind(f);
+    uint8_t* buf = malloc(*len ? *len : 1);
+    if (fread(buf, 1, *len, f) != *len) {
+        perror(path);
+        exit(2);
+    }
+    fclose(f);
+    return buf;
+}
+
+// Cała łatka przez bb_delta_feed po chunk bajtów
+static esp_err_t apply(const esp_partition_t* base, const uint8_t* patch, size_t plen, size_t new_size, size_t chunk) {
+    s_out_len = 0;
+    esp_err_t err = bb_delta_begin(base, new_size, out_cb);
+    if (chunk == 0) chunk = plen;
+    for (size_t off = 0; off < plen && err == ESP_OK; off += chunk) {
+        err = bb_delta_feed(patch + off, plen - off < chunk ? plen - off : chunk);
+    }
+    return err;
+}
+
+static void check(const char* name, size_t chunk, bool ok, const char* what) {
+    printf("%-5s %-16s chunk %5zu  %s\n", ok ? "ok" : "FAIL", name, chunk, what);
+    if (!ok) s_failures++;
+}
+
+static void run_case(const char* dir) {
+    const char* name = strrchr(dir, '/') ? strrchr(dir, '/') + 1 : dir;
+    size_t old_len, new_len, plen;
+    uint8_t* old = read_file(dir, "old.bin", &old_len);
+    uint8_t* new_img = read_file(dir, "new.bin", &new_len);
+    uint8_t* patch = read_file(dir, "patch.bbd", &plen);
+
+    // slot większy niż obraz, jak na urządzeniu
+    size_t slot = old_len + 4096;
+    uint8_t* flash = malloc(slot);
+    memset(flash, 0xFF, slot);
+    memcpy(flash, old, old_len);
+    esp_partition_t base = { .data = flash, .size = (uint32_t)slot, .label = "app0" };
+    s_out_cap = new_len;
+    s_out = malloc(new_len ? new_len : 1);
+
+    for (size_t i = 0; i < sizeof(s_chunks) / sizeof(s_chunks[0]); i++) {
+        esp_err_t err = apply(&base, patch, plen, new_len, s_chunks[i]);
+        bool ok = err == ESP_OK && bb_delta_done() && s_out_len == new_len && memcmp(s_out, new_img, new_len) == 0;
+        check(name, s_chunks[i], ok, ok ? "identical" : esp_err_to_name(err));
+    }
+
+    // inna baza niż w nagłówku łatki: odrzucona przed pierwszym bajtem wyniku
+    if (old_len) {
+        flash[old_len / 2] ^= 0x01;
+        esp_err_t err = apply(&base, patch, plen, new_len, 4096);
+        check(name, 4096, err == ESP_ERR_INVALID_CRC && s_out_len == 0, "wrong base rejected");
+        flash[old_len / 2] ^= 0x01;
+    }
+    // urwana łatka: bez END nie jest gotowa
+    if (plen > BB_DELTA_HDR_SIZE + 1) {
+        apply(&base, patch, plen - 1, new_len, 512);
+        check(name, 512, !bb_delta_done(), "truncated patch not done");
+    }
+
+    free(s_out);
+    free(flash);
+    free(patch);
+    free(new_img);
+    free(old);
+}
+
+// Varint dłuższy niż 32 bity (5. bajt z bitami powyżej 0x0F) jest błędem
+static void run_varint_overflow(void) {
+    static uint8_t old[64];
+    esp_partition_t base = { .data = old, .size = sizeof(old), .label = "app0" };
+    uint8_t patch[BB_DELTA_HDR_SIZE + 6] = "BBD1";
+    patch[4] = sizeof(old);                         // old_size, new_size = 16
+    patch[8] = 16;
+    mbedtls_sha256_context sha;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+    mbedtls_sha256_update(&sha, old, sizeof(old));
+    mbedtls_sha256_finish(&sha, patch + 12);
+    static const uint8_t op[] = { 0x02, 0x90, 0x80, 0x80, 0x80, 0x10 };    // DATA 16 + 2^32
+    memcpy(patch + BB_DELTA_HDR_SIZE, op, sizeof(op));
+
+    s_out_cap = 16;
+    s_out = malloc(16);
+    esp_err_t err = apply(&base, patch, sizeof(patch), 16, 0);
+    check("varint_overflow", sizeof(patch), err == ESP_ERR_INVALID_SIZE, "rejected");
+    free(s_out);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s CASE_DIR...   (gen_cases.py writes them)\n", argv[0]);
+        return 2;
+    }
+    for (int i = 1; i < argc; i++) run_case(argv[i]);
+    run_varint_overflow();
+    printf("%s: %d failure(s)\n", s_failures ? "FAIL" : "PASS", s_failures);
+    return s_failures ? 1 : 0;
+}
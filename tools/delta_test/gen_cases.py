@@ -0,0 +1,46 @@
+#!/usr/bin/env python3
+"""Write old/new image pairs and their patches for the delta_test harness.
+
+Each case directory gets old.bin, new.bin and patch.bbd made with
+tools/bbdelta.py diff, the same code that tools/ota_server.py --base uses.
+"""
+
+import argparse
+import os
+import random
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+import bbdelta  # noqa: E402
+
+
+def cases():
+    rnd = random.Random(45)
+    base = bytes(rnd.randrange(256) for _ in range(50000))
+    yield 'synthetic_4k', bbdelta._synthetic(4096, 1)
+    yield 'synthetic_300k', bbdelta._synthetic(300000, 2)
+    yield 'identical', (base, base)
+    yield 'unrelated', (base, bytes(rnd.randrange(256) for _ in range(41000)))
+    yield 'grow', (base, base[:20000] + bytes(rnd.randrange(256) for _ in range(3000)) + base[20000:] + base[:5000])
+    yield 'shrink', (base, base[:10000] + base[18000:30000] + base[44000:])
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__)
+    ap.add_argument('outdir')
+    args = ap.parse_args()
+    for name, (old, new) in cases():
+        d = os.path.join(args.outdir, name)
+        os.makedirs(d, exist_ok=True)
+        patch = bbdelta.diff(old, new)
+        if bbdelta.apply(old, patch) != new:
+            raise SystemExit('%s: bbdelta.py round trip failed' % name)
+        for fn, data in (('old.bin', old), ('new.bin', new), ('patch.bbd', patch)):
+            with open(os.path.join(d, fn), 'wb') as f:
+                f.write(data)
+        print('%-16s %7d -> %7d B, patch %6d B' % (name, len(old), len(new), len(patch)))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,13 @@
+// Host stub: partycja = bufor w RAM (delta_test.c)
+#pragma once
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    const uint8_t* data;
+    uint32_t size;
+    char label[17];
+} esp_partition_t;
+
+esp_err_t esp_partition_read(const esp_partition_t* part, size_t offset, void* dst, size_t size);
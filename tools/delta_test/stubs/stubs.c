@@ -0,0 +1,104 @@
+#include "esp_err.h"
+#include "esp_partition.h"
+#include "mbedtls/sha256.h"
+#include <stdio.h>
+#include <string.h>
+
+const char* esp_err_to_name(esp_err_t err) {
+    switch (err) {
+    case ESP_OK:                  return "ESP_OK";
+    case ESP_FAIL:                return "ESP_FAIL";
+    case ESP_ERR_INVALID_ARG:     return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_SIZE:    return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_INVALID_CRC:     return "ESP_ERR_INVALID_CRC";
+    case ESP_ERR_INVALID_VERSION: return "ESP_ERR_INVALID_VERSION";
+    default:                      return "ESP_ERR_?";
+    }
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* part, size_t offset, void* dst, size_t size) {
+    if (offset > part->size || size > part->size - offset) return ESP_ERR_INVALID_SIZE;
+    memcpy(dst, part->data + offset, size);
+    return ESP_OK;
+}
+
+// ===== SHA-256 (FIPS 180-4) =====
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define ROR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void block(mbedtls_sha256_context* c, const uint8_t* p) {
+    uint32_t w[64], s[8];
+    for (int i = 0; i < 16; i++) w[i] = (uint32_t)p[4 * i] << 24 | p[4 * i + 1] << 16 | p[4 * i + 2] << 8 | p[4 * i + 3];
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ROR(w[i - 15], 7) ^ ROR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROR(w[i - 2], 17) ^ ROR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    memcpy(s, c->state, sizeof(s));
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = s[7] + (ROR(s[4], 6) ^ ROR(s[4], 11) ^ ROR(s[4], 25)) + ((s[4] & s[5]) ^ (~s[4] & s[6])) + K[i] + w[i];
+        uint32_t t2 = (ROR(s[0], 2) ^ ROR(s[0], 13) ^ ROR(s[0], 22)) + ((s[0] & s[1]) ^ (s[0] & s[2]) ^ (s[1] & s[2]));
+        memmove(s + 1, s, 7 * sizeof(s[0]));
+        s[4] += t1;
+        s[0] = t1 + t2;
+    }
+    for (int i = 0; i < 8; i++) c->state[i] += s[i];
+}
+
+void mbedtls_sha256_init(mbedtls_sha256_context* ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+void mbedtls_sha256_free(mbedtls_sha256_context* ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+int mbedtls_sha256_starts(mbedtls_sha256_context* ctx, int is224) {
+    static const uint32_t iv[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+    memcpy(ctx->state, iv, sizeof(iv));
+    ctx->len = 0;
+    ctx->fill = 0;
+    return 0;
+}
+
+int mbedtls_sha256_update(mbedtls_sha256_context* ctx, const unsigned char* input, size_t ilen) {
+    ctx->len += ilen;
+    while (ilen) {
+        size_t n = 64 - ctx->fill < ilen ? 64 - ctx->fill : ilen;
+        memcpy(ctx->buf + ctx->fill, input, n);
+        ctx->fill += n;
+        input += n;
+        ilen -= n;
+        if (ctx->fill == 64) {
+            block(ctx, ctx->buf);
+            ctx->fill = 0;
+        }
+    }
+    return 0;
+}
+
+int mbedtls_sha256_finish(mbedtls_sha256_context* ctx, unsigned char output[32]) {
+    uint64_t bits = ctx->len * 8;
+    uint8_t pad[72] = { 0x80 };
+    size_t n = (ctx->fill < 56 ? 56 : 120) - ctx->fill;
+    for (int i = 0; i < 8; i++) pad[n + i] = (uint8_t)(bits >> (56 - 8 * i));
+    mbedtls_sha256_update(ctx, pad, n + 8);
+    for (int i = 0; i < 8; i++) {
+        output[4 * i] = ctx->state[i] >> 24;
+        output[4 * i + 1] = ctx->state[i] >> 16;
+        output[4 * i + 2] = ctx->state[i] >> 8;
+        output[4 * i + 3] = ctx->state[i];
+    }
+    return 0;
+}
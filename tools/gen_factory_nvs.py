@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""Generate per-device factory NVS partition images for BootBone.
+
+Parameter names, NVS keys, types and defaults are read from the registry in
+main/include/bbapi_params.h, so the image always matches the firmware. Each
+device row of the manifest overrides the defaults; the result is a complete
+"boneboot" namespace plus bbapi_init_flag = 2 (factory image), which makes
+BBAPI_init skip writing defaults on first boot.
+
+Manifest formats:
+  CSV  - header row with parameter names, one device per row
+  JSON - list of device objects, or {"defaults": {...}, "devices": [...]}
+
+Example:
+  tools/gen_factory_nvs.py batch.csv -o build/factory
+  esptool.py -p PORT write_flash 0x9000 build/factory/SN-00001234.bin
+"""
+
+import argparse
+import csv
+import json
+import os
+import re
+import subprocess
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+PARAMS_H = os.path.join(ROOT, 'main', 'include', 'bbapi_params.h')
+PARTITIONS_CSV = os.path.join(ROOT, 'partitions.csv')
+
+NVS_NAMESPACE = 'boneboot'          # NVS_NAMESPACE in nvs_store.c
+INIT_FLAG_KEY = 'bbapi_init_flag'
+INIT_FLAG_FACTORY = 2               # BBAPI_INIT_FLAG_FACTORY in bbapi.c
+REQUIRED = ('device_id', 'serial_number', 'pub_key_hash')
+
+X_RE = re.compile(r'X\(\s*(\w+)\s*,\s*"([^"]*)"\s*,\s*(STR|U32)\s*,\s*"([^"]*)"\s*,\s*(.+?)\s*,\s*(\d+)\s*,\s*(RO|RW)\s*\)')
+
+
+MAKE_VERSION_RE = re.compile(r'MAKE_VERSION\(\s*(\w+)\s*,\s*(\w+)\s*,\s*(\w+)\s*,\s*(\w+)\s*\)$')
+
+
+def make_version(major, minor, patch, build):
+    return (major << 24) | (minor << 16) | (patch << 8) | build
+
+
+def parse_u32_default(expr):
+    """U32 default from bbapi_params.h: an integer literal or MAKE_VERSION(a, b, c, d)."""
+    expr = expr.strip()
+    try:
+        m = MAKE_VERSION_RE.match(expr)
+        value = make_version(*(int(x, 0) for x in m.groups())) if m else int(expr, 0)
+    except ValueError:
+        value = -1
+    if not 0 <= value <= 0xFFFFFFFF:
+        sys.exit('unsupported U32 default in %s: %s' % (PARAMS_H, expr))
+    return value
+
+
+def load_registry(path=PARAMS_H):
+    with open(path, encoding='utf-8') as f:
+        text = f.read()
+    params = {}
+    for name, nvs_key, ptype, def_str, def_u32, max_len, _access in X_RE.findall(text):
+        default = def_str if ptype == 'STR' else parse_u32_default(def_u32)
+        params[name] = {'nvs_key': nvs_key, 'type': ptype, 'default': default, 'max_len': int(max_len)}
+    if not params:
+        sys.exit('no parameters found in %s' % path)
+    return params
+
+
+def nvs_partition_size(path=PARTITIONS_CSV):
+    with open(path, encoding='utf-8') as f:
+        for row in csv.reader(line for line in f if not line.lstrip().startswith('#')):
+            if len(row) >= 5 and row[0].strip() == 'nvs':
+                return int(row[4].strip(), 0)
+    sys.exit('nvs partition not found in %s' % path)
+
+
+def load_manifest(path):
+    if path.endswith('.json'):
+        with open(path, encoding='utf-8') as f:
+            data = json.load(f)
+        if isinstance(data, list):
+            return data
+        defaults = data.get('defaults', {})
+        return [dict(defaults, **dev) for dev in data['devices']]
+    with open(path, newline='', encoding='utf-8') as f:
+        return [{k: v for k, v in row.items() if v not in (None, '')} for row in csv.DictReader(f)]
+
+
+def device_values(registry, device, index):
+    unknown = set(device) - set(registry)
+    if unknown:
+        sys.exit('device %d: unknown parameters: %s' % (index, ', '.join(sorted(unknown))))
+    missing = [k for k in REQUIRED if not str(device.get(k, '')).strip()]
+    if missing:
+        sys.exit('device %d: missing identity: %s' % (index, ', '.join(missing)))
+
+    values = []
+    for name, p in registry.items():
+        value = device.get(name, p['default'])
+        if p['type'] == 'STR':
+            value = str(value)
+            if len(value.encode('utf-8')) > p['max_len']:
+                sys.exit('device %d: %s longer than %d bytes' % (index, name, p['max_len']))
+        else:
+            try:
+                value = int(value, 0) if isinstance(value, str) else int(value)
+            except (TypeError, ValueError):
+                sys.exit('device %d: %s is not an integer: %r' % (index, name, value))
+            if not 0 <= value <= 0xFFFFFFFF:
+                sys.exit('device %d: %s out of u32 range' % (index, name))
+        if value == '':
+            continue    # empty string == not set, nvs_partition_gen rejects empty data
+        values.append((p['nvs_key'], p['type'], value))
+    values.append((INIT_FLAG_KEY, 'U32', INIT_FLAG_FACTORY))
+    return values
+
+
+def write_nvs_csv(path, values):
+    with open(path, 'w', newline='', encoding='utf-8') as f:
+        w = csv.writer(f)
+        w.writerow(['key', 'type', 'encoding', 'value'])
+        w.writerow([NVS_NAMESPACE, 'namespace', '', ''])
+        for key, ptype, value in values:
+            w.writerow([key, 'data', 'string' if ptype == 'STR' else 'u32', value])
+
+
+def nvs_gen_command():
+    try:
+        import esp_idf_nvs_partition_gen  # noqa: F401
+        return [sys.executable, '-m', 'esp_idf_nvs_partition_gen']
+    except ImportError:
+        pass
+    idf = os.environ.get('IDF_PATH')
+    script = idf and os.path.join(idf, 'components', 'nvs_flash', 'nvs_partition_generator', 'nvs_partition_gen.py')
+    if script and os.path.exists(script):
+        return [sys.executable, script]
+    sys.exit('nvs_partition_gen not found: pip install esp-idf-nvs-partition-gen or export IDF_PATH')
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument('manifest', help='CSV or JSON device manifest')
+    ap.add_argument('-o', '--out', default='factory_nvs', help='output directory')
+    ap.add_argument('--size', type=lambda s: int(s, 0), help='partition size (default: nvs row of partitions.csv)')
+    ap.add_argument('--csv-only', action='store_true', help='only write nvs_partition_gen CSV files')
+    args = ap.parse_args()
+
+    registry = load_registry()
+    size = args.size or nvs_partition_size()
+    devices = load_manifest(args.manifest)
+    os.makedirs(args.out, exist_ok=True)
+    gen = None if args.csv_only else nvs_gen_command()
+
+    serials = set()
+    for i, dev in enumerate(devices, 1):
+        values = device_values(registry, dev, i)
+        serial = str(dev['serial_number'])
+        if serial in serials:
+            sys.exit('device %d: duplicate serial_number %s' % (i, serial))
+        serials.add(serial)
+
+        stem = os.path.join(args.out, re.sub(r'[^A-Za-z0-9._-]', '_', serial))
+        write_nvs_csv(stem + '.csv', values)
+        if gen:
+            subprocess.run(gen + ['generate', stem + '.csv', stem + '.bin', hex(size)], check=True,
+                           stdout=subprocess.DEVNULL)
+        print('%s -> %s' % (serial, stem + ('.csv' if args.csv_only else '.bin')))
+
+    print('%d image(s), flash each at the nvs partition offset, e.g. write_flash 0x9000 <image>.bin' % len(devices))
+
+
+if __name__ == '__main__':
+    main()
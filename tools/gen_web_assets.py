@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""Generate BootBone web portal assets: an embedded C table or a flash bundle.
+
+Each input file is compressed with gzip (level 9, no timestamp, so the output
+is reproducible) and stored compressed when that saves at least MIN_SAVING;
+already compressed formats such as PNG are stored as they are. The generated
+C source defines web_assets[] (main/include/web_assets.h) sorted by URI:
+
+  URI        /<file name>, index.html is served as /
+  type       MIME type from the file extension
+  etag       strong ETag: quoted first 16 hex digits of SHA-256 of the stored bytes
+  gzip       stored bytes are gzip, sent with Content-Encoding: gzip
+
+With --bundle VERSION the output is instead a binary asset bundle for the
+storage partition banks (format in main/include/bb_assets.h): 32 B header
+"BBA1" with version, entry count, total size and CRC-32, then a directory of
+96 B entries sorted by path (offset, length, flags, 8 B SHA-256 prefix used
+as the ETag, MIME type, path), then the data, 4 B aligned. The device maps
+the bank and serves entries straight from flash; a bundle found there takes
+precedence over the embedded table for static files. HTML pages and the app
+routes ("/", "/update") are always served from the embedded table, so .html
+files in a bundle are ignored.
+
+Run by the build (main/CMakeLists.txt); by hand:
+  tools/gen_web_assets.py -o build/web_assets.c main/web/index.html main/web/update.html
+  tools/gen_web_assets.py --bundle 2 -o build/assets.bin assets/*
+  tools/ota_server.py build/assets.bin --assets 2
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import struct
+import sys
+import zlib
+
+MIN_SAVING = 0.10
+BUNDLE_MAGIC = b'BBA1'          # BB_ASSETS_MAGIC
+BUNDLE_HDR = 32                 # BB_ASSETS_HDR_SIZE
+BUNDLE_ENTRY = 96               # BB_ASSETS_ENTRY_SIZE
+BUNDLE_TYPE_LEN = 28
+BUNDLE_PATH_LEN = 48
+BUNDLE_F_GZIP = 0x01
+BANK_SIZE = 0x8000              # storage / storage1 in partitions.csv
+MIME = {
+    '.html': 'text/html',
+    '.css': 'text/css',
+    '.js': 'application/javascript',
+    '.json': 'application/json',
+    '.png': 'image/png',
+    '.svg': 'image/svg+xml',
+    '.ico': 'image/x-icon',
+}
+
+
+def load(path):
+    with open(path, 'rb') as f:
+        raw = f.read()
+    name = os.path.basename(path)
+    ext = os.path.splitext(name)[1].lower()
+    if ext not in MIME:
+        raise SystemExit('%s: unknown asset type %s' % (path, ext))
+    packed = gzip.compress(raw, 9, mtime=0)
+    use_gzip = len(packed) <= len(raw) * (1 - MIN_SAVING)
+    data = packed if use_gzip else raw
+    return {
+        'uri': '/' if name == 'index.html' else '/' + name,
+        'type': MIME[ext],
+        'etag': '"%s"' % hashlib.sha256(data).hexdigest()[:16],
+        'gzip': use_gzip,
+        'data': data,
+        'raw_len': len(raw),
+    }
+
+
+def c_bytes(data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append('    ' + ' '.join('0x%02x,' % b for b in data[i:i + 16]))
+    return '\n'.join(lines)
+
+
+def render(assets):
+    out = ['// Wygenerowane przez tools/gen_web_assets.py - nie edytować',
+           '#include "web_assets.h"', '']
+    for i, a in enumerate(assets):
+        out.append('// %s: %d B -> %d B%s' % (a['uri'], a['raw_len'], len(a['data']), ' gzip' if a['gzip'] else ''))
+        out.append('static const uint8_t s_asset%d[] = {' % i)
+        out.append(c_bytes(a['data']))
+        out.append('};')
+        out.append('')
+    out.append('const web_asset_t web_assets[] = {')
+    for i, a in enumerate(assets):
+        out.append('    { "%s", "%s", "%s", s_asset%d, sizeof(s_asset%d), %s },' %
+                   (a['uri'], a['type'], a['etag'].replace('"', '\\"'), i, i, 'true' if a['gzip'] else 'false'))
+    out.append('};')
+    out.append('const size_t web_assets_count = %d;' % len(assets))
+    out.append('')
+    return '\n'.join(out)
+
+
+def render_bundle(assets, version):
+    data_off = BUNDLE_HDR + BUNDLE_ENTRY * len(assets)
+    directory, blob = b'', b''
+    for a in assets:
+        if len(a['uri']) >= BUNDLE_PATH_LEN or len(a['type']) >= BUNDLE_TYPE_LEN:
+            raise SystemExit('%s: path or type too long for the bundle directory' % a['uri'])
+        off = data_off + len(blob)
+        directory += struct.pack('<III8s%ds%ds' % (BUNDLE_TYPE_LEN, BUNDLE_PATH_LEN),
+                                 off, len(a['data']), BUNDLE_F_GZIP if a['gzip'] else 0,
+                                 hashlib.sha256(a['data']).digest()[:8],
+                                 a['type'].encode(), a['uri'].encode())
+        blob += a['data'] + b'\0' * (-len(a['data']) % 4)
+    body = directory + blob
+    size = BUNDLE_HDR + len(body)
+    hdr = struct.pack('<4sIIII12x', BUNDLE_MAGIC, version, len(assets), size, zlib.crc32(body))
+    return hdr + body
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('files', nargs='+', help='asset files (.html, .css, .js, .png, ...)')
+    ap.add_argument('-o', '--output', required=True, help='generated C source, or bundle image with --bundle')
+    ap.add_argument('--bundle', type=int, metavar='VERSION',
+                    help='write a storage bank bundle with this version (> 0) instead of C source')
+    args = ap.parse_args()
+    if args.bundle is not None and args.bundle <= 0:
+        raise SystemExit('bundle version must be > 0')
+
+    assets = sorted((load(p) for p in args.files), key=lambda a: a['uri'].encode())
+    uris = [a['uri'] for a in assets]
+    if len(set(uris)) != len(uris):
+        raise SystemExit('duplicate asset URI in %s' % ' '.join(uris))
+    if args.bundle is not None:
+        image = render_bundle(assets, args.bundle)
+        if len(image) > BANK_SIZE:
+            raise SystemExit('bundle is %d B, bank holds %d B' % (len(image), BANK_SIZE))
+        with open(args.output, 'wb') as f:
+            f.write(image)
+        print('bundle v%d: %d assets, %d B of %d B' % (args.bundle, len(assets), len(image), BANK_SIZE))
+    else:
+        with open(args.output, 'w') as f:
+            f.write(render(assets))
+    for a in assets:
+        print('%-14s %6d B -> %6d B%s' % (a['uri'], a['raw_len'], len(a['data']), ' gzip' if a['gzip'] else ''))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,92 @@
+// Grupa "log" z main/bb_bench.c na hoście: snprintf kontra bb_blog_encode,
+// te same funkcje (bb_bench.c dołączony jako źródło, przypadki są static).
+// Cykle z TSC (x86), stos z malowania osobnego stosu ucontext. Liczby z
+// hosta (gcc, glibc) - dla ESP32-C3 z newlib uruchom bb_bench na urządzeniu.
+//   make bench
+#define CONFIG_BB_BENCH 1
+#define CONFIG_BB_BENCH_ITERATIONS 1000
+#include "../../main/bb_bench.c"
+#include "bbapi.h"
+#include "ws_comm.h"
+#include <time.h>
+#include <ucontext.h>
+
+#define ITER        200000
+#define STACK_SIZE  16384
+#define STACK_PAINT 0xA5
+
+typedef size_t (*case_fn_t)(const void* arg, char* out, size_t outsize, int seq);
+
+// ===== ws_comm / BBAPI (bb_blog.c, nieużywane przez encode) =====
+int esp_app_get_elf_sha256(char* dst, size_t size) { return 0; }
+bool ws_comm_is_connected(void) { return false; }
+esp_err_t ws_comm_tx_reserve_low(ws_tx_slot_t* slot) { return ESP_ERR_TIMEOUT; }
+esp_err_t ws_comm_tx_commit(ws_tx_slot_t* slot, size_t len) { return ESP_OK; }
+void ws_comm_tx_cancel(ws_tx_slot_t* slot) {}
+esp_err_t BBAPI_register_cmd(const char* name, bbapi_cmd_handler_t handler, const bbapi_arg_t* arg_schema, void* ctx) {
+    return ESP_OK;
+}
+
+// ===== STOS =====
+static uint8_t s_stack[STACK_SIZE];
+static ucontext_t s_main_ctx, s_case_ctx;
+static case_fn_t s_fn;
+
+static void stack_entry(void) {
+    char out[256];
+    s_fn(NULL, out, sizeof(out), 7);
+}
+
+// Bajty stosu zużyte przez jedno wywołanie, razem z ramką stack_entry
+static size_t stack_used(case_fn_t fn) {
+    memset(s_stack, STACK_PAINT, sizeof(s_stack));
+    s_fn = fn;
+    getcontext(&s_case_ctx);
+    s_case_ctx.uc_stack.ss_sp = s_stack;
+    s_case_ctx.uc_stack.ss_size = sizeof(s_stack);
+    s_case_ctx.uc_link = &s_main_ctx;
+    makecontext(&s_case_ctx, stack_entry, 0);
+    swapcontext(&s_main_ctx, &s_case_ctx);
+    size_t i = 0;
+    while (i < sizeof(s_stack) && s_stack[i] == STACK_PAINT) i++;
+    return sizeof(s_stack) - i;
+}
+
+static size_t empty_case(const void* arg, char* out, size_t outsize, int seq) {
+    __asm__ volatile("");
+    return 0;
+}
+
+// ===== POMIAR =====
+static void measure(const bench_case_t* c, size_t base_stack) {
+    char out[256];
+    size_t len = 0;
+    uint32_t best = UINT32_MAX;
+    uint64_t sum = 0;
+    struct timespec a, b;
+
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    for (int i = 0; i < ITER; i++) {
+        uint32_t t0 = esp_cpu_get_cycle_count();
+        len = c->fn(c->arg, out, sizeof(out), i);
+        uint32_t dt = esp_cpu_get_cycle_count() - t0;
+        sum += dt;
+        if (dt < best) best = dt;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    double ns = ((b.tv_sec - a.tv_sec) * 1e9 + (b.tv_nsec - a.tv_nsec)) / ITER;
+
+    printf("  %-14s avg %6u %s  min %6u %s  %6.1f ns/call  stack %5zu B  out %zu B\n",
+           c->name, (unsigned)(sum / ITER), HOST_CPU_CYCLES_UNIT, (unsigned)best, HOST_CPU_CYCLES_UNIT,
+           ns, stack_used(c->fn) - base_stack, len);
+}
+
+int main(void) {
+    size_t base = stack_used(empty_case);
+    printf("bb_bench log group on the host (not ESP32-C3): %d calls, stack on top of an empty call (%zu B)\n",
+           ITER, base);
+    for (int run = 0; run < 2; run++) {
+        for (size_t i = 0; i < sizeof(s_log_cases) / sizeof(s_log_cases[0]); i++) measure(&s_log_cases[i], base);
+    }
+    return 0;
+}
@@ -0,0 +1,18 @@
+// Host stub: licznik cykli - TSC na x86, na innych hostach nanosekundy
+#pragma once
+#include <stdint.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HOST_CPU_CYCLES_UNIT "cyc"
+static inline uint32_t esp_cpu_get_cycle_count(void) {
+    return (uint32_t)__rdtsc();
+}
+#else
+#include <time.h>
+#define HOST_CPU_CYCLES_UNIT "ns"
+static inline uint32_t esp_cpu_get_cycle_count(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+#endif
@@ -0,0 +1,7 @@
+// Host stub: tylko typy, których używa ws_comm.c
+#pragma once
+#include "esp_err.h"
+#include <stdint.h>
+
+typedef const char* esp_event_base_t;
+typedef void (*esp_event_handler_t)(void* arg, esp_event_base_t base, int32_t id, void* data);
@@ -0,0 +1,29 @@
+// Host stub: E/W na stderr, reszta wyciszona (HOST_LOG_VERBOSE=1 włącza I)
+#pragma once
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE
+} esp_log_level_t;
+
+extern int host_log_verbose;
+
+// Jak w ESP-IDF: esp_log_write przechodzi przez funkcję z esp_log_set_vprintf
+// (domyślnie wyciszona jak ESP_LOGI). Makra ESP_LOGx jej nie używają.
+typedef int (*vprintf_like_t)(const char* fmt, va_list ap);
+vprintf_like_t esp_log_set_vprintf(vprintf_like_t func);
+void esp_log_write(esp_log_level_t level, const char* tag, const char* fmt, ...);
+uint32_t esp_log_timestamp(void);        // ms od startu
+
+#define ESP_LOGE(tag, fmt, ...) fprintf(stderr, "E %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) fprintf(stderr, "W %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) do { if (host_log_verbose) fprintf(stderr, "I %s: " fmt "\n", tag, ##__VA_ARGS__); } while (0)
+#define ESP_LOGD(tag, fmt, ...) ((void)0)
+#define ESP_LOGV(tag, fmt, ...) ((void)0)
@@ -0,0 +1,7 @@
+// Host stub
+#pragma once
+#include "esp_err.h"
+#include <stdint.h>
+
+void esp_restart(void);                     // host_flash.c: liczy wywołania
+uint32_t esp_get_free_heap_size(void);
@@ -0,0 +1,5 @@
+// Host stub: czas monotoniczny w µs
+#pragma once
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
@@ -0,0 +1,44 @@
+// Host stub: API klienta websocket z ESP-IDF; implementację daje test
+#pragma once
+#include "esp_err.h"
+#include "esp_event.h"
+#include "freertos/FreeRTOS.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct esp_websocket_client* esp_websocket_client_handle_t;
+
+typedef enum {
+    WEBSOCKET_EVENT_ANY = -1,
+    WEBSOCKET_EVENT_ERROR = 0,
+    WEBSOCKET_EVENT_CONNECTED,
+    WEBSOCKET_EVENT_DISCONNECTED,
+    WEBSOCKET_EVENT_DATA,
+    WEBSOCKET_EVENT_CLOSED,
+} esp_websocket_event_id_t;
+
+typedef struct {
+    const char* data_ptr;
+    int data_len;
+    bool fin;
+    uint8_t op_code;
+    esp_websocket_client_handle_t client;
+    void* user_context;
+    int payload_len;
+    int payload_offset;
+} esp_websocket_event_data_t;
+
+typedef struct {
+    const char* uri;
+} esp_websocket_client_config_t;
+
+esp_websocket_client_handle_t esp_websocket_client_init(const esp_websocket_client_config_t* cfg);
+esp_err_t esp_websocket_register_events(esp_websocket_client_handle_t c, esp_websocket_event_id_t ev,
+                                        esp_event_handler_t fn, void* arg);
+esp_err_t esp_websocket_unregister_events(esp_websocket_client_handle_t c, esp_websocket_event_id_t ev,
+                                          esp_event_handler_t fn);
+esp_err_t esp_websocket_client_start(esp_websocket_client_handle_t c);
+esp_err_t esp_websocket_client_close(esp_websocket_client_handle_t c, TickType_t to);
+esp_err_t esp_websocket_client_destroy(esp_websocket_client_handle_t c);
+int esp_websocket_client_send_text(esp_websocket_client_handle_t c, const char* data, int len, TickType_t to);
+int esp_websocket_client_send_bin(esp_websocket_client_handle_t c, const char* data, int len, TickType_t to);
@@ -0,0 +1,35 @@
+// Host stub: FreeRTOS na pthreadach (host_rtos.c), tick 1 ms
+#pragma once
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t StackType_t;
+
+#define pdTRUE              1
+#define pdFALSE             0
+#define pdPASS              pdTRUE
+#define pdFAIL              pdFALSE
+#define portMAX_DELAY       ((TickType_t)0xffffffffu)
+#define configTICK_RATE_HZ  1000
+#define portTICK_PERIOD_MS  1
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms))
+
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES CONFIG_FREERTOS_TASK_NOTIFICATION_ARRAY_ENTRIES
+
+// Wszystkie sekcje krytyczne dzielą jeden rekurencyjny mutex
+typedef struct { int unused; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+
+BaseType_t xPortInIsrContext(void);     // zawsze pdFALSE - bez przerwań
+
+void host_critical_enter(void);
+void host_critical_exit(void);
+#define portENTER_CRITICAL(mux)     ((void)(mux), host_critical_enter())
+#define portEXIT_CRITICAL(mux)      ((void)(mux), host_critical_exit())
+#define portENTER_CRITICAL_SAFE(mux) portENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL_SAFE(mux)  portEXIT_CRITICAL(mux)
@@ -0,0 +1,10 @@
+// Host stub: semafor binarny = kolejka 1 x 0 B
+#pragma once
+#include "freertos/queue.h"
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+#define xSemaphoreCreateBinary()    xQueueCreate(1, 0)
+#define xSemaphoreTake(s, wait)     xQueueReceive((s), NULL, (wait))
+#define xSemaphoreGive(s)           xQueueSend((s), NULL, 0)
+#define vSemaphoreDelete(s)         vQueueDelete(s)
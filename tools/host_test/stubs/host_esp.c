@@ -0,0 +1,57 @@
+// Wspólne stuby ESP-IDF dla testów hosta
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdlib.h>
+
+int host_log_verbose;
+
+static int host_vprintf(const char* fmt, va_list ap) {
+    return host_log_verbose ? vfprintf(stderr, fmt, ap) : 0;
+}
+
+static vprintf_like_t s_vprintf = host_vprintf;
+
+vprintf_like_t esp_log_set_vprintf(vprintf_like_t func) {
+    vprintf_like_t prev = s_vprintf;
+    s_vprintf = func;
+    return prev;
+}
+
+void esp_log_write(esp_log_level_t level, const char* tag, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    s_vprintf(fmt, ap);
+    va_end(ap);
+}
+
+uint32_t esp_log_timestamp(void) {
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+__attribute__((constructor)) static void host_log_init(void) {
+    const char* v = getenv("HOST_LOG_VERBOSE");
+    host_log_verbose = v && v[0] == '1';
+}
+
+const char* esp_err_to_name(esp_err_t err) {
+    switch (err) {
+    case ESP_OK:                        return "ESP_OK";
+    case ESP_FAIL:                      return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:                return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:           return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:         return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:          return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:             return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED:         return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:               return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_INVALID_RESPONSE:      return "ESP_ERR_INVALID_RESPONSE";
+    case ESP_ERR_INVALID_CRC:           return "ESP_ERR_INVALID_CRC";
+    case ESP_ERR_INVALID_VERSION:       return "ESP_ERR_INVALID_VERSION";
+    case ESP_ERR_NVS_NOT_FOUND:         return "ESP_ERR_NVS_NOT_FOUND";
+    case ESP_ERR_NVS_KEY_TOO_LONG:      return "ESP_ERR_NVS_KEY_TOO_LONG";
+    case ESP_ERR_NVS_INVALID_LENGTH:    return "ESP_ERR_NVS_INVALID_LENGTH";
+    case ESP_ERR_NVS_NO_FREE_PAGES:     return "ESP_ERR_NVS_NO_FREE_PAGES";
+    default:                            return "ESP_ERR_?";
+    }
+}
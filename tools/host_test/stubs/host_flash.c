@@ -0,0 +1,132 @@
+// Partycje aplikacji w RAM i esp_ota_* na nich. esp_ota_end nie sprawdza
+// nagłówka obrazu ESP - testy podają sha256, który sprawdza bb_ota.
+#include "host_flash.h"
+#include "esp_ota_ops.h"
+#include "esp_system.h"
+#include <string.h>
+
+static esp_partition_t s_parts[2] = {
+    { .type = ESP_PARTITION_TYPE_APP, .address = 0x10000,  .size = HOST_FLASH_APP_SIZE,
+      .erase_size = HOST_FLASH_SECTOR, .label = "app0" },
+    { .type = ESP_PARTITION_TYPE_APP, .address = 0x180000, .size = HOST_FLASH_APP_SIZE,
+      .erase_size = HOST_FLASH_SECTOR, .label = "app1" },
+};
+static uint8_t s_data[2][HOST_FLASH_APP_SIZE];
+static host_flash_stats_t s_st;
+static bool s_ota_open;
+static const esp_partition_t* s_ota_part;
+static uint32_t s_ota_pos;
+
+static uint8_t* data_of(const esp_partition_t* part) {
+    return s_data[part == &s_parts[1]];
+}
+
+static bool in_range(const esp_partition_t* part, size_t off, size_t len) {
+    return part && off <= part->size && len <= part->size - off;
+}
+
+void host_flash_wipe(void) {
+    memset(s_data, 0xFF, sizeof(s_data));
+    memset(&s_st, 0, sizeof(s_st));
+    s_ota_open = false;
+}
+
+const uint8_t* host_flash_data(const esp_partition_t* part) {
+    return data_of(part);
+}
+
+void host_flash_stats(host_flash_stats_t* out) {
+    *out = s_st;
+}
+
+// ===== esp_partition =====
+esp_err_t esp_partition_read(const esp_partition_t* part, size_t off, void* dst, size_t len) {
+    if (!in_range(part, off, len)) return ESP_ERR_INVALID_SIZE;
+    memcpy(dst, data_of(part) + off, len);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* part, size_t off, const void* src, size_t len) {
+    if (!in_range(part, off, len)) return ESP_ERR_INVALID_SIZE;
+    uint8_t* d = data_of(part) + off;
+    // flash NOR: zapis tylko kasuje bity
+    for (size_t i = 0; i < len; i++) d[i] &= ((const uint8_t*)src)[i];
+    s_st.bytes += len;
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* part, size_t off, size_t len) {
+    if (!in_range(part, off, len) || off % HOST_FLASH_SECTOR || len % HOST_FLASH_SECTOR) return ESP_ERR_INVALID_ARG;
+    memset(data_of(part) + off, 0xFF, len);
+    s_st.sectors_erased += len / HOST_FLASH_SECTOR;
+    return ESP_OK;
+}
+
+// ===== esp_ota =====
+esp_err_t esp_ota_begin(const esp_partition_t* part, size_t size, esp_ota_handle_t* out) {
+    if (s_ota_open) return ESP_ERR_INVALID_STATE;
+    if (part != &s_parts[1]) return ESP_ERR_INVALID_ARG;
+    s_ota_open = true;
+    s_ota_part = part;
+    s_ota_pos = 0;
+    s_st.ota_begin++;
+    *out = 1;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_resume(const esp_partition_t* part, const size_t erase_size, const size_t off, esp_ota_handle_t* out) {
+    if (s_ota_open) return ESP_ERR_INVALID_STATE;
+    if (part != &s_parts[1] || off > part->size) return ESP_ERR_INVALID_ARG;
+    s_ota_open = true;
+    s_ota_part = part;
+    s_ota_pos = (uint32_t)off;
+    s_st.ota_resume++;
+    *out = 2;
+    return ESP_OK;
+}
+
+// OTA_WITH_SEQUENTIAL_WRITES: sektor kasowany przy pierwszym zapisie do niego
+esp_err_t esp_ota_write(esp_ota_handle_t h, const void* data, size_t len) {
+    if (!s_ota_open) return ESP_ERR_INVALID_STATE;
+    if (!in_range(s_ota_part, s_ota_pos, len)) return ESP_ERR_INVALID_SIZE;
+    uint32_t end = s_ota_pos + (uint32_t)len;
+    uint32_t sec = (s_ota_pos + HOST_FLASH_SECTOR - 1) / HOST_FLASH_SECTOR * HOST_FLASH_SECTOR;
+    for (; sec < end; sec += HOST_FLASH_SECTOR) esp_partition_erase_range(s_ota_part, sec, HOST_FLASH_SECTOR);
+    esp_err_t err = esp_partition_write(s_ota_part, s_ota_pos, data, len);
+    if (err == ESP_OK) s_ota_pos = end;
+    return err;
+}
+
+esp_err_t esp_ota_end(esp_ota_handle_t h) {
+    if (!s_ota_open) return ESP_ERR_INVALID_STATE;
+    s_ota_open = false;
+    return s_ota_pos ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+esp_err_t esp_ota_abort(esp_ota_handle_t h) {
+    s_ota_open = false;
+    s_st.ota_abort++;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t* part) {
+    s_st.boot = part;
+    return ESP_OK;
+}
+
+const esp_partition_t* esp_ota_get_next_update_partition(const esp_partition_t* start) {
+    return &s_parts[1];
+}
+
+const esp_partition_t* esp_ota_get_running_partition(void) {
+    return &s_parts[0];
+}
+
+// ===== esp_system =====
+void esp_restart(void) {
+    s_st.restarts++;
+}
+
+uint32_t esp_get_free_heap_size(void) {
+    return 200 * 1024;
+}
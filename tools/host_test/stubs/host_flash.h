@@ -0,0 +1,23 @@
+// Flash w RAM dla testów OTA: dwa sloty aplikacji (app0 działa, app1 do
+// aktualizacji), esp_ota_* z zapisem sekwencyjnym, liczniki
+#pragma once
+#include "esp_partition.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define HOST_FLASH_APP_SIZE     0x170000
+#define HOST_FLASH_SECTOR       4096
+
+typedef struct {
+    uint32_t ota_begin;
+    uint32_t ota_resume;
+    uint32_t ota_abort;
+    uint32_t bytes;             // esp_ota_write + esp_partition_write
+    uint32_t sectors_erased;
+    uint32_t restarts;
+    const esp_partition_t* boot;    // ostatni esp_ota_set_boot_partition
+} host_flash_stats_t;
+
+void host_flash_wipe(void);     // oba sloty 0xFF, liczniki od zera
+const uint8_t* host_flash_data(const esp_partition_t* part);
+void host_flash_stats(host_flash_stats_t* out);
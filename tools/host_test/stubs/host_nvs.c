@@ -0,0 +1,239 @@
+// NVS w RAM z modelem kosztu formatu NVS (wpisy 32 B, słowo stanu 4 B na
+// zapisany lub skasowany element, blob v2 = indeks + fragment danych).
+// Pojedynczy zapis jest atomowy jak w prawdziwym NVS; nvs_commit nie pisze
+// do flash (tak samo w ESP-IDF), tylko się liczy.
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "host_nvs.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_NVS_MAX_ITEMS  256
+#define HOST_NVS_MAX_NS     8
+#define HOST_NVS_MAX_VALUE  4096
+#define NVS_ENTRY_SIZE      32
+#define NVS_STATE_WORD      4
+
+typedef struct {
+    bool used;
+    uint8_t ns;
+    char key[16];
+    nvs_type_t type;
+    size_t len;                 // STR: z '\0'
+    uint8_t value[HOST_NVS_MAX_VALUE];
+} host_item_t;
+
+static host_item_t s_items[HOST_NVS_MAX_ITEMS];
+static char s_ns[HOST_NVS_MAX_NS][16];
+static host_nvs_stats_t s_stats;
+static int s_fail_after = -1;
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void host_nvs_wipe(void) {
+    pthread_mutex_lock(&s_lock);
+    memset(s_items, 0, sizeof(s_items));
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_fail_after = -1;
+    pthread_mutex_unlock(&s_lock);
+}
+
+void host_nvs_stats(host_nvs_stats_t* out) {
+    pthread_mutex_lock(&s_lock);
+    *out = s_stats;
+    pthread_mutex_unlock(&s_lock);
+}
+
+void host_nvs_stats_reset(void) {
+    pthread_mutex_lock(&s_lock);
+    memset(&s_stats, 0, sizeof(s_stats));
+    pthread_mutex_unlock(&s_lock);
+}
+
+void host_nvs_fail_after(int n) {
+    pthread_mutex_lock(&s_lock);
+    s_fail_after = n;
+    pthread_mutex_unlock(&s_lock);
+}
+
+// ===== MODEL KOSZTU =====
+static uint32_t span(size_t len) {
+    return (uint32_t)((len + NVS_ENTRY_SIZE - 1) / NVS_ENTRY_SIZE);
+}
+
+// Elementy NVS: u32 1, string nagłówek + dane, blob v2 indeks + fragment
+static uint32_t item_count(nvs_type_t type) {
+    return type == NVS_TYPE_BLOB ? 2 : 1;
+}
+
+static uint32_t item_entries(nvs_type_t type, size_t len) {
+    switch (type) {
+    case NVS_TYPE_U32:  return 1;
+    case NVS_TYPE_STR:  return 1 + span(len);
+    default:            return 1 + (1 + span(len));
+    }
+}
+
+static void cost_write(nvs_type_t type, size_t len) {
+    uint32_t e = item_entries(type, len);
+    s_stats.entries += e;
+    s_stats.bytes += e * NVS_ENTRY_SIZE + item_count(type) * NVS_STATE_WORD;
+}
+
+static void cost_erase(const host_item_t* it) {
+    s_stats.bytes += item_count(it->type) * NVS_STATE_WORD;
+}
+
+// ===== MAGAZYN =====
+static host_item_t* find(nvs_handle_t h, const char* key) {
+    for (int i = 0; i < HOST_NVS_MAX_ITEMS; i++) {
+        if (s_items[i].used && s_items[i].ns == h - 1 && strcmp(s_items[i].key, key) == 0) return &s_items[i];
+    }
+    return NULL;
+}
+
+// Jeden krok zapisu; false = zasilanie już zniknęło
+static bool power_ok(void) {
+    if (s_fail_after == 0) return false;
+    if (s_fail_after > 0) s_fail_after--;
+    return true;
+}
+
+static esp_err_t put(nvs_handle_t h, const char* key, nvs_type_t type, const void* value, size_t len) {
+    if (h == 0 || h > HOST_NVS_MAX_NS) return ESP_ERR_INVALID_ARG;
+    if (strlen(key) > 15) return ESP_ERR_NVS_KEY_TOO_LONG;
+    if (len > HOST_NVS_MAX_VALUE) return ESP_ERR_NVS_INVALID_LENGTH;
+
+    pthread_mutex_lock(&s_lock);
+    if (!power_ok()) {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_FAIL;
+    }
+    host_item_t* it = find(h, key);
+    if (it) {
+        cost_erase(it);             // nowa wersja jest zapisywana przed skasowaniem starej
+    } else {
+        for (int i = 0; i < HOST_NVS_MAX_ITEMS && !it; i++) {
+            if (!s_items[i].used) it = &s_items[i];
+        }
+        if (!it) {
+            pthread_mutex_unlock(&s_lock);
+            return ESP_ERR_NVS_NO_FREE_PAGES;
+        }
+    }
+    it->used = true;
+    it->ns = (uint8_t)(h - 1);
+    strcpy(it->key, key);
+    it->type = type;
+    it->len = len;
+    memcpy(it->value, value, len);
+    cost_write(type, len);
+    if (type == NVS_TYPE_BLOB) s_stats.set_blob++;
+    else s_stats.set++;
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+static esp_err_t get(nvs_handle_t h, const char* key, nvs_type_t type, void* out, size_t* len) {
+    pthread_mutex_lock(&s_lock);
+    host_item_t* it = find(h, key);
+    esp_err_t err = ESP_OK;
+    if (!it || it->type != type) {
+        err = ESP_ERR_NVS_NOT_FOUND;
+    } else if (out && *len < it->len) {
+        err = ESP_ERR_NVS_INVALID_LENGTH;
+    } else {
+        if (out) memcpy(out, it->value, it->len);
+        *len = it->len;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return err;
+}
+
+esp_err_t nvs_flash_init(void) { return ESP_OK; }
+esp_err_t nvs_flash_deinit(void) { return ESP_OK; }
+
+esp_err_t nvs_flash_erase(void) {
+    host_nvs_wipe();
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char* ns, nvs_open_mode_t mode, nvs_handle_t* out) {
+    pthread_mutex_lock(&s_lock);
+    for (int i = 0; i < HOST_NVS_MAX_NS; i++) {
+        if (s_ns[i][0] == '\0') strncpy(s_ns[i], ns, sizeof(s_ns[i]) - 1);
+        if (strcmp(s_ns[i], ns) == 0) {
+            *out = (nvs_handle_t)(i + 1);
+            pthread_mutex_unlock(&s_lock);
+            return ESP_OK;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ESP_ERR_NO_MEM;
+}
+
+void nvs_close(nvs_handle_t h) {}
+
+esp_err_t nvs_set_str(nvs_handle_t h, const char* key, const char* value) {
+    return put(h, key, NVS_TYPE_STR, value, strlen(value) + 1);
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t h, const char* key, uint32_t value) {
+    return put(h, key, NVS_TYPE_U32, &value, sizeof(value));
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t h, const char* key, const void* value, size_t len) {
+    return put(h, key, NVS_TYPE_BLOB, value, len);
+}
+
+esp_err_t nvs_get_str(nvs_handle_t h, const char* key, char* out, size_t* len) {
+    return get(h, key, NVS_TYPE_STR, out, len);
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t h, const char* key, uint32_t* out) {
+    size_t len = sizeof(*out);
+    return get(h, key, NVS_TYPE_U32, out, &len);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t h, const char* key, void* out, size_t* len) {
+    return get(h, key, NVS_TYPE_BLOB, out, len);
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t h, const char* key) {
+    pthread_mutex_lock(&s_lock);
+    host_item_t* it = find(h, key);
+    esp_err_t err = ESP_OK;
+    if (!it) {
+        err = ESP_ERR_NVS_NOT_FOUND;
+    } else if (!power_ok()) {
+        err = ESP_FAIL;
+    } else {
+        cost_erase(it);
+        it->used = false;
+        s_stats.erase++;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return err;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t h) {
+    pthread_mutex_lock(&s_lock);
+    esp_err_t err = power_ok() ? ESP_OK : ESP_FAIL;
+    for (int i = 0; i < HOST_NVS_MAX_ITEMS && err == ESP_OK; i++) {
+        if (s_items[i].used && s_items[i].ns == h - 1) {
+            cost_erase(&s_items[i]);
+            s_items[i].used = false;
+        }
+    }
+    if (err == ESP_OK) s_stats.erase++;
+    pthread_mutex_unlock(&s_lock);
+    return err;
+}
+
+esp_err_t nvs_commit(nvs_handle_t h) {
+    pthread_mutex_lock(&s_lock);
+    s_stats.commit++;
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
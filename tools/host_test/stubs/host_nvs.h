@@ -0,0 +1,22 @@
+// Sterowanie NVS hosta: liczniki operacji, model kosztu flash, awaria zasilania
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    uint32_t set;           // nvs_set_str / nvs_set_u32
+    uint32_t set_blob;
+    uint32_t erase;         // nvs_erase_key / nvs_erase_all
+    uint32_t commit;
+    uint32_t entries;       // zajęte wpisy 32 B (strona NVS ma ich 126)
+    uint32_t bytes;         // bajty zapisane do flash wg modelu formatu NVS
+} host_nvs_stats_t;
+
+// Magazyn przeżywa nvs_flash_deinit/init, jak partycja; wipe czyści wszystko
+void host_nvs_wipe(void);
+void host_nvs_stats(host_nvs_stats_t* out);
+void host_nvs_stats_reset(void);
+
+// Po n udanych zapisach (set/erase) każdy następny zwraca ESP_FAIL i nic nie
+// zmienia: zasilanie zniknęło między operacjami. n < 0 wyłącza awarię.
+void host_nvs_fail_after(int n);
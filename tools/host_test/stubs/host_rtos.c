@@ -0,0 +1,257 @@
+// FreeRTOS na pthreadach: tyle, ile potrzebują testowane moduły. Bez
+// priorytetów i wywłaszczania - wątki systemu, tick = 1 ms zegara CLOCK_MONOTONIC.
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+struct host_task {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t notify[configTASK_NOTIFICATION_ARRAY_ENTRIES];
+    TaskFunction_t fn;
+    void* arg;
+    volatile bool deleted;
+};
+
+struct host_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint8_t* buf;
+    UBaseType_t len;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+};
+
+static __thread struct host_task* t_self;
+static pthread_mutex_t s_critical;
+static pthread_once_t s_critical_once = PTHREAD_ONCE_INIT;
+
+static void critical_init(void) {
+    pthread_mutexattr_t a;
+    pthread_mutexattr_init(&a);
+    pthread_mutexattr_settype(&a, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&s_critical, &a);
+}
+
+void host_critical_enter(void) {
+    pthread_once(&s_critical_once, critical_init);
+    pthread_mutex_lock(&s_critical);
+}
+
+void host_critical_exit(void) {
+    pthread_mutex_unlock(&s_critical);
+}
+
+int64_t esp_timer_get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(esp_timer_get_time() / 1000);
+}
+
+// Termin dla pthread_cond_timedwait; false = czekaj bez końca
+static bool deadline(TickType_t wait, struct timespec* ts) {
+    if (wait == portMAX_DELAY) return false;
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += wait / 1000;
+    ts->tv_nsec += (long)(wait % 1000) * 1000000;
+    if (ts->tv_nsec >= 1000000000) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000;
+    }
+    return true;
+}
+
+static void cond_init(pthread_cond_t* c) {
+    pthread_condattr_t a;
+    pthread_condattr_init(&a);
+    pthread_condattr_setclock(&a, CLOCK_MONOTONIC);
+    pthread_cond_init(c, &a);
+}
+
+// Czeka na warunek; false po przekroczeniu terminu
+static bool cond_wait(pthread_cond_t* c, pthread_mutex_t* m, bool timed, const struct timespec* ts) {
+    if (!timed) return pthread_cond_wait(c, m) == 0;
+    return pthread_cond_timedwait(c, m, ts) != ETIMEDOUT;
+}
+
+// ===== TASKI =====
+static struct host_task* task_new(void) {
+    struct host_task* t = calloc(1, sizeof(*t));
+    pthread_mutex_init(&t->lock, NULL);
+    cond_init(&t->cond);
+    return t;
+}
+
+static void* task_entry(void* pv) {
+    struct host_task* t = pv;
+    t_self = t;
+    t->fn(t->arg);
+    t->deleted = true;      // task nie powinien wracać, ale nie psujmy testu
+    return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack, void* arg,
+                       UBaseType_t prio, TaskHandle_t* out) {
+    struct host_task* t = task_new();
+    t->fn = fn;
+    t->arg = arg;
+    if (out) *out = t;
+    if (pthread_create(&t->thread, NULL, task_entry, t) != 0) return pdFAIL;
+    pthread_detach(t->thread);
+    return pdPASS;
+}
+
+// Uchwyt zostaje (wyciek w teście), żeby eTaskGetState działało po usunięciu
+void vTaskDelete(TaskHandle_t task) {
+    if (task == NULL || task == t_self) {
+        xTaskGetCurrentTaskHandle()->deleted = true;
+        pthread_exit(NULL);
+    }
+    task->deleted = true;   // cudzego wątku nie da się zabić - test tego nie robi
+}
+
+void vTaskDelay(TickType_t ticks) {
+    struct timespec ts = { .tv_sec = ticks / 1000, .tv_nsec = (long)(ticks % 1000) * 1000000 };
+    if (ticks == 0) {
+        sched_yield();
+        return;
+    }
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+}
+
+void vTaskDelayUntil(TickType_t* prev, TickType_t period) {
+    TickType_t wake = *prev + period;
+    TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(wake - now) > 0) vTaskDelay(wake - now);
+    *prev = wake;
+}
+
+BaseType_t xPortInIsrContext(void) {
+    return pdFALSE;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    if (!t_self) t_self = task_new();   // main() i wątki spoza xTaskCreate
+    return t_self;
+}
+
+eTaskState eTaskGetState(TaskHandle_t task) {
+    return task->deleted ? eDeleted : eReady;
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task) {
+    return 5;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    return 0;
+}
+
+BaseType_t xTaskNotifyGiveIndexed(TaskHandle_t task, UBaseType_t index) {
+    if (index >= configTASK_NOTIFICATION_ARRAY_ENTRIES) abort();
+    pthread_mutex_lock(&task->lock);
+    task->notify[index]++;
+    pthread_cond_broadcast(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTakeIndexed(UBaseType_t index, BaseType_t clear, TickType_t wait) {
+    if (index >= configTASK_NOTIFICATION_ARRAY_ENTRIES) abort();
+    struct host_task* t = xTaskGetCurrentTaskHandle();
+    struct timespec ts;
+    bool timed = deadline(wait, &ts);
+
+    pthread_mutex_lock(&t->lock);
+    while (t->notify[index] == 0 && wait != 0) {
+        if (!cond_wait(&t->cond, &t->lock, timed, &ts)) break;
+    }
+    uint32_t v = t->notify[index];
+    if (v) t->notify[index] = clear ? 0 : v - 1;
+    pthread_mutex_unlock(&t->lock);
+    return v;
+}
+
+// ===== KOLEJKI =====
+QueueHandle_t xQueueCreate(UBaseType_t len, UBaseType_t item_size) {
+    struct host_queue* q = calloc(1, sizeof(*q));
+    if (!q) return NULL;
+    q->buf = malloc((size_t)len * item_size);
+    q->len = len;
+    q->item_size = item_size;
+    pthread_mutex_init(&q->lock, NULL);
+    cond_init(&q->cond);
+    return q;
+}
+
+void vQueueDelete(QueueHandle_t q) {
+    pthread_mutex_destroy(&q->lock);
+    pthread_cond_destroy(&q->cond);
+    free(q->buf);
+    free(q);
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t wait) {
+    struct timespec ts;
+    bool timed = deadline(wait, &ts);
+
+    pthread_mutex_lock(&q->lock);
+    while (q->count == q->len) {
+        if (wait == 0 || !cond_wait(&q->cond, &q->lock, timed, &ts)) {
+            pthread_mutex_unlock(&q->lock);
+            return pdFALSE;
+        }
+    }
+    if (q->item_size) memcpy(q->buf + (size_t)((q->head + q->count) % q->len) * q->item_size, item, q->item_size);
+    q->count++;
+    pthread_cond_broadcast(&q->cond);
+    pthread_mutex_unlock(&q->lock);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void* item, TickType_t wait) {
+    struct timespec ts;
+    bool timed = deadline(wait, &ts);
+
+    pthread_mutex_lock(&q->lock);
+    while (q->count == 0) {
+        if (wait == 0 || !cond_wait(&q->cond, &q->lock, timed, &ts)) {
+            pthread_mutex_unlock(&q->lock);
+            return pdFALSE;
+        }
+    }
+    if (q->item_size) memcpy(item, q->buf + (size_t)q->head * q->item_size, q->item_size);
+    q->head = (q->head + 1) % q->len;
+    q->count--;
+    pthread_cond_broadcast(&q->cond);
+    pthread_mutex_unlock(&q->lock);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t q) {
+    pthread_mutex_lock(&q->lock);
+    q->head = 0;
+    q->count = 0;
+    pthread_cond_broadcast(&q->cond);
+    pthread_mutex_unlock(&q->lock);
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+    pthread_mutex_lock(&q->lock);
+    UBaseType_t n = q->count;
+    pthread_mutex_unlock(&q->lock);
+    return n;
+}
@@ -0,0 +1,56 @@
+// tinfl_decompress na zlib: ten sam kontrakt co ROM (wejście kawałkami, wynik
+// do bufora cyklicznego start..start+rozmiar, okno z nagłówka nie większe niż
+// ten bufor). Okno trzyma zlib, więc bufor cykliczny służy tylko za wyjście.
+#include "rom/miniz.h"
+#include <stdlib.h>
+#include <zlib.h>
+
+static void stream_free(tinfl_decompressor* r) {
+    if (!r->z) return;
+    inflateEnd(r->z);
+    free(r->z);
+    r->z = NULL;
+}
+
+tinfl_status tinfl_decompress(tinfl_decompressor* r, const mz_uint8* in, size_t* in_n,
+                              mz_uint8* start, mz_uint8* next, size_t* out_n, const mz_uint32 flags) {
+    if (r->m_state == 2) {
+        *in_n = 0;
+        *out_n = 0;
+        return TINFL_STATUS_DONE;
+    }
+    if (r->m_state == 0) {
+        if (*in_n == 0) {
+            *out_n = 0;
+            return TINFL_STATUS_NEEDS_MORE_INPUT;
+        }
+        // CINFO z pierwszego bajtu: okno 1 << (CINFO + 8) musi się zmieścić w buforze
+        size_t dict = (size_t)(next - start) + *out_n;
+        if ((flags & TINFL_FLAG_PARSE_ZLIB_HEADER) && ((size_t)1 << ((in[0] >> 4) + 8)) > dict) {
+            return TINFL_STATUS_FAILED;
+        }
+        r->z = calloc(1, sizeof(z_stream));
+        if (!r->z || inflateInit(r->z) != Z_OK) return TINFL_STATUS_FAILED;
+        r->m_state = 1;
+    }
+
+    z_stream* z = r->z;
+    z->next_in = (Bytef*)in;
+    z->avail_in = (uInt)*in_n;
+    z->next_out = next;
+    z->avail_out = (uInt)*out_n;
+    int rc = inflate(z, Z_NO_FLUSH);
+    *in_n -= z->avail_in;
+    *out_n -= z->avail_out;
+
+    if (rc == Z_STREAM_END) {
+        stream_free(r);
+        r->m_state = 2;
+        return TINFL_STATUS_DONE;
+    }
+    if (rc != Z_OK && rc != Z_BUF_ERROR) {
+        stream_free(r);
+        return TINFL_STATUS_FAILED;        // także zła suma adler32
+    }
+    return z->avail_out == 0 ? TINFL_STATUS_HAS_MORE_OUTPUT : TINFL_STATUS_NEEDS_MORE_INPUT;
+}
@@ -0,0 +1,18 @@
+// Host stub: SHA-256 (host_sha256.c), interfejs jak mbedtls
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    uint64_t len;
+    uint32_t state[8];
+    uint8_t buf[64];
+} mbedtls_sha256_context;
+
+void mbedtls_sha256_init(mbedtls_sha256_context* ctx);
+void mbedtls_sha256_free(mbedtls_sha256_context* ctx);
+int mbedtls_sha256_starts(mbedtls_sha256_context* ctx, int is224);
+int mbedtls_sha256_update(mbedtls_sha256_context* ctx, const unsigned char* data, size_t len);
+int mbedtls_sha256_finish(mbedtls_sha256_context* ctx, unsigned char out[32]);
+void mbedtls_sha256_clone(mbedtls_sha256_context* dst, const mbedtls_sha256_context* src);
+int mbedtls_sha256(const unsigned char* data, size_t len, unsigned char out[32], int is224);
@@ -0,0 +1,27 @@
+// Host stub: API NVS nad magazynem w RAM z licznikami (host_nvs.h)
+#pragma once
+#include "esp_err.h"
+#include <stddef.h>
+
+typedef uint32_t nvs_handle_t;
+
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode_t;
+
+typedef enum {
+    NVS_TYPE_U32  = 0x04,
+    NVS_TYPE_STR  = 0x21,
+    NVS_TYPE_BLOB = 0x42,
+    NVS_TYPE_ANY  = 0xff
+} nvs_type_t;
+
+esp_err_t nvs_open(const char* ns, nvs_open_mode_t mode, nvs_handle_t* out);
+void nvs_close(nvs_handle_t h);
+esp_err_t nvs_set_str(nvs_handle_t h, const char* key, const char* value);
+esp_err_t nvs_set_u32(nvs_handle_t h, const char* key, uint32_t value);
+esp_err_t nvs_set_blob(nvs_handle_t h, const char* key, const void* value, size_t len);
+esp_err_t nvs_get_str(nvs_handle_t h, const char* key, char* out, size_t* len);
+esp_err_t nvs_get_u32(nvs_handle_t h, const char* key, uint32_t* out);
+esp_err_t nvs_get_blob(nvs_handle_t h, const char* key, void* out, size_t* len);
+esp_err_t nvs_erase_key(nvs_handle_t h, const char* key);
+esp_err_t nvs_erase_all(nvs_handle_t h);
+esp_err_t nvs_commit(nvs_handle_t h);
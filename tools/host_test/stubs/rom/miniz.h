@@ -0,0 +1,35 @@
+// Host stub: tinfl z ROM ESP32-C3 zastąpiony zlib (host_tinfl.c). Ten sam
+// kontrakt strumieniowy i bufor cykliczny, ale inny kod dekodera - czasy
+// dekodowania z hosta nie mówią nic o urządzeniu.
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t mz_uint8;
+typedef uint32_t mz_uint32;
+
+enum {
+    TINFL_FLAG_PARSE_ZLIB_HEADER = 1,
+    TINFL_FLAG_HAS_MORE_INPUT = 2,
+    TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF = 4,
+    TINFL_FLAG_COMPUTE_ADLER32 = 8,
+};
+
+typedef enum {
+    TINFL_STATUS_BAD_PARAM = -3,
+    TINFL_STATUS_ADLER32_MISMATCH = -2,
+    TINFL_STATUS_FAILED = -1,
+    TINFL_STATUS_DONE = 0,
+    TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+    TINFL_STATUS_HAS_MORE_OUTPUT = 2,
+} tinfl_status;
+
+typedef struct {
+    mz_uint32 m_state;
+    void* z;                        // z_stream, zwalniany przy DONE / błędzie
+} tinfl_decompressor;
+
+#define tinfl_init(r) do { (r)->m_state = 0; (r)->z = NULL; } while (0)
+
+tinfl_status tinfl_decompress(tinfl_decompressor* r, const mz_uint8* in, size_t* in_n,
+                              mz_uint8* start, mz_uint8* next, size_t* out_n, const mz_uint32 flags);
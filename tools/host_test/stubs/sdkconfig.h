@@ -0,0 +1,9 @@
+// Host stub: konfiguracja jak w sdkconfig.defaults, bez sprzętu
+#pragma once
+#define CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ 160
+#define CONFIG_LOG_DEFAULT_LEVEL 3
+#define CONFIG_FREERTOS_TASK_NOTIFICATION_ARRAY_ENTRIES 3
+#define CONFIG_BB_RLOG 1
+#define CONFIG_BB_RLOG_RING_SIZE 4096
+#define CONFIG_BB_RLOG_RATE 1024
+#define CONFIG_BB_BLOG_RING_SIZE 2048
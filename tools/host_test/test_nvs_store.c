@@ -0,0 +1,298 @@
+// Host test main/nvs_store.c na NVS w RAM (stubs/host_nvs.c):
+// poprawność, koszt zapisu na aktualizację logiczną, współbieżni pisarze i
+// czytelnicy, awaria zasilania w trakcie transakcji.
+//   make test
+#include "nvs_store.h"
+#include "host_nvs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TXN_KEYS 5
+#define RACE_ITERATIONS 300
+
+static int s_failures;
+
+static void check(bool ok, const char* what) {
+    printf("%-5s %s\n", ok ? "ok" : "FAIL", what);
+    if (!ok) s_failures++;
+}
+
+// Zapisy są asynchroniczne; GET przechodzi przez tę samą kolejkę FIFO,
+// więc po jego powrocie wszystkie wcześniejsze zapisy są w NVS
+static void barrier(void) {
+    uint32_t v;
+    nvs_store_get_u32("barrier", &v);
+}
+
+static const char* txn_key(int i) {
+    static const char* keys[TXN_KEYS] = { "k0", "k1", "k2", "k3", "k4" };
+    return keys[i];
+}
+
+static esp_err_t txn_all(uint32_t value) {
+    nvs_txn_handle_t txn;
+    esp_err_t err = nvs_store_txn_begin(&txn);
+    if (err != ESP_OK) return err;
+    for (int i = 0; i < TXN_KEYS; i++) nvs_store_txn_set_u32(txn, txn_key(i), value + i);
+    return nvs_store_txn_commit(txn);
+}
+
+// Jak progress_store w bb_ota.c
+static esp_err_t ota_checkpoint(uint32_t off) {
+    nvs_txn_handle_t txn;
+    esp_err_t err = nvs_store_txn_begin(&txn);
+    if (err != ESP_OK) return err;
+    nvs_store_txn_set_str(txn, "ota_id", "3f9a2c1e7b5d4e08a6c2f1d09b8e7a65");
+    nvs_store_txn_set_u32(txn, "ota_size", 1310720);
+    nvs_store_txn_set_u32(txn, "ota_part", 0x110000);
+    nvs_store_txn_set_u32(txn, "ota_off", off);
+    return nvs_store_txn_commit(txn);
+}
+
+// ===== POPRAWNOŚĆ =====
+typedef struct {
+    int calls;
+    int resets;
+    int commits;
+    int keys_at_commit;     // calls przy ostatnim COMMIT
+    uint32_t last_u32;
+} watch_log_t;
+
+static void on_change(const char* key, nvs_type_t type, const void* value, void* ctx) {
+    watch_log_t* log = ctx;
+    if (!key) {
+        if (*(const nvs_store_event_t*)value == NVS_STORE_EVENT_RESET) log->resets++;
+        else log->commits++;
+        log->keys_at_commit = log->calls;
+        return;
+    }
+    log->calls++;
+    if (type == NVS_TYPE_U32) log->last_u32 = *(const uint32_t*)value;
+}
+
+static void test_basic(void) {
+    char buf[64];
+    size_t len = 0;
+    uint32_t v = 0;
+
+    nvs_store_set_str("name", "boneboot");
+    nvs_store_set_u32("count", 42);
+    check(nvs_store_get_str("name", buf, sizeof(buf), &len) == ESP_OK && strcmp(buf, "boneboot") == 0,
+          "set_str / get_str");
+    check(nvs_store_get_u32("count", &v) == ESP_OK && v == 42, "set_u32 / get_u32");
+    check(nvs_store_get_u32("missing", &v) != ESP_OK, "get_u32 of a missing key fails");
+
+    uint32_t n = 0;
+    nvs_store_item_t items[] = {
+        { .key = "name",  .type = NVS_TYPE_STR, .buf = buf, .bufsize = sizeof(buf) },
+        { .key = "count", .type = NVS_TYPE_U32, .buf = &n,  .bufsize = sizeof(n) },
+    };
+    memset(buf, 0, sizeof(buf));
+    check(nvs_store_get_many(items, 2) == ESP_OK && strcmp(buf, "boneboot") == 0 && n == 42,
+          "get_many reads both keys in one pass");
+
+    // obce powiadomienie na indeksie 0 nie może obudzić czekającego na GET
+    xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+    nvs_store_set_u32("count", 43);
+    check(nvs_store_get_u32("count", &v) == ESP_OK && v == 43, "GET reply is not faked by a give on index 0");
+    check(ulTaskNotifyTake(pdTRUE, 0) == 1, "index-0 notification left for its owner");
+
+    watch_log_t log = { 0 };
+    nvs_store_watch("k*", on_change, &log);
+    txn_all(100);
+    barrier();
+    check(log.calls == TXN_KEYS && log.last_u32 == 100 + TXN_KEYS - 1, "watcher sees every key of a txn");
+    check(log.commits == 1 && log.keys_at_commit == TXN_KEYS, "one COMMIT event after the last key of a txn");
+    log.calls = 0;
+    txn_all(100);
+    barrier();
+    check(log.calls == TXN_KEYS && log.commits == 2, "unchanged txn still notifies (values confirmed)");
+    nvs_store_set_u32("k0", 5);
+    nvs_store_set_u32("count", 6);
+    barrier();
+    check(log.commits == 3 && log.keys_at_commit == TXN_KEYS + 1, "single set ends its own group; unmatched key sends none");
+    nvs_store_reset();
+    barrier();
+    check(log.resets == 1 && log.commits == 3, "reset reaches a prefix watcher once with key NULL");
+    check(nvs_store_get_u32("k0", &v) != ESP_OK, "reset erased the keys");
+    nvs_store_unwatch(on_change, &log);
+}
+
+// ===== KOSZT ZAPISU =====
+static void cost_row(const char* name, host_nvs_stats_t* s) {
+    printf("  %-34s %4" PRIu32 " %5" PRIu32 " %5" PRIu32 " %6" PRIu32 " %7" PRIu32 " %6" PRIu32 "\n",
+           name, s->set, s->set_blob, s->erase, s->commit, s->entries, s->bytes);
+}
+
+typedef void (*cost_fn_t)(void);
+
+static void cost_set_u32(void)   { nvs_store_set_u32("k0", 7); }
+static void cost_set_5x(void)    { for (int i = 0; i < TXN_KEYS; i++) nvs_store_set_u32(txn_key(i), 7 + i); }
+static void cost_txn_5(void)     { txn_all(7); }
+static void cost_txn_same(void)  { txn_all(1); }
+static void cost_ota_1(void)     { ota_checkpoint(65536 * 2); }
+
+static void cost_prepare(void) {
+    txn_all(1);
+    ota_checkpoint(65536);
+    barrier();
+}
+
+static host_nvs_stats_t cost_run(const char* name, cost_fn_t fn) {
+    host_nvs_stats_t s;
+    host_nvs_wipe();
+    cost_prepare();
+    host_nvs_stats_reset();
+    fn();
+    barrier();
+    host_nvs_stats(&s);
+    cost_row(name, &s);
+    return s;
+}
+
+static void test_cost(void) {
+    printf("\nflash cost per logical update (existing keys; NVS format model)\n");
+    printf("  %-34s %4s %5s %5s %6s %7s %6s\n", "update", "set", "blob", "erase", "commit", "entries", "bytes");
+    host_nvs_stats_t one = cost_run("set_u32, value changes", cost_set_u32);
+    host_nvs_stats_t plain = cost_run("5 x set_u32, no txn", cost_set_5x);
+    host_nvs_stats_t txn = cost_run("txn 5 x u32, all change", cost_txn_5);
+    host_nvs_stats_t same = cost_run("txn 5 x u32, none changes", cost_txn_same);
+    host_nvs_stats_t ota = cost_run("OTA checkpoint, 1 of 4 changes", cost_ota_1);
+    printf("  journal overhead: txn / plain = %.2fx bytes, %" PRIu32 " vs %" PRIu32 " commits\n",
+           (double)txn.bytes / plain.bytes, txn.commit, plain.commit);
+
+    check(txn.set == TXN_KEYS && txn.set_blob == 1 && txn.erase == 1 && txn.commit == 3,
+          "multi-key txn = journal blob + keys + journal erase, 3 commits");
+    check(same.set == 0 && same.set_blob == 0 && same.bytes == 0, "txn without changes writes nothing");
+    check(ota.set == 1 && ota.set_blob == 0 && ota.bytes == one.bytes, "txn with one change = plain write");
+}
+
+// ===== WSPÓŁBIEŻNOŚĆ =====
+// Jak [concurrency] w tools/nvs_bench: 2 pisarzy i 2 czytelników przez
+// kolejkę workera, na prawdziwych wątkach
+typedef struct {
+    int id;
+    int errors;             // wartość cofnęła się albo para z txn rozerwana
+    int rejected;           // odrzucone przez pełną kolejkę workera
+    TaskHandle_t parent;
+} race_ctx_t;
+
+static esp_err_t txn_pair(const char* a, const char* b, uint32_t value) {
+    nvs_txn_handle_t txn;
+    esp_err_t err = nvs_store_txn_begin(&txn);
+    if (err != ESP_OK) return err;
+    nvs_store_txn_set_u32(txn, a, value);
+    nvs_store_txn_set_u32(txn, b, value);
+    return nvs_store_txn_commit(txn);
+}
+
+static void race_writer(void* pv) {
+    race_ctx_t* c = pv;
+    const char* key = c->id ? "race_w1" : "race_w0";
+    for (uint32_t i = 1; i <= RACE_ITERATIONS; i++) {
+        if (nvs_store_set_u32(key, i) != ESP_OK) c->rejected++;
+        if (i % 10 == 0 && (c->id ? txn_pair("race_b0", "race_b1", i) : txn_pair("race_a0", "race_a1", i)) != ESP_OK) {
+            c->rejected++;
+        }
+    }
+    xTaskNotifyGive(c->parent);
+    vTaskDelete(NULL);
+}
+
+static void race_reader(void* pv) {
+    race_ctx_t* c = pv;
+    static const char* keys[2] = { "race_w0", "race_w1" };
+    uint32_t last[2] = { 0 };
+    for (int i = 0; i < RACE_ITERATIONS; i++) {
+        for (int w = 0; w < 2; w++) {
+            uint32_t v = 0;
+            if (nvs_store_get_u32(keys[w], &v) != ESP_OK) continue;
+            if (v < last[w]) c->errors++;
+            last[w] = v;
+        }
+        uint32_t a0 = 0, a1 = 0;
+        nvs_store_item_t items[2] = {
+            { .key = c->id ? "race_b0" : "race_a0", .type = NVS_TYPE_U32, .buf = &a0, .bufsize = sizeof(a0) },
+            { .key = c->id ? "race_b1" : "race_a1", .type = NVS_TYPE_U32, .buf = &a1, .bufsize = sizeof(a1) },
+        };
+        if (nvs_store_get_many(items, 2) == ESP_OK && a0 != a1) c->errors++;
+    }
+    xTaskNotifyGive(c->parent);
+    vTaskDelete(NULL);
+}
+
+static void test_race(void) {
+    race_ctx_t ctx[4] = { { .id = 0 }, { .id = 1 }, { .id = 0 }, { .id = 1 } };
+    host_nvs_wipe();
+    nvs_store_init();
+    for (int i = 0; i < 4; i++) {
+        ctx[i].parent = xTaskGetCurrentTaskHandle();
+        xTaskCreate(i < 2 ? race_writer : race_reader, i < 2 ? "writer" : "reader", 4096, &ctx[i], 5, NULL);
+    }
+    for (int i = 0; i < 4; i++) ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+
+    int errors = 0, rejected = 0;
+    for (int i = 0; i < 4; i++) {
+        errors += ctx[i].errors;
+        rejected += ctx[i].rejected;
+    }
+    uint32_t w0 = 0, w1 = 0;
+    nvs_store_get_u32("race_w0", &w0);
+    nvs_store_get_u32("race_w1", &w1);
+    printf("\n2 writers + 2 readers, %d ops each: %d consistency errors, %d rejected (queue full)\n",
+           RACE_ITERATIONS, errors, rejected);
+    check(errors == 0, "values never go back, txn pairs never seen half-applied");
+    check(rejected > 0 || (w0 == RACE_ITERATIONS && w1 == RACE_ITERATIONS), "every accepted write lands");
+}
+
+// ===== AWARIA ZASILANIA =====
+// Awaria po n zapisach w trakcie transakcji A -> B, potem restart (deinit +
+// init odtwarza journal): wszystkie klucze muszą mieć A albo wszystkie B
+static void test_power_loss(void) {
+    int old_seen = 0, new_seen = 0, torn = 0, runs = 0;
+
+    printf("\n");
+    for (int n = 0; n <= TXN_KEYS + 3; n++) {
+        host_nvs_wipe();
+        nvs_store_init();
+        txn_all(1000);
+        barrier();
+
+        host_nvs_fail_after(n);
+        txn_all(2000);
+        nvs_store_deinit();
+        host_nvs_fail_after(-1);
+        nvs_store_init();
+
+        int is_old = 0, is_new = 0;
+        for (int i = 0; i < TXN_KEYS; i++) {
+            uint32_t v = 0;
+            nvs_store_get_u32(txn_key(i), &v);
+            if (v == 1000u + i) is_old++;
+            if (v == 2000u + i) is_new++;
+        }
+        if (is_old == TXN_KEYS) old_seen++;
+        else if (is_new == TXN_KEYS) new_seen++;
+        else torn++;
+        runs++;
+    }
+    printf("power loss after 0..%d writes: %d rolled back, %d applied, %d torn\n",
+           TXN_KEYS + 3, old_seen, new_seen, torn);
+    check(torn == 0 && old_seen > 0 && new_seen > 0, "txn is all-or-nothing across power loss");
+}
+
+int main(void) {
+    host_nvs_wipe();
+    check(nvs_store_init() == ESP_OK, "init");
+    test_basic();
+    test_cost();
+    test_race();
+    test_power_loss();
+    nvs_store_deinit();
+
+    printf("\n%s: %d failure(s)\n", s_failures ? "FAIL" : "PASS", s_failures);
+    return s_failures ? 1 : 0;
+}
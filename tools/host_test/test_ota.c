@@ -0,0 +1,202 @@
+// Host test main/bb_ota.c (+ bb_inflate.c, nvs_store.c) na flash w RAM
+// (stubs/host_flash.c): obraz zwykły i zlib jak z tools/ota_server.py,
+// wznowienie po bb_ota_stop. Czasy z hosta (x86, zlib zamiast tinfl z ROM,
+// flash w RAM) tylko informacyjnie - dla urządzenia liczą się ms i
+// decode_ms z ota_done.
+//   make test
+#include "bb_ota.h"
+#include "bb_assets.h"
+#include "bbapi.h"
+#include "nvs_store.h"
+#include "host_flash.h"
+#include "host_nvs.h"
+#include "mbedtls/sha256.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#define IMAGE_SIZE      (1200 * 1024)
+#define CHUNK           4096            // ramka ota_server.py
+#define ZLIB_WBITS      12              // ota_server.py, = BB_INFLATE_DICT_SIZE
+#define STOP_AT         (300 * 1024)
+
+static int s_failures;
+
+static void check(bool ok, const char* what) {
+    printf("%-5s %s\n", ok ? "ok" : "FAIL", what);
+    if (!ok) s_failures++;
+}
+
+// ===== BBAPI / ws_comm / bb_assets =====
+static char s_tx[512];
+static char s_done_msg[512];            // ostatnie ota_done
+
+esp_err_t BBAPI_json_begin(bbapi_json_t* m, TickType_t to) {
+    m->slot.buf = s_tx;
+    m->slot.cap = sizeof(s_tx);
+    bb_json_begin(&m->json, s_tx, sizeof(s_tx));
+    return ESP_OK;
+}
+
+esp_err_t BBAPI_json_send(bbapi_json_t* m) {
+    size_t len;
+    esp_err_t err = bb_json_finish(&m->json, &len);
+    if (err == ESP_OK && strstr(s_tx, "\"ota_done\"")) memcpy(s_done_msg, s_tx, len + 1);
+    return err;
+}
+
+esp_err_t BBAPI_register_cmd(const char* name, bbapi_cmd_handler_t handler, const bbapi_arg_t* arg_schema, void* ctx) {
+    return ESP_OK;
+}
+
+void ws_comm_set_bin_cb(ws_comm_bin_cb_t cb, void* ctx) {}
+
+bool ws_comm_is_connected(void) {
+    return true;
+}
+
+const esp_partition_t* bb_assets_next(void) { return NULL; }
+const esp_partition_t* bb_assets_active(void) { return NULL; }
+uint32_t bb_assets_version(void) { return 0; }
+esp_err_t bb_assets_commit(const esp_partition_t* part, uint32_t version) { return ESP_ERR_NOT_SUPPORTED; }
+
+// ===== OBRAZ =====
+// Deterministyczny obraz "jak kod": słowa instrukcji RV32 z małego zbioru
+// opkodów i rejestrów, co 16 KB blok tekstu. Stopień kompresji zależy od
+// obrazu - dla prawdziwego wypisuje go tools/ota_server.py --zlib.
+static uint8_t* s_image;
+static uint8_t s_sha[32];
+
+static void image_make(void) {
+    static const uint32_t ops[] = { 0x13, 0x33, 0x03, 0x23, 0x63, 0x6f, 0x67, 0x37 };
+    static const char text[] = "WS_COMM: WS connected\0BB_OTA: update -> %s, %u B\0NVS_STORE: TXN apply\0";
+    uint32_t x = 12345;
+    s_image = malloc(IMAGE_SIZE);
+    for (size_t i = 0; i < IMAGE_SIZE; i += 4) {
+        if (i % 16384 < 1024) {
+            memcpy(s_image + i, text + i % (sizeof(text) - 4), 4);
+            continue;
+        }
+        x = x * 1103515245 + 12345;
+        uint32_t w = ops[(x >> 8) & 7] | ((x >> 12) & 7) << 7 | ((x >> 16) & 7) << 15 | ((x >> 20) & 0xff) << 20;
+        memcpy(s_image + i, &w, 4);
+    }
+    mbedtls_sha256(s_image, IMAGE_SIZE, s_sha, 0);
+}
+
+static uint8_t* deflate_image(int wbits, size_t* out_len) {
+    z_stream z = { 0 };
+    size_t cap = compressBound(IMAGE_SIZE);
+    uint8_t* out = malloc(cap);
+    deflateInit2(&z, 9, Z_DEFLATED, wbits, 8, Z_DEFAULT_STRATEGY);
+    z.next_in = s_image;
+    z.avail_in = IMAGE_SIZE;
+    z.next_out = out;
+    z.avail_out = (uInt)cap;
+    deflate(&z, Z_FINISH);
+    *out_len = z.total_out;
+    deflateEnd(&z);
+    return out;
+}
+
+// ===== POMOCNICZE =====
+static esp_err_t feed_all(const uint8_t* data, size_t from, size_t to) {
+    for (size_t off = from; off < to; off += CHUNK) {
+        size_t n = (to - off < CHUNK) ? to - off : CHUNK;
+        esp_err_t err = bb_ota_feed((uint32_t)off, data + off, n, pdMS_TO_TICKS(5000));
+        if (err != ESP_OK) return err;
+    }
+    return ESP_OK;
+}
+
+static bool slot_matches(void) {
+    host_flash_stats_t st;
+    host_flash_stats(&st);
+    return st.boot && memcmp(host_flash_data(st.boot), s_image, IMAGE_SIZE) == 0;
+}
+
+static void report(const char* name, size_t wire) {
+    printf("  %-6s %8u B on the wire (%.2fx)  %s\n", name, (unsigned)wire, (double)IMAGE_SIZE / wire, s_done_msg);
+}
+
+static void fresh(void) {
+    host_flash_wipe();
+    s_done_msg[0] = '\0';
+}
+
+// ===== TESTY =====
+static void test_plain(void) {
+    fresh();
+    esp_err_t err = bb_ota_begin_enc(IMAGE_SIZE, s_sha, IMAGE_SIZE, 0, BB_OTA_SRC_WS, false);
+    if (err == ESP_OK) err = feed_all(s_image, 0, IMAGE_SIZE);
+    if (err == ESP_OK) err = bb_ota_wait(pdMS_TO_TICKS(20000));
+    check(err == ESP_OK && slot_matches(), "plain image written, SHA-256 checked, boot slot set");
+    check(strstr(s_done_msg, "\"ok\":true") && strstr(s_done_msg, "\"decode_ms\":0"), "ota_done ok, no decode time");
+    report("plain", IMAGE_SIZE);
+}
+
+static void test_zlib(void) {
+    size_t zlen;
+    uint8_t* z = deflate_image(ZLIB_WBITS, &zlen);
+    fresh();
+    esp_err_t err = bb_ota_begin_enc(IMAGE_SIZE, s_sha, (uint32_t)zlen, BB_OTA_ENC_ZLIB, BB_OTA_SRC_WS, false);
+    if (err == ESP_OK) err = feed_all(z, 0, zlen);
+    if (err == ESP_OK) err = bb_ota_wait(pdMS_TO_TICKS(20000));
+    check(err == ESP_OK && slot_matches(), "zlib (4 KB window) inflated into the slot");
+    check(strstr(s_done_msg, "\"ok\":true") != NULL, "ota_done ok");
+    report("zlib", zlen);
+    free(z);
+
+    z = deflate_image(15, &zlen);
+    fresh();
+    err = bb_ota_begin_enc(IMAGE_SIZE, s_sha, (uint32_t)zlen, BB_OTA_ENC_ZLIB, BB_OTA_SRC_WS, false);
+    if (err == ESP_OK) feed_all(z, 0, zlen);     // feed może odmówić po błędzie dekodera
+    check(bb_ota_wait(pdMS_TO_TICKS(20000)) == ESP_ERR_INVALID_RESPONSE, "32 KB window rejected");
+    free(z);
+}
+
+// bb_ota_stop w trakcie (jak restart BBAPI): postęp zostaje, begin wznawia
+static void test_stop_resume(void) {
+    uint32_t off = 0;
+    fresh();
+    esp_err_t err = bb_ota_begin(IMAGE_SIZE, s_sha, BB_OTA_SRC_WS, false, &off);
+    if (err == ESP_OK) err = feed_all(s_image, 0, STOP_AT);
+    // zapis nadąża za feed najwyżej o dwa bufory
+    for (int i = 0; i < 200; i++) {
+        bb_ota_status_t st;
+        bb_ota_get_status(&st);
+        if (st.written == STOP_AT) break;
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+    bb_ota_stop();
+    check(err == ESP_OK && bb_ota_start() == ESP_OK, "stop mid-transfer, start again");
+
+    off = 0;
+    err = bb_ota_begin(IMAGE_SIZE, s_sha, BB_OTA_SRC_WS, false, &off);
+    check(err == ESP_OK && off == STOP_AT, "begin resumes at the offset written before stop");
+    if (err == ESP_OK) err = feed_all(s_image, off, IMAGE_SIZE);
+    if (err == ESP_OK) err = bb_ota_wait(pdMS_TO_TICKS(20000));
+    check(err == ESP_OK && slot_matches(), "resumed image complete, SHA-256 over both parts");
+
+    host_flash_stats_t st;
+    host_flash_stats(&st);
+    check(st.ota_resume == 1, "slot reopened with esp_ota_resume");
+}
+
+int main(void) {
+    host_nvs_wipe();
+    check(nvs_store_init() == ESP_OK && bb_ota_start() == ESP_OK, "init");
+    image_make();
+    printf("\nimage %u B; times below are host (x86, zlib decoder, RAM flash), not device\n", IMAGE_SIZE);
+    test_plain();
+    test_zlib();
+    test_stop_resume();
+    bb_ota_stop();
+    nvs_store_deinit();
+
+    printf("\n%s: %d failure(s)\n", s_failures ? "FAIL" : "PASS", s_failures);
+    return s_failures ? 1 : 0;
+}
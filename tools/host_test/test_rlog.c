@@ -0,0 +1,151 @@
+// Host test main/bb_rlog.c: ring, paczki w slocie TX, linie, które po
+// escapowaniu JSON nie mieszczą się nawet w pustej paczce.
+//   make test
+#include "bb_rlog.h"
+#include "bbapi.h"
+#include "ws_comm.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SLOT_CAP    512             // WS_COMM_MAX_MSG w ws_comm.c
+#define MAX_TOKENS  64
+
+static int s_failures;
+
+static void check(bool ok, const char* what) {
+    printf("%-5s %s\n", ok ? "ok" : "FAIL", what);
+    if (!ok) s_failures++;
+}
+
+// ===== ws_comm / BBAPI =====
+// Jeden slot niskiego priorytetu; ostatnia wysłana wiadomość zostaje w s_sent
+static char s_slot[SLOT_CAP];
+static char s_sent[SLOT_CAP + 1];
+static volatile int s_msgs;
+static volatile bool s_busy;
+
+bool ws_comm_is_connected(void) {
+    return true;
+}
+
+esp_err_t ws_comm_tx_reserve_low(ws_tx_slot_t* slot) {
+    if (s_busy) return ESP_ERR_TIMEOUT;
+    s_busy = true;
+    slot->buf = s_slot;
+    slot->cap = sizeof(s_slot);
+    slot->idx = 0;
+    slot->low = 1;
+    slot->bin = 0;
+    return ESP_OK;
+}
+
+esp_err_t ws_comm_tx_commit(ws_tx_slot_t* slot, size_t len) {
+    memcpy(s_sent, slot->buf, len);
+    s_sent[len] = '\0';
+    s_msgs++;
+    s_busy = false;
+    return ESP_OK;
+}
+
+void ws_comm_tx_cancel(ws_tx_slot_t* slot) {
+    s_busy = false;
+}
+
+esp_err_t BBAPI_register_cmd(const char* name, bbapi_cmd_handler_t handler, const bbapi_arg_t* arg_schema, void* ctx) {
+    return ESP_OK;
+}
+
+// ===== POMOCNICZE =====
+static void log_line(const char* body) {
+    esp_log_write(ESP_LOG_WARN, "T", "W (%d) %s: %s\n", 2, "T", body);
+}
+
+// Czeka, aż task wyśle `msgs` wiadomości (tick taska = 200 ms)
+static bool wait_msgs(int msgs) {
+    for (int i = 0; i < 200 && s_msgs < msgs; i++) vTaskDelay(pdMS_TO_TICKS(10));
+    return s_msgs >= msgs;
+}
+
+// Pierwsza linia z ostatniej paczki, po odescapowaniu; -1 gdy paczka to nie JSON
+static int sent_line(char* out, size_t outsize) {
+    static bb_jtok_t tok[MAX_TOKENS];
+    int n = bb_jtok_parse(s_sent, strlen(s_sent), tok, MAX_TOKENS);
+    if (n <= 0) return -1;
+    int l = bb_jtok_obj_get(s_sent, tok, n, 0, "l");
+    if (l <= 0 || tok[l].type != BB_JTOK_ARR || tok[l].size < 1) return -1;
+    return bb_jtok_str(s_sent, &tok[l + 1], out, outsize);
+}
+
+static bool utf8_valid(const char* s, size_t n) {
+    for (size_t i = 0; i < n;) {
+        unsigned char c = (unsigned char)s[i];
+        size_t len = c < 0x80 ? 1 : (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : (c & 0xF8) == 0xF0 ? 4 : 0;
+        if (len == 0 || i + len > n) return false;
+        for (size_t k = 1; k < len; k++) {
+            if (((unsigned char)s[i + k] & 0xC0) != 0x80) return false;
+        }
+        i += len;
+    }
+    return true;
+}
+
+// ===== TESTY =====
+static void test_plain(void) {
+    char line[BB_RLOG_LINE_MAX];
+    int before = s_msgs;
+    log_line("hello");
+    check(wait_msgs(before + 1), "short line is sent");
+    check(sent_line(line, sizeof(line)) >= 0 && strcmp(line, "W (2) T: hello") == 0, "line text survives the round trip");
+}
+
+// 70 znaków sterujących (6 B po escapowaniu) + 23 x "ą": ~480 B w JSON przy
+// 126 B surowo - więcej niż zostaje w pustej paczce. Nieparzysta liczba
+// bajtów przed "ą" sprawia, że granica cięcia wypada w środku znaku UTF-8.
+static void test_oversized(void) {
+    char body[BB_RLOG_LINE_MAX];
+    char line[SLOT_CAP];
+    size_t n = 0;
+    body[n++] = 'x';
+    for (int i = 0; i < 70; i++) body[n++] = '\x01';
+    for (int i = 0; i < 23; i++) {
+        body[n++] = (char)0xC4;
+        body[n++] = (char)0x85;
+    }
+    body[n] = '\0';
+
+    bb_rlog_stats_t st;
+    int before = s_msgs;
+    log_line(body);
+    log_line("after");
+    check(wait_msgs(before + 2), "oversized line does not stall the stream");
+
+    bb_rlog_get_stats(&st);
+    check(st.truncated == 1, "oversized line counted in truncated");
+    check(st.ring_used == 0, "ring drained");
+    check(strstr(s_sent, "W (2) T: after") != NULL, "next line sent after the truncated one");
+
+    // paczka z obciętą linią przyszła jako przedostatnia - wyślij ją jeszcze raz
+    // w osobnej paczce, żeby sprawdzić treść
+    before = s_msgs;
+    log_line(body);
+    check(wait_msgs(before + 1), "truncated line resent");
+    int len = sent_line(line, sizeof(line));
+    check(len > 0 && strlen(s_sent) <= SLOT_CAP, "truncated batch is valid JSON within the slot");
+    check(len > 0 && (size_t)len < strlen("W (2) T: ") + n && memcmp(line, "W (2) T: x\x01", 11) == 0,
+          "truncated line keeps its prefix");
+    check(len > 0 && utf8_valid(line, (size_t)len), "cut does not split a UTF-8 character");
+}
+
+int main(void) {
+    check(bb_rlog_start() == ESP_OK, "start");
+    bb_rlog_set_rate(0);
+    bb_rlog_set_level("*", ESP_LOG_INFO);
+    test_plain();
+    test_oversized();
+    bb_rlog_stop();
+
+    printf("\n%s: %d failure(s)\n", s_failures ? "FAIL" : "PASS", s_failures);
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,178 @@
+// Host test RX main/ws_comm.c: składanie wiadomości tekstowych z części
+// ramek i ramek fin = 0, klasy slotów 1 KB / 4 KB, odrzucanie za długich.
+// Klient websocket podstawiony niżej: zdarzenia woła test, jak task klienta.
+//   make test
+#include "ws_comm.h"
+#include "bb_blog.h"
+#include "esp_websocket_client.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SMALL_SLOTS 16              // WS_COMM_RX_QUEUE_LEN
+#define BIG_SLOTS   2               // WS_COMM_RX_BIG_SLOTS
+#define BIG_MAX     4096            // WS_COMM_RX_BIG_MSG - 1
+#define CLIENT_BUF  1024            // części ramki jak przy buffer_size klienta
+
+static int s_failures;
+
+static void check(bool ok, const char* what) {
+    printf("%-5s %s\n", ok ? "ok" : "FAIL", what);
+    if (!ok) s_failures++;
+}
+
+// ===== KLIENT WEBSOCKET =====
+static struct esp_websocket_client { int dummy; } s_client;
+static esp_event_handler_t volatile s_handler;
+
+esp_websocket_client_handle_t esp_websocket_client_init(const esp_websocket_client_config_t* cfg) {
+    return &s_client;
+}
+
+esp_err_t esp_websocket_register_events(esp_websocket_client_handle_t c, esp_websocket_event_id_t ev,
+                                        esp_event_handler_t fn, void* arg) {
+    s_handler = fn;
+    return ESP_OK;
+}
+
+esp_err_t esp_websocket_unregister_events(esp_websocket_client_handle_t c, esp_websocket_event_id_t ev,
+                                          esp_event_handler_t fn) {
+    s_handler = NULL;
+    return ESP_OK;
+}
+
+esp_err_t esp_websocket_client_start(esp_websocket_client_handle_t c) { return ESP_OK; }
+esp_err_t esp_websocket_client_close(esp_websocket_client_handle_t c, TickType_t to) { return ESP_OK; }
+esp_err_t esp_websocket_client_destroy(esp_websocket_client_handle_t c) { return ESP_OK; }
+
+int esp_websocket_client_send_text(esp_websocket_client_handle_t c, const char* data, int len, TickType_t to) {
+    return len;
+}
+
+int esp_websocket_client_send_bin(esp_websocket_client_handle_t c, const char* data, int len, TickType_t to) {
+    return len;
+}
+
+volatile uint8_t bb_blog_level = ESP_LOG_NONE;
+void bb_blog_write(const bb_blog_desc_t* d, uint8_t argc, uint16_t types, ...) {}
+
+// ===== POMOCNICZE =====
+static char s_text[8192];
+
+static void event(int32_t id, esp_websocket_event_data_t* d) {
+    s_handler(NULL, "WEBSOCKET_EVENTS", id, d);
+}
+
+// Część ramki: len B od off z ramki o długości total
+static void part(int op, bool fin, size_t off, size_t len, size_t total, const char* data) {
+    esp_websocket_event_data_t d = {
+        .data_ptr = data + off, .data_len = (int)len, .fin = fin, .op_code = (uint8_t)op,
+        .payload_len = (int)total, .payload_offset = (int)off,
+    };
+    event(WEBSOCKET_EVENT_DATA, &d);
+}
+
+// Cała ramka, pocięta na części CLIENT_BUF jak robi klient
+static void frame(int op, bool fin, const char* data, size_t total) {
+    size_t off = 0;
+    do {
+        size_t len = (total - off < CLIENT_BUF) ? total - off : CLIENT_BUF;
+        part(op, fin, off, len, total, data);
+        off += len;
+    } while (off < total);
+}
+
+static void message(const char* data, size_t total) {
+    frame(1, true, data, total);
+}
+
+// Długość odebranej wiadomości albo -1; treść porównana z s_text + from
+static int take(size_t from) {
+    ws_rx_slot_t slot;
+    if (!ws_comm_rx_take(&slot, 0)) return -1;
+    int len = (int)slot.len;
+    if (slot.buf[slot.len] != '\0' || memcmp(slot.buf, s_text + from, slot.len) != 0) len = -2;
+    ws_comm_rx_release(&slot);
+    return len;
+}
+
+static ws_comm_stats_t stats(void) {
+    ws_comm_stats_t st;
+    ws_comm_get_stats(&st);
+    return st;
+}
+
+// ===== TESTY =====
+static void test_small(void) {
+    message(s_text, 7);
+    check(take(0) == 7, "short message");
+
+    part(1, true, 0, 500, 900, s_text);
+    part(1, true, 500, 400, 900, s_text);
+    check(take(0) == 900, "frame in two client parts");
+
+    frame(1, false, s_text, 300);
+    check(take(0) == -1, "fragment alone is not delivered");
+    frame(0, true, s_text + 300, 200);
+    check(take(0) == 500, "two fragments joined");
+}
+
+static void test_big(void) {
+    message(s_text, BIG_MAX);
+    check(take(0) == BIG_MAX, "4 KB frame goes to a big slot");
+
+    // długość nieznana z góry: start w małym slocie, przeniesienie po 1 KB
+    for (int i = 0; i < 5; i++) frame(i ? 0 : 1, false, s_text + i * 800, 800);
+    frame(0, true, s_text + 4000, BIG_MAX - 4000);
+    check(take(0) == BIG_MAX, "4 KB in 800 B fragments grows into a big slot");
+
+    uint32_t trunc = stats().rx_trunc;
+    message(s_text, BIG_MAX + 1);
+    check(take(0) == -1 && stats().rx_trunc == trunc + 1, "frame over 4 KB dropped as rx_trunc");
+
+    for (int i = 0; i < 6; i++) frame(i ? 0 : 1, false, s_text + i * 800, 800);
+    frame(0, true, s_text, 10);
+    check(take(0) == -1 && stats().rx_trunc == trunc + 2, "fragments over 4 KB in sum dropped as rx_trunc");
+
+    frame(1, false, s_text, 100);
+    message(s_text, 2);
+    check(take(0) == 2 && stats().rx_trunc == trunc + 3, "message cut off by a new one");
+}
+
+static void test_exhaust(void) {
+    uint32_t drop = stats().rx_drop;
+    for (int i = 0; i < BIG_SLOTS + 1; i++) message(s_text, 2000);
+    check(stats().rx_drop == drop + 1, "no free big slot: rx_drop");
+    int got = 0;
+    while (take(0) == 2000) got++;
+    check(got == BIG_SLOTS, "big slots delivered while small ones stay free");
+
+    for (int i = 0; i < SMALL_SLOTS; i++) message(s_text, 100);
+    for (int i = 0; i < BIG_SLOTS; i++) message(s_text, BIG_MAX);
+    int small = 0, big = 0, len;
+    while ((len = take(0)) > 0) {
+        if (len == 100) small++;
+        if (len == BIG_MAX) big++;
+    }
+    check(small == SMALL_SLOTS && big == BIG_SLOTS && stats().rx_drop == drop + 1,
+          "every slot back in its pool after release");
+}
+
+int main(void) {
+    for (size_t i = 0; i < sizeof(s_text); i++) s_text[i] = (char)('a' + i % 26);
+
+    check(ws_comm_start("ws://host.test/ws") == ESP_OK, "start");
+    for (int i = 0; i < 100 && !s_handler; i++) vTaskDelay(pdMS_TO_TICKS(10));
+    check(s_handler != NULL, "client events registered");
+    if (s_handler) {
+        event(WEBSOCKET_EVENT_CONNECTED, NULL);
+        test_small();
+        test_big();
+        test_exhaust();
+    }
+    ws_comm_stop();
+
+    printf("\n%s: %d failure(s)\n", s_failures ? "FAIL" : "PASS", s_failures);
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,297 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <inttypes.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_private/partition_linux.h"
+
+#include "nvs_store.h"
+
+#define TAG "NVS_BENCH"
+
+#define BENCH_ITERATIONS   200
+#define TXN_KEYS           5
+#define RACE_ITERATIONS    300
+#define PL_ROUNDS          200
+#define PL_MAX_WRITES      24      // awaria losowo w ciągu pierwszych N zapisów do flasha
+
+typedef struct {
+    const char* name;
+    int n;
+    int64_t samples[BENCH_ITERATIONS];
+} lat_t;
+
+static int s_failures = 0;
+
+static int64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int cmp_i64(const void* a, const void* b)
+{
+    int64_t x = *(const int64_t*)a, y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void lat_print(lat_t* l)
+{
+    int64_t sum = 0;
+    for (int i = 0; i < l->n; i++) sum += l->samples[i];
+    qsort(l->samples, l->n, sizeof(l->samples[0]), cmp_i64);
+    printf("  %-22s n=%3d avg=%7" PRId64 " p50=%7" PRId64 " p99=%7" PRId64 " max=%7" PRId64 " us\n",
+           l->name, l->n, sum / l->n, l->samples[l->n / 2], l->samples[(l->n * 99) / 100], l->samples[l->n - 1]);
+}
+
+// SET jest asynchroniczny - GET za nim w tej samej kolejce czeka aż zapis się wykona
+static void sync_worker(void)
+{
+    uint32_t v;
+    nvs_store_get_u32("bench_sync", &v);
+}
+
+static esp_err_t txn_write(const char* prefix, uint32_t value, int nkeys)
+{
+    nvs_txn_handle_t txn;
+    esp_err_t err = nvs_store_txn_begin(&txn);
+    if (err != ESP_OK) return err;
+    for (int k = 0; k < nkeys; k++) {
+        char key[16];
+        snprintf(key, sizeof(key), "%s%d", prefix, k);
+        nvs_store_txn_set_u32(txn, key, value);
+    }
+    return nvs_store_txn_commit(txn);
+}
+
+// ===== 1) opóźnienia i przepustowość =====
+static void bench_latency(void)
+{
+    static lat_t set_async = { .name = "set_str (enqueue)" };
+    static lat_t set_sync  = { .name = "set_u32 (committed)" };
+    static lat_t get_str   = { .name = "get_str" };
+    static lat_t get_u32   = { .name = "get_u32" };
+    static lat_t txn       = { .name = "txn commit (5 keys)" };
+    char buf[64];
+
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        snprintf(buf, sizeof(buf), "value-%d", i);
+        int64_t t0 = now_us();
+        nvs_store_set_str("bench_s", buf);
+        set_async.samples[set_async.n++] = now_us() - t0;
+        sync_worker();
+
+        t0 = now_us();
+        nvs_store_set_u32("bench_u", i);
+        sync_worker();
+        set_sync.samples[set_sync.n++] = now_us() - t0;
+
+        t0 = now_us();
+        nvs_store_get_str("bench_s", buf, sizeof(buf), NULL);
+        get_str.samples[get_str.n++] = now_us() - t0;
+
+        uint32_t v;
+        t0 = now_us();
+        nvs_store_get_u32("bench_u", &v);
+        get_u32.samples[get_u32.n++] = now_us() - t0;
+
+        t0 = now_us();
+        txn_write("bench_t", i, TXN_KEYS);
+        txn.samples[txn.n++] = now_us() - t0;
+    }
+
+    printf("\n[latency]\n");
+    int64_t set_total = 0, txn_total = 0;
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        set_total += set_sync.samples[i];
+        txn_total += txn.samples[i];
+    }
+    lat_print(&set_async);
+    lat_print(&set_sync);
+    lat_print(&get_str);
+    lat_print(&get_u32);
+    lat_print(&txn);
+
+    printf("\n[throughput]\n");
+    printf("  single-key commits/s   %8.1f\n", BENCH_ITERATIONS * 1e6 / set_total);
+    printf("  txn commits/s          %8.1f (%.1f keys/s)\n",
+           BENCH_ITERATIONS * 1e6 / txn_total, BENCH_ITERATIONS * TXN_KEYS * 1e6 / txn_total);
+}
+
+// ===== 2) bajty zapisane do flasha na logiczną zmianę =====
+static void bench_flash_cost(void)
+{
+    printf("\n[flash cost per logical update]\n");
+
+    esp_partition_clear_stats();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        nvs_store_set_u32("bench_u", 1000 + i);
+    }
+    sync_worker();
+    printf("  set_u32                %6zu B written, %.2f erases / update\n",
+           esp_partition_get_write_bytes() / BENCH_ITERATIONS,
+           (double)esp_partition_get_erase_ops() / BENCH_ITERATIONS);
+
+    esp_partition_clear_stats();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        nvs_store_set_str("bench_s", "a-typical-identity-string-32-chr");
+    }
+    sync_worker();
+    printf("  set_str (32 B)         %6zu B written, %.2f erases / update\n",
+           esp_partition_get_write_bytes() / BENCH_ITERATIONS,
+           (double)esp_partition_get_erase_ops() / BENCH_ITERATIONS);
+
+    esp_partition_clear_stats();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        txn_write("bench_t", 2000 + i, TXN_KEYS);
+    }
+    size_t bytes = esp_partition_get_write_bytes();
+    printf("  txn (%d x u32)          %6zu B written per txn, %zu B per key\n",
+           TXN_KEYS, bytes / BENCH_ITERATIONS, bytes / (BENCH_ITERATIONS * TXN_KEYS));
+}
+
+// ===== 3) współbieżni czytelnicy i pisarze =====
+typedef struct {
+    int id;
+    int errors;             // naruszenia spójności
+    int rejected;           // odrzucone przez pełną kolejkę workera
+    TaskHandle_t parent;
+} race_ctx_t;
+
+static void race_writer(void* pv)
+{
+    race_ctx_t* c = pv;
+    char key[16];
+    snprintf(key, sizeof(key), "race_w%d", c->id);
+    for (uint32_t i = 1; i <= RACE_ITERATIONS; i++) {
+        if (nvs_store_set_u32(key, i) != ESP_OK) c->rejected++;
+        // para zapisywana transakcją musi być zawsze widoczna razem
+        if (i % 10 == 0 && txn_write(c->id ? "race_b" : "race_a", i, 2) != ESP_OK) c->rejected++;
+    }
+    xTaskNotifyGive(c->parent);
+    vTaskDelete(NULL);
+}
+
+static void race_reader(void* pv)
+{
+    race_ctx_t* c = pv;
+    uint32_t last[2] = {0};
+    for (int i = 0; i < RACE_ITERATIONS; i++) {
+        for (int w = 0; w < 2; w++) {
+            char key[16];
+            snprintf(key, sizeof(key), "race_w%d", w);
+            uint32_t v = 0;
+            esp_err_t err = nvs_store_get_u32(key, &v);
+            if (err == ESP_OK && v < last[w]) c->errors++;     // wartość cofnęła się
+            if (err == ESP_OK) last[w] = v;
+        }
+
+        uint32_t a0 = 0, a1 = 0;
+        nvs_store_item_t items[2] = {
+            { .key = "race_a0", .type = NVS_TYPE_U32, .buf = &a0, .bufsize = sizeof(a0) },
+            { .key = "race_a1", .type = NVS_TYPE_U32, .buf = &a1, .bufsize = sizeof(a1) },
+        };
+        if (nvs_store_get_many(items, 2) == ESP_OK && a0 != a1) c->errors++;   // rozerwana transakcja
+    }
+    xTaskNotifyGive(c->parent);
+    vTaskDelete(NULL);
+}
+
+static void bench_race(void)
+{
+    race_ctx_t ctx[4] = {
+        { .id = 0 }, { .id = 1 }, { .id = 0 }, { .id = 1 },
+    };
+    int64_t t0 = now_us();
+    for (int i = 0; i < 4; i++) {
+        ctx[i].parent = xTaskGetCurrentTaskHandle();
+        xTaskCreate(i < 2 ? race_writer : race_reader, i < 2 ? "writer" : "reader", 4096, &ctx[i], 5, NULL);
+    }
+    for (int i = 0; i < 4; i++) ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+
+    int errors = 0, rejected = 0;
+    for (int i = 0; i < 4; i++) {
+        errors += ctx[i].errors;
+        rejected += ctx[i].rejected;
+    }
+    printf("\n[concurrency] 2 writers + 2 readers, %d ops each: %d consistency errors, %d rejected (queue full), %.1f ms\n",
+           RACE_ITERATIONS, errors, rejected, (now_us() - t0) / 1000.0);
+    s_failures += errors;
+}
+
+// ===== 4) utrata zasilania w losowym momencie =====
+static void reboot(void)
+{
+    nvs_store_deinit();
+    esp_partition_fail_after(SIZE_MAX, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+    ESP_ERROR_CHECK(nvs_store_init());
+}
+
+static void bench_power_loss(unsigned seed)
+{
+    int torn = 0, bad_single = 0, applied = 0;
+    uint32_t committed = 0, single_prev = 0;
+
+    for (uint32_t gen = 1; gen <= PL_ROUNDS; gen++) {
+        esp_partition_fail_after(1 + rand_r(&seed) % PL_MAX_WRITES, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+        txn_write("pl", gen, TXN_KEYS);
+        nvs_store_set_u32("pl_single", gen);
+        sync_worker();
+        reboot();
+
+        uint32_t v[TXN_KEYS] = {0};
+        nvs_store_item_t items[TXN_KEYS];
+        char keys[TXN_KEYS][16];
+        for (int k = 0; k < TXN_KEYS; k++) {
+            snprintf(keys[k], sizeof(keys[k]), "pl%d", k);
+            items[k] = (nvs_store_item_t){ .key = keys[k], .type = NVS_TYPE_U32, .buf = &v[k], .bufsize = sizeof(v[k]) };
+        }
+        nvs_store_get_many(items, TXN_KEYS);
+
+        // wszystkie klucze transakcji: stara albo nowa generacja, nigdy mieszanka
+        for (int k = 1; k < TXN_KEYS; k++) {
+            if (items[k].err != items[0].err || v[k] != v[0]) {
+                torn++;
+                break;
+            }
+        }
+        if (v[0] != gen && v[0] != committed) torn++;
+        if (v[0] == gen) applied++;
+        committed = v[0];
+
+        // pojedynczy klucz: nowa wartość albo ostatnia zapisana, nigdy śmieci
+        uint32_t single = 0;
+        nvs_store_get_u32("pl_single", &single);
+        if (single != gen && single != single_prev) bad_single++;
+        single_prev = single;
+    }
+
+    printf("\n[power loss] seed=%u rounds=%d: txn applied %d, rolled back %d, torn %d, bad single-key %d\n",
+           seed, PL_ROUNDS, applied, PL_ROUNDS - applied, torn, bad_single);
+    s_failures += torn + bad_single;
+}
+
+void app_main(void)
+{
+    esp_log_level_set("*", ESP_LOG_WARN);
+    ESP_ERROR_CHECK(nvs_store_init());
+
+    unsigned seed = (unsigned)time(NULL);
+    const char* env = getenv("NVS_BENCH_SEED");
+    if (env) seed = (unsigned)strtoul(env, NULL, 0);
+
+    bench_latency();
+    bench_flash_cost();
+    bench_race();
+    bench_power_loss(seed);
+
+    printf("\nresult: %s\n", s_failures ? "FAIL" : "OK");
+    fflush(stdout);
+    exit(s_failures ? 1 : 0);
+}
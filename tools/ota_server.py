@@ -0,0 +1,284 @@
+#!/usr/bin/env python3
+"""Stand-in WebSocket server that pushes an OTA image to one BootBone device.
+
+Point the device at this host (ws_uri = ws://<host>:<port>/) and run:
+
+  tools/ota_server.py build/BootBone.bin --reboot
+
+On connect the server sends an "ota_begin" command, then streams the image as
+binary frames [u8 'O'][u8 0][u16 0][u32 offset LE][data] of `chunk` bytes,
+keeping at most `window` unacknowledged bytes in flight (both from the
+ota_begin reply). The device acknowledges flashed data with
+{"type":"ota_ack","off":N} and finishes with {"type":"ota_done",...}, which is
+printed together with the throughput seen by the server.
+
+Interrupted transfers resume: the server keeps listening, and when the device
+reconnects the same ota_begin returns "offset" (flashed bytes kept on the
+device), so only the rest is sent. --drop-every N closes the connection after
+every N bytes sent to exercise this path.
+
+With --base OLD.bin (the image the device runs now) a delta patch is sent
+instead of the image (tools/bbdelta.py); the device rebuilds the new image
+from its running slot. Delta sessions restart from the beginning.
+
+--zlib compresses what is sent (image or patch) with a 4 KB window, which is
+what the device can inflate; ota_done then reports "decode_ms", the device
+time spent inflating and writing, to compare with an uncompressed run.
+
+--assets VERSION sends a portal asset bundle instead of the application
+(tools/gen_web_assets.py --bundle VERSION, same version), e.g.
+
+  tools/gen_web_assets.py --bundle 2 -o build/assets.bin assets/*
+  tools/ota_server.py build/assets.bin --assets 2
+
+The device writes the inactive storage bank, checks the bundle and switches
+to it without a restart; VERSION must be higher than the installed one. Combines with --base (the
+bank image the device runs now) and --zlib.
+
+Only the Python standard library is used (minimal RFC 6455 server); device
+pings are answered so the link stays up while nothing else is connected.
+"""
+
+import argparse
+import asyncio
+import base64
+import hashlib
+import json
+import os
+import struct
+import sys
+import time
+import zlib
+
+import bbdelta
+
+WS_GUID = '258EAFA5-E914-47DA-95CA-C5AB0DC85B11'
+OP_CONT, OP_TEXT, OP_BIN, OP_CLOSE, OP_PING, OP_PONG = 0, 1, 2, 8, 9, 10
+FRAME_MAGIC = ord('O')
+FRAME_DATA = 0
+ZLIB_WBITS = 12     # BB_INFLATE_DICT_SIZE on the device
+
+
+class WsConn:
+    """Server side of one WebSocket connection (unmasked TX, masked RX)."""
+
+    def __init__(self, reader, writer):
+        self.r, self.w = reader, writer
+
+    async def handshake(self):
+        head = await self.r.readuntil(b'\r\n\r\n')
+        key = None
+        for line in head.decode('latin-1').split('\r\n'):
+            name, _, value = line.partition(':')
+            if name.strip().lower() == 'sec-websocket-key':
+                key = value.strip()
+        if not key:
+            raise ConnectionError('not a WebSocket upgrade')
+        accept = base64.b64encode(hashlib.sha1((key + WS_GUID).encode()).digest()).decode()
+        self.w.write(('HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n'
+                      'Connection: Upgrade\r\nSec-WebSocket-Accept: %s\r\n\r\n' % accept).encode())
+        await self.w.drain()
+
+    async def send(self, op, payload):
+        n = len(payload)
+        if n < 126:
+            hdr = struct.pack('!BB', 0x80 | op, n)
+        elif n < 65536:
+            hdr = struct.pack('!BBH', 0x80 | op, 126, n)
+        else:
+            hdr = struct.pack('!BBQ', 0x80 | op, 127, n)
+        self.w.write(hdr + payload)
+        await self.w.drain()
+
+    async def send_json(self, obj):
+        await self.send(OP_TEXT, json.dumps(obj, separators=(',', ':')).encode())
+
+    async def recv(self):
+        """Next complete text message (str); None on close."""
+        parts, msg_op = [], None
+        while True:
+            b0, b1 = await self.r.readexactly(2)
+            op, n = b0 & 0x0F, b1 & 0x7F
+            if n == 126:
+                n, = struct.unpack('!H', await self.r.readexactly(2))
+            elif n == 127:
+                n, = struct.unpack('!Q', await self.r.readexactly(8))
+            mask = await self.r.readexactly(4) if b1 & 0x80 else b'\0\0\0\0'
+            data = bytes(c ^ mask[i & 3] for i, c in enumerate(await self.r.readexactly(n)))
+            if op == OP_CLOSE:
+                return None
+            if op == OP_PING:
+                await self.send(OP_PONG, data)
+                continue
+            if op == OP_PONG:
+                continue
+            if op != OP_CONT:
+                msg_op, parts = op, []
+            parts.append(data)
+            if b0 & 0x80 and msg_op == OP_TEXT:
+                return b''.join(parts).decode('utf-8', 'replace')
+
+
+class OtaPush:
+    def __init__(self, args, image, payload, enc):
+        self.args = args
+        self.image = image
+        self.sha256 = hashlib.sha256(image).hexdigest()
+        self.payload = payload          # what travels: image, patch, compressed
+        self.enc = enc                  # extra ota_begin args ("delta", "zlib")
+        self.done = asyncio.Event()
+        self.result = None
+        self.sent = 0                   # all sessions, including resent data
+        self.sessions = 0
+        self.t0 = None
+
+    async def session(self, ws):
+        args = self.args
+        data = self.payload
+        ack_event = asyncio.Event()
+        begin = {'type': 'cmd', 'name': 'ota_begin', 'id': 'ota',
+                 'args': {'size': len(self.image), 'sha256': self.sha256, 'reboot': args.reboot}}
+        begin['args'].update(self.enc)
+        if args.assets:
+            begin['args'].update({'target': 'assets', 'version': args.assets})
+        await ws.send_json(begin)
+
+        reply = None
+        while reply is None:
+            text = await ws.recv()
+            if text is None:
+                raise ConnectionError('device closed before ota_begin reply')
+            msg = json.loads(text)
+            if msg.get('type') == 'ping':
+                await ws.send_json({'type': 'pong'})
+            elif msg.get('id') == 'ota' and msg.get('type') in ('ack', 'err'):
+                reply = msg
+        if reply['type'] == 'err':
+            raise RuntimeError('ota_begin rejected: %s %s' % (reply.get('err'), reply.get('msg', '')))
+        res = reply.get('result', {})
+        chunk = min(args.chunk or res.get('chunk', 4096), res.get('chunk', 4096))
+        window = res.get('window', 2 * chunk)
+        off = acked = res.get('offset', 0)
+        print('device slot %s, chunk %d B, window %d B, from offset %d' % (res.get('part'), chunk, window, off))
+
+        async def reader():
+            nonlocal acked
+            while True:
+                text = await ws.recv()
+                if text is None:
+                    raise ConnectionError('device closed the connection')
+                msg = json.loads(text)
+                t = msg.get('type')
+                if t == 'ping':
+                    await ws.send_json({'type': 'pong'})
+                elif t == 'ota_ack':
+                    acked = max(acked, msg['off'])
+                    ack_event.set()
+                elif t == 'ota_resume':
+                    print('device reports unfinished update at %d B' % msg.get('off', 0))
+                elif t == 'ota_done':
+                    self.result = msg
+                    acked = len(data)
+                    ack_event.set()
+                    return
+
+        rx = asyncio.create_task(reader())
+        if self.t0 is None:
+            self.t0 = time.monotonic()
+        sent = 0
+        try:
+            while off < len(data) and not rx.done():
+                while off - acked >= window and not rx.done():
+                    ack_event.clear()
+                    await asyncio.wait({rx, asyncio.create_task(ack_event.wait())},
+                                       return_when=asyncio.FIRST_COMPLETED)
+                n = min(chunk, len(data) - off, window - (off - acked))
+                if n <= 0 or rx.done():
+                    continue
+                if args.drop_every and sent and sent + n > args.drop_every:
+                    ws.w.transport.abort()
+                    raise ConnectionError('dropped after %d B (--drop-every)' % sent)
+                await ws.send(OP_BIN, struct.pack('<BBHI', FRAME_MAGIC, FRAME_DATA, 0, off) + data[off:off + n])
+                off += n
+                sent += n
+                self.sent += n
+                if not args.quiet:
+                    print('\r%7d / %d B  acked %7d' % (off, len(data), acked), end='', flush=True)
+            await asyncio.wait_for(rx, timeout=args.timeout)
+        finally:
+            rx.cancel()
+        dt = time.monotonic() - self.t0
+        if not args.quiet:
+            print()
+        print('server: %d B image, %d B sent in %d session(s), %.2f s, %.1f KB/s' %
+              (len(self.image), self.sent, self.sessions, dt, len(self.image) / 1024 / dt if dt else 0))
+        print('device: %s' % json.dumps(self.result))
+
+    async def handle(self, reader, writer):
+        peer = writer.get_extra_info('peername')
+        ws = WsConn(reader, writer)
+        try:
+            await ws.handshake()
+            print('device connected from %s:%d' % peer[:2])
+            self.sessions += 1
+            await self.session(ws)
+        except (ConnectionError, asyncio.IncompleteReadError, asyncio.TimeoutError) as e:
+            # the device keeps flashed data; wait for it to reconnect and resume
+            print('\nsession interrupted: %s' % e, file=sys.stderr)
+        except RuntimeError as e:
+            print('\nsession failed: %s' % e, file=sys.stderr)
+            self.done.set()
+        finally:
+            writer.close()
+            if self.result is not None:
+                self.done.set()
+
+
+async def serve(args, image, payload, enc):
+    push = OtaPush(args, image, payload, enc)
+    server = await asyncio.start_server(push.handle, args.host, args.port)
+    print('image %s: %d B, sha256 %s' % (os.path.basename(args.image), len(image), push.sha256))
+    if 'delta' in enc:
+        print('delta from %s: %d B patch' % (os.path.basename(args.base), enc['delta']))
+    if enc:
+        print('sending %d B (%s), %.1fx smaller than the image' %
+              (len(payload), ' + '.join(k for k in ('delta', 'zlib') if k in enc), len(image) / len(payload)))
+    print('waiting for device on ws://%s:%d/' % (args.host, args.port))
+    async with server:
+        await push.done.wait()
+    return 0 if push.result and push.result.get('ok') else 1
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('image', help='application image (build/<project>.bin)')
+    ap.add_argument('--host', default='0.0.0.0')
+    ap.add_argument('--port', type=int, default=8080)
+    ap.add_argument('--chunk', type=int, default=0, help='frame payload size (default: device buffer size)')
+    ap.add_argument('--reboot', action='store_true', help='device restarts into the new image when verified')
+    ap.add_argument('--timeout', type=float, default=60.0, help='seconds to wait for ota_done after the last frame')
+    ap.add_argument('--base', metavar='OLD.bin', help='send a delta patch against the image running on the device')
+    ap.add_argument('--zlib', action='store_true', help='compress the transfer (4 KB window)')
+    ap.add_argument('--assets', type=int, default=0, metavar='VERSION',
+                    help='IMAGE is an asset bundle (gen_web_assets.py --bundle VERSION), install it')
+    ap.add_argument('--drop-every', type=int, default=0, metavar='N',
+                    help='close the connection after every N bytes sent (resume test)')
+    ap.add_argument('-q', '--quiet', action='store_true')
+    args = ap.parse_args()
+
+    with open(args.image, 'rb') as f:
+        image = f.read()
+    payload, enc = image, {}
+    if args.base:
+        with open(args.base, 'rb') as f:
+            payload = bbdelta.diff(f.read(), image)
+        enc['delta'] = len(payload)
+    if args.zlib:
+        c = zlib.compressobj(9, zlib.DEFLATED, ZLIB_WBITS)
+        payload = c.compress(payload) + c.flush()
+        enc['zlib'] = len(payload)
+    return asyncio.run(serve(args, image, payload, enc))
+
+
+if __name__ == '__main__':
+    sys.exit(main())